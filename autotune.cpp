@@ -0,0 +1,251 @@
+/**
+ * GA Parameter Autotuner - Racing budgeted solves on all cores
+ *
+ * Samples GA parameter sets (population, mutation rate, elite ratio, the
+ * adaptive mutation schedule and the crossover operator) and races them with
+ * successive halving: every round runs each surviving configuration on a
+ * fresh batch of seeds, ranks by mean cost over all seeds seen so far and
+ * keeps the best 1/eta. The seed count doubles each round, so the finalists
+ * are compared on the most runs.
+ *
+ * Cost is the wall-clock time to reach the target fitness. A run that misses
+ * the target within the budget costs the full budget plus a penalty for the
+ * remaining gap, so near misses still outrank configurations that stall.
+ *
+ * Solves use the CPU backend (cpu_backend.hpp) on the 16-slot ANSI problem;
+ * each solve gets --solve-threads pool workers (default 1) and
+ * threads / solve-threads solves run side by side.
+ * The winner is written as a parameter file for hexa-color-solver --params.
+ * Its population only trades CPU time against generations, so the file
+ * records it as a comment and the GPU solver keeps its own population
+ * (-p sets one explicitly).
+ *
+ * Build: g++ -std=c++17 -O2 autotune.cpp -o hexa-autotune -lpthread
+ * Run: ./hexa-autotune --configs 32 --budget 2 -o autotune.params
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "cpu_backend.hpp"
+#include "rules.cuh"
+
+struct Candidate {
+    ga::Params params;
+    std::vector<double> costs;   // one per seed run so far
+    int hits;                    // runs that reached the target
+    bool alive;
+
+    double mean_cost() const {
+        double sum = 0.0;
+        for (double c : costs) sum += c;
+        return costs.empty() ? 1e300 : sum / costs.size();
+    }
+};
+
+/**
+ * Random parameter set; population is sampled log-uniformly.
+ */
+static ga::Params sample_params(std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    ga::Params p;
+    p.population = (int)lround(exp(log(500.0) + u(rng) * (log(20000.0) - log(500.0))));
+    p.mutation_rate = 0.05 + u(rng) * 0.35;
+    p.elite_ratio = 0.02 + u(rng) * 0.28;
+    p.stagnation_limit = 20 + (int)(u(rng) * 280);
+    p.mutation_growth = 1.001 + u(rng) * 0.049;
+    p.max_mutation = fmax(p.mutation_rate, 0.2 + u(rng) * 0.6);
+    p.crossover = std::min(ga::CROSSOVER_COUNT - 1, (int)(u(rng) * ga::CROSSOVER_COUNT));
+    return p;
+}
+
+struct Job {
+    int candidate;
+    uint64_t seed;
+    double cost;
+    bool hit;
+};
+
+/**
+ * Run every job as its own solve with solve_threads workers, `parallel`
+ * jobs at a time.
+ */
+static void run_jobs(const cpu::Problem& problem, const std::vector<Candidate>& candidates,
+                     std::vector<Job>& jobs, double budget, double target,
+                     int parallel, int solve_threads) {
+    std::atomic<size_t> next(0);
+    auto worker = [&] {
+        for (size_t j = next++; j < jobs.size(); j = next++) {
+            Job& job = jobs[j];
+            cpu::Options options = {1 << 30, job.seed, solve_threads, target, budget, false, false, 0, 0};
+            cpu::Result r = cpu::solve(problem, candidates[job.candidate].params, options);
+            job.hit = r.time_to_target >= 0.0;
+            job.cost = job.hit ? r.time_to_target
+                               : budget * (1.0 + (target - r.best_fitness) / (fabs(target) + 1.0));
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 0; t < parallel; t++) workers.emplace_back(worker);
+    for (std::thread& w : workers) w.join();
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("\nOptions:\n");
+    printf("  --configs N     Parameter sets to sample (default: 32, the first is the defaults)\n");
+    printf("  --budget S      Wall-clock budget per solve in seconds (default: 2)\n");
+    printf("  --target F      Fitness to reach (default: calibrated from the default parameters)\n");
+    printf("  --eta N         Keep 1/N of the configurations each round (default: 2)\n");
+    printf("  --seeds N       Seeds per configuration in the first round (default: 1)\n");
+    printf("  --threads N     Total threads (default: hardware threads)\n");
+    printf("  --solve-threads N  Pool workers per solve (default: 1); prints the calibration profile\n");
+    printf("  --seed N        Seed of the configuration sampler (default: 1)\n");
+    printf("  -o FILE         Output parameter file (default: autotune.params)\n");
+}
+
+int main(int argc, char** argv) {
+    int n_configs = 32;
+    double budget = 2.0;
+    double target = 0.0;
+    bool target_set = false;
+    int eta = 2;
+    int first_seeds = 1;
+    int solve_threads = 1;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t sampler_seed = 1;
+    const char* output_file = "autotune.params";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--configs") == 0 && i + 1 < argc) {
+            n_configs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            budget = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc) {
+            target = atof(argv[++i]);
+            target_set = true;
+        } else if (strcmp(argv[i], "--eta") == 0 && i + 1 < argc) {
+            eta = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seeds") == 0 && i + 1 < argc) {
+            first_seeds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--solve-threads") == 0 && i + 1 < argc) {
+            solve_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            sampler_seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (n_configs < 1 || budget <= 0.0 || eta < 2 || first_seeds < 1 || threads < 1 || solve_threads < 1) {
+        printf("Error: --configs, --seeds, --threads and --solve-threads must be >= 1, --eta >= 2 and --budget > 0\n");
+        return 1;
+    }
+    int parallel = std::max(1, threads / solve_threads);
+
+    cpu::Problem problem = cpu::ansi_problem();
+    printf("Problem: ANSI 16 slots, %d genes, %d APCA rules\n", problem.layout.genes(), APCA_CONSTRAINT_COUNT);
+
+    // Calibrate the target: what the defaults reach in half the budget,
+    // with the same workers per solve as the racing solves
+    if (!target_set) {
+        cpu::Options options = {1 << 30, 0, solve_threads, 1e300, budget * 0.5, false, false, 0, 0};
+        cpu::Result r = cpu::solve(problem, ga::default_params(2000), options);
+        target = r.best_fitness;
+        printf("Target: %.2f (defaults, population 2000, %.1fs)\n", target, budget * 0.5);
+        if (solve_threads > 1) {
+            printf("Calibration pool profile:\n");
+            cpu::print_profile(r.profile);
+        }
+    } else {
+        printf("Target: %.2f\n", target);
+    }
+
+    std::mt19937_64 rng(sampler_seed);
+    std::vector<Candidate> candidates(n_configs);
+    for (int c = 0; c < n_configs; c++) {
+        candidates[c].params = c == 0 ? ga::default_params(2000) : sample_params(rng);
+        candidates[c].hits = 0;
+        candidates[c].alive = true;
+    }
+
+    int alive = n_configs;
+    int seeds = first_seeds;
+    uint64_t next_seed = 1;
+    for (int round = 1; ; round++) {
+        std::vector<Job> jobs;
+        for (int c = 0; c < n_configs; c++) {
+            if (!candidates[c].alive) continue;
+            for (int s = 0; s < seeds; s++) {
+                jobs.push_back({c, next_seed + s, 0.0, false});
+            }
+        }
+        next_seed += seeds;
+
+        printf("\nRound %d: %d configurations x %d seeds (%zu solves)\n", round, alive, seeds, jobs.size());
+        run_jobs(problem, candidates, jobs, budget, target, parallel, solve_threads);
+        for (const Job& job : jobs) {
+            candidates[job.candidate].costs.push_back(job.cost);
+            if (job.hit) candidates[job.candidate].hits++;
+        }
+
+        std::vector<int> ranked;
+        for (int c = 0; c < n_configs; c++) {
+            if (candidates[c].alive) ranked.push_back(c);
+        }
+        std::stable_sort(ranked.begin(), ranked.end(), [&](int a, int b) {
+            return candidates[a].mean_cost() < candidates[b].mean_cost();
+        });
+
+        int keep = std::max(1, alive / eta);
+        printf("  %-4s %8s %10s %7s %6s %10s %7s %9s %6s %-7s\n",
+               "Cfg", "Cost(s)", "Hits", "Pop", "Mut", "Elite", "Stag", "Growth", "MaxMut", "Xover");
+        for (int k = 0; k < (int)ranked.size(); k++) {
+            const Candidate& cand = candidates[ranked[k]];
+            const ga::Params& p = cand.params;
+            char hits[32];
+            snprintf(hits, sizeof(hits), "%d/%zu", cand.hits, cand.costs.size());
+            printf("  %-4d %8.3f %10s %7d %6.3f %10.3f %7d %9.4f %6.3f %-7s%s\n",
+                   ranked[k], cand.mean_cost(), hits, p.population, p.mutation_rate, p.elite_ratio,
+                   p.stagnation_limit, p.mutation_growth, p.max_mutation,
+                   ga::crossover_names[p.crossover], k < keep ? "" : "  (out)");
+        }
+
+        for (int k = keep; k < (int)ranked.size(); k++) {
+            candidates[ranked[k]].alive = false;
+        }
+        alive = keep;
+        if (alive == 1) break;
+        seeds *= 2;
+    }
+
+    int winner = 0;
+    for (int c = 0; c < n_configs; c++) {
+        if (candidates[c].alive) winner = c;
+    }
+    const Candidate& best = candidates[winner];
+
+    char comment[160];
+    snprintf(comment, sizeof(comment),
+             "hexa-autotune: mean %.3fs to fitness %.2f over %zu seeds (%d hits, budget %.1fs)",
+             best.mean_cost(), target, best.costs.size(), best.hits, budget);
+    if (!ga::save_params(output_file, best.params, comment)) {
+        return 1;
+    }
+    printf("\nWinner: configuration %d, mean cost %.3fs\n", winner, best.mean_cost());
+    printf("Saved to: %s (use with --params %s)\n", output_file, output_file);
+    return 0;
+}
@@ -5,6 +5,8 @@
  * - WCAG 2.1 compliant contrast calculations
  * - APCA (Accessible Perceptual Contrast Algorithm) for WCAG 3.0
  * - Oklab/OKLCH perceptually uniform color space conversions
+ * - Color vision deficiency simulation (Machado et al. 2009)
+ * - Lookup variants over a precomputed full-cube sRGB table
  *
  * All functions work on both CUDA device and host.
  * Uses double precision for accuracy in color space conversions.
@@ -13,6 +15,7 @@
  * - WCAG 2.1: https://www.w3.org/TR/WCAG21/#dfn-relative-luminance
  * - APCA: https://github.com/Myndex/SAPC-APCA
  * - Oklab: https://bottosson.github.io/posts/oklab/
+ * - CVD: https://www.inf.ufrgs.br/~oliveira/pubs_files/CVD_Simulation/CVD_Simulation.html
  */
 
 #ifndef COLOR_CUH
@@ -173,27 +176,11 @@ COLOR_FUNC inline double soft_clamp(double y) {
 }
 
 /**
- * Compute APCA contrast (Lc value) between text and background colors.
- *
- * @param text_r, text_g, text_b: Text/foreground color (0-255)
- * @param bg_r, bg_g, bg_b: Background color (0-255)
- * @return Lc contrast value:
- *         - Positive (0 to ~106): dark text on light background
- *         - Negative (-108 to 0): light text on dark background
- *         - |Lc| >= 75: minimum for body text
- *         - |Lc| >= 90: preferred for body text
- *         - |Lc| < 30: not readable
+ * Compute APCA contrast (Lc value) from precomputed luminances.
+ * Both values must already be passed through soft_clamp(). This lets callers
+ * linearize each color once and reuse it across every pair it appears in.
  */
-COLOR_FUNC inline double contrast(double text_r, double text_g, double text_b,
-                                  double bg_r, double bg_g, double bg_b) {
-    // Compute luminance
-    double txtY = luminance(text_r, text_g, text_b);
-    double bgY = luminance(bg_r, bg_g, bg_b);
-
-    // Apply soft clamps
-    txtY = soft_clamp(txtY);
-    bgY = soft_clamp(bgY);
-
+COLOR_FUNC inline double contrast_y(double txtY, double bgY) {
     // Check for insufficient difference
     double deltaY = bgY - txtY;
     if (fabs(deltaY) < constants::deltaYmin) {
@@ -224,6 +211,108 @@ COLOR_FUNC inline double contrast(double text_r, double text_g, double text_b,
     return output * 100.0;
 }
 
+/**
+ * A color prepared for repeated APCA evaluation: soft-clamped luminance plus
+ * the four exponent powers contrast_y() would otherwise recompute per pair.
+ */
+struct Prepared {
+    double Y;
+    double norm_bg, norm_txt;  // Y^normBG, Y^normTXT
+    double rev_bg, rev_txt;    // Y^revBG, Y^revTXT
+};
+
+/**
+ * Prepare a soft-clamped luminance for contrast_prepared().
+ */
+COLOR_FUNC inline Prepared prepare(double Y) {
+    Prepared p;
+    p.Y = Y;
+    p.norm_bg = pow(Y, constants::normBG);
+    p.norm_txt = pow(Y, constants::normTXT);
+    p.rev_bg = pow(Y, constants::revBG);
+    p.rev_txt = pow(Y, constants::revTXT);
+    return p;
+}
+
+/**
+ * Compute APCA contrast (Lc value) between two prepared colors.
+ * Same result as contrast_y(txt.Y, bg.Y) without any pow() per pair.
+ */
+COLOR_FUNC inline double contrast_prepared(const Prepared& txt, const Prepared& bg) {
+    if (fabs(bg.Y - txt.Y) < constants::deltaYmin) {
+        return 0.0;
+    }
+
+    double output;
+    if (bg.Y > txt.Y) {
+        // Normal polarity: dark text on light background
+        double sapc = (bg.norm_bg - txt.norm_txt) * constants::scaleBoW;
+        output = sapc < constants::loClip ? 0.0 : sapc - constants::loBoWoffset;
+    } else {
+        // Reverse polarity: light text on dark background
+        double sapc = (bg.rev_bg - txt.rev_txt) * constants::scaleWoB;
+        output = sapc > -constants::loClip ? 0.0 : sapc + constants::loWoBoffset;
+    }
+
+    return output * 100.0;
+}
+
+/**
+ * A perturbed display model for robustness checks.
+ * - gamma: channel transfer exponent (APCA assumes 2.4)
+ * - black_lift: additive luminance from flare / raised black level
+ * - white_scale: peak white luminance relative to the ideal display
+ * {2.4, 0, 1} reproduces luminance() exactly.
+ */
+struct DisplayModel {
+    double gamma;
+    double black_lift;
+    double white_scale;
+};
+
+/**
+ * Compute soft-clamped APCA luminance of one sRGB color (0-255) on a batch of
+ * display models. Each channel is log-linearized once and shared by every
+ * model, so each extra model costs one exp() per channel instead of a pow().
+ */
+COLOR_FUNC inline void luminance_batch(double r, double g, double b,
+                                       const DisplayModel* models, int n_models,
+                                       double* Y_out) {
+    double vr = r / 255.0, vg = g / 255.0, vb = b / 255.0;
+    double lr = vr > 0.0 ? log(vr) : 0.0;
+    double lg = vg > 0.0 ? log(vg) : 0.0;
+    double lb = vb > 0.0 ? log(vb) : 0.0;
+
+    for (int m = 0; m < n_models; m++) {
+        double gamma = models[m].gamma;
+        double Y = (vr > 0.0 ? constants::sRco * exp(gamma * lr) : 0.0) +
+                   (vg > 0.0 ? constants::sGco * exp(gamma * lg) : 0.0) +
+                   (vb > 0.0 ? constants::sBco * exp(gamma * lb) : 0.0);
+        Y_out[m] = soft_clamp(Y * models[m].white_scale + models[m].black_lift);
+    }
+}
+
+/**
+ * Compute APCA contrast (Lc value) between text and background colors.
+ *
+ * @param text_r, text_g, text_b: Text/foreground color (0-255)
+ * @param bg_r, bg_g, bg_b: Background color (0-255)
+ * @return Lc contrast value:
+ *         - Positive (0 to ~106): dark text on light background
+ *         - Negative (-108 to 0): light text on dark background
+ *         - |Lc| >= 75: minimum for body text
+ *         - |Lc| >= 90: preferred for body text
+ *         - |Lc| < 30: not readable
+ */
+COLOR_FUNC inline double contrast(double text_r, double text_g, double text_b,
+                                  double bg_r, double bg_g, double bg_b) {
+    // Compute luminance and apply soft clamps
+    double txtY = soft_clamp(luminance(text_r, text_g, text_b));
+    double bgY = soft_clamp(luminance(bg_r, bg_g, bg_b));
+
+    return contrast_y(txtY, bgY);
+}
+
 /**
  * Get the absolute contrast value (polarity-independent).
  * Useful when you just want to know "how much contrast" regardless of mode.
@@ -269,14 +358,9 @@ struct Lab {
 };
 
 /**
- * Convert sRGB (0-255) to Oklab.
+ * Convert linear RGB (0-1) to Oklab.
  */
-COLOR_FUNC inline Lab from_srgb(double r, double g, double b) {
-    // sRGB to linear RGB
-    double lr = wcag2::linearize(r);
-    double lg = wcag2::linearize(g);
-    double lb = wcag2::linearize(b);
-
+COLOR_FUNC inline Lab from_linear_rgb(double lr, double lg, double lb) {
     // Linear RGB to LMS (cone response)
     double l = 0.4122214708 * lr + 0.5363325363 * lg + 0.0514459929 * lb;
     double m = 0.2119034982 * lr + 0.6806995451 * lg + 0.1073969566 * lb;
@@ -296,6 +380,13 @@ COLOR_FUNC inline Lab from_srgb(double r, double g, double b) {
     return result;
 }
 
+/**
+ * Convert sRGB (0-255) to Oklab.
+ */
+COLOR_FUNC inline Lab from_srgb(double r, double g, double b) {
+    return from_linear_rgb(wcag2::linearize(r), wcag2::linearize(g), wcag2::linearize(b));
+}
+
 /**
  * Compute Euclidean distance between two colors in Oklab space.
  * This is a good approximation of perceptual color difference (ΔE).
@@ -522,6 +613,157 @@ COLOR_FUNC inline double lerp_hue(double h1, double h2, double t) {
 
 } // namespace oklch
 
+// =============================================================================
+// Color Vision Deficiency Simulation
+// =============================================================================
+// Reference: Machado, Oliveira & Fernandes (2009), "A Physiologically-based
+// Model for Simulation of Color Vision Deficiency"
+//
+// Each deficiency is a 3x3 matrix applied to linear RGB. Partial severities
+// interpolate between identity and the full (severity 1.0) dichromat matrix,
+// which tracks the published per-severity tables closely.
+
+namespace cvd {
+
+enum Deficiency {
+    PROTAN = 0,  // L-cone (red) deficiency
+    DEUTAN,      // M-cone (green) deficiency
+    TRITAN,      // S-cone (blue) deficiency
+    DEFICIENCY_COUNT
+};
+
+// Row-major 3x3 transform on linear RGB
+struct Matrix {
+    double m[9];
+};
+
+/**
+ * Simulation matrix for a deficiency at a severity in [0, 1].
+ */
+COLOR_FUNC inline Matrix machado_matrix(Deficiency d, double severity) {
+    // Severity 1.0 matrices from Machado et al. (2009)
+    const double full[3][9] = {
+        { 0.152286,  1.052583, -0.204868,
+          0.114503,  0.786281,  0.099216,
+         -0.003882, -0.048116,  1.051998},
+        { 0.367322,  0.860646, -0.227968,
+          0.280085,  0.672501,  0.047413,
+         -0.011820,  0.042940,  0.968881},
+        { 1.255528, -0.076749, -0.178779,
+         -0.078411,  0.930809,  0.147602,
+          0.004733,  0.691367,  0.303900},
+    };
+
+    Matrix result;
+    for (int i = 0; i < 9; i++) {
+        double identity = (i % 4 == 0) ? 1.0 : 0.0;
+        result.m[i] = identity + severity * (full[d][i] - identity);
+    }
+    return result;
+}
+
+/**
+ * Apply a batch of simulation matrices to one linear RGB color.
+ * Writes n_models clamped linear RGB triples to out[3 * model + channel].
+ */
+COLOR_FUNC inline void simulate_linear(double lr, double lg, double lb,
+                                       const Matrix* models, int n_models,
+                                       double* out) {
+    for (int k = 0; k < n_models; k++) {
+        const double* m = models[k].m;
+        for (int row = 0; row < 3; row++) {
+            double v = m[row * 3 + 0] * lr + m[row * 3 + 1] * lg + m[row * 3 + 2] * lb;
+            out[k * 3 + row] = v < 0.0 ? 0.0 : (v > 1.0 ? 1.0 : v);
+        }
+    }
+}
+
+/**
+ * Simulate one sRGB color (0-255) under a single deficiency matrix.
+ */
+COLOR_FUNC inline void simulate_srgb(double r, double g, double b, const Matrix& model,
+                                     double* out_r, double* out_g, double* out_b) {
+    double lin[3];
+    simulate_linear(wcag2::linearize(r), wcag2::linearize(g), wcag2::linearize(b),
+                    &model, 1, lin);
+    *out_r = oklab::linear_to_srgb_channel(lin[0]);
+    *out_g = oklab::linear_to_srgb_channel(lin[1]);
+    *out_b = oklab::linear_to_srgb_channel(lin[2]);
+}
+
+} // namespace cvd
+
+// =============================================================================
+// Full-Cube sRGB Lookup Table
+// =============================================================================
+// Precomputed values for all 2^24 8-bit sRGB colors, generated by lut-gen and
+// memory-mapped on the host (see lut.hpp). Lookups take the table pointer so
+// they work on any copy of the data (mapped file or device buffer).
+//
+// CHUNKED layout stores 16x16x16 blocks contiguously (indexed by the high 4
+// bits of each channel), so nearby colors share cache lines and pages.
+
+namespace lut {
+
+struct Entry {
+    float apca_y;   // apca::luminance() (not soft-clamped)
+    float wcag_y;   // wcag2::luminance()
+    float L, a, b;  // oklab::from_srgb()
+};
+
+enum Layout {
+    LINEAR = 0,   // (r << 16) | (g << 8) | b
+    CHUNKED = 1,  // 16x16x16 blocks
+};
+
+COLOR_FUNC inline unsigned int index(int r, int g, int b, int layout) {
+    if (layout == CHUNKED) {
+        unsigned int block = ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4);
+        unsigned int within = ((r & 15) << 8) | ((g & 15) << 4) | (b & 15);
+        return (block << 12) | within;
+    }
+    return ((unsigned int)r << 16) | ((unsigned int)g << 8) | (unsigned int)b;
+}
+
+/**
+ * Lookup variant of apca::luminance() for integer sRGB.
+ */
+COLOR_FUNC inline double apca_luminance(const Entry* table, int layout, int r, int g, int b) {
+    return table[index(r, g, b, layout)].apca_y;
+}
+
+/**
+ * Lookup variant of wcag2::luminance() for integer sRGB.
+ */
+COLOR_FUNC inline double wcag_luminance(const Entry* table, int layout, int r, int g, int b) {
+    return table[index(r, g, b, layout)].wcag_y;
+}
+
+/**
+ * Lookup variant of oklab::from_srgb() for integer sRGB.
+ */
+COLOR_FUNC inline oklab::Lab oklab(const Entry* table, int layout, int r, int g, int b) {
+    const Entry& e = table[index(r, g, b, layout)];
+    oklab::Lab lab;
+    lab.L = e.L;
+    lab.a = e.a;
+    lab.b = e.b;
+    return lab;
+}
+
+/**
+ * Lookup variant of apca::contrast() for integer sRGB.
+ */
+COLOR_FUNC inline double apca_contrast(const Entry* table, int layout,
+                                       int text_r, int text_g, int text_b,
+                                       int bg_r, int bg_g, int bg_b) {
+    double txtY = apca::soft_clamp(apca_luminance(table, layout, text_r, text_g, text_b));
+    double bgY = apca::soft_clamp(apca_luminance(table, layout, bg_r, bg_g, bg_b));
+    return apca::contrast_y(txtY, bgY);
+}
+
+} // namespace lut
+
 // =============================================================================
 // Convenience Functions (Legacy Interface)
 // =============================================================================
@@ -0,0 +1,83 @@
+/**
+ * Color C ABI - Implementation of color_abi.h (libhexacolor)
+ *
+ * Build: g++ -std=c++17 -O2 -shared -fPIC color_abi.cpp -o libhexacolor.so
+ */
+
+#include "color_abi.h"
+
+#include <cstring>
+
+#include "color.cuh"
+#include "theme_metrics.hpp"
+
+#define HEXA_EXPORT extern "C" __attribute__((visibility("default")))
+
+HEXA_EXPORT int hexa_abi_version(void) {
+    return HEXA_COLOR_ABI_VERSION;
+}
+
+// Backgrounds are prepared BLOCK at a time on the stack, so the matrix calls
+// need no heap scratch however large the inputs are
+static constexpr int BLOCK = 256;
+
+// Soft-clamped APCA luminance of a color, prepared for contrast_prepared()
+static color::apca::Prepared prepare(const uint8_t* c) {
+    return color::apca::prepare(color::apca::soft_clamp(color::apca::luminance(c[0], c[1], c[2])));
+}
+
+HEXA_EXPORT void hexa_apca_matrix(const uint8_t* fg, int n_fg, const uint8_t* bg, int n_bg, double* out) {
+    color::apca::Prepared bg_y[BLOCK];
+    for (int j0 = 0; j0 < n_bg; j0 += BLOCK) {
+        int n = n_bg - j0 < BLOCK ? n_bg - j0 : BLOCK;
+        for (int j = 0; j < n; j++) bg_y[j] = prepare(&bg[(j0 + j) * 3]);
+        for (int i = 0; i < n_fg; i++) {
+            color::apca::Prepared fg_y = prepare(&fg[i * 3]);
+            for (int j = 0; j < n; j++) {
+                out[i * n_bg + j0 + j] = color::apca::contrast_prepared(fg_y, bg_y[j]);
+            }
+        }
+    }
+}
+
+HEXA_EXPORT void hexa_contrast_ratio_matrix(const uint8_t* fg, int n_fg, const uint8_t* bg, int n_bg,
+                                            double* out) {
+    double bg_l[BLOCK];
+    for (int j0 = 0; j0 < n_bg; j0 += BLOCK) {
+        int n = n_bg - j0 < BLOCK ? n_bg - j0 : BLOCK;
+        for (int j = 0; j < n; j++) {
+            const uint8_t* c = &bg[(j0 + j) * 3];
+            bg_l[j] = color::wcag2::luminance(c[0], c[1], c[2]);
+        }
+        for (int i = 0; i < n_fg; i++) {
+            double l1 = color::wcag2::luminance(fg[i * 3], fg[i * 3 + 1], fg[i * 3 + 2]);
+            for (int j = 0; j < n; j++) {
+                double hi = fmax(l1, bg_l[j]), lo = fmin(l1, bg_l[j]);
+                out[i * n_bg + j0 + j] = (hi + 0.05) / (lo + 0.05);
+            }
+        }
+    }
+}
+
+HEXA_EXPORT void hexa_rgb_to_oklch(const uint8_t* rgb, int n, double* out) {
+    for (int i = 0; i < n; i++) {
+        color::oklch::LCH lch = color::oklch::from_srgb(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        out[i * 3 + 0] = lch.L;
+        out[i * 3 + 1] = lch.C;
+        out[i * 3 + 2] = lch.H;
+    }
+}
+
+HEXA_EXPORT void hexa_palette_metrics(const uint8_t* rgb16, hexa_metrics* out) {
+    theme_metrics::Palette p;
+    memcpy(p.rgb, rgb16, sizeof(p.rgb));
+    theme_metrics::Metrics m = theme_metrics::compute(p);
+    out->fitness = m.fitness;
+    out->worst_margin = m.worst_margin;
+    out->min_distance = m.min_distance;
+    out->min_hue_spacing = m.min_hue_spacing;
+    out->worst_rule = m.worst_rule;
+    out->rules_met = m.rules_met;
+    out->rules_total = m.rules_total;
+    out->reserved = 0;
+}
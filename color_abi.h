@@ -0,0 +1,55 @@
+/**
+ * Color C ABI - Batch entry points into color.cuh for other languages
+ *
+ * libhexacolor exports the solver's own color math (color.cuh, fitness.cuh,
+ * rules.cuh) with plain C types, so tools outside C++ (theme-analyzer.py via
+ * ctypes) use exactly the solver's numerics instead of reimplementing them.
+ * Colors are packed 8-bit sRGB triples (r, g, b, r, g, b, ...). Every call
+ * is a batch, so the per-call overhead of a foreign function interface is
+ * paid once per matrix or palette, not once per pair.
+ *
+ * All functions are thread-safe and never allocate.
+ */
+
+#ifndef COLOR_ABI_H
+#define COLOR_ABI_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bumped on any incompatible change; callers check it before use
+#define HEXA_COLOR_ABI_VERSION 1
+
+typedef struct {
+    double fitness;          /* solver fitness with the ANSI rules */
+    double worst_margin;     /* min over APCA rules of (Lc - min_apca), < 0 = violated */
+    double min_distance;     /* min Oklab distance between base colors 1-7 */
+    double min_hue_spacing;  /* min hue distance between red..cyan (degrees) */
+    int32_t worst_rule;      /* index of the worst APCA rule */
+    int32_t rules_met;
+    int32_t rules_total;
+    int32_t reserved;
+} hexa_metrics;
+
+int hexa_abi_version(void);
+
+/* out[i * n_bg + j] = APCA Lc of text fg[i] on background bg[j] */
+void hexa_apca_matrix(const uint8_t* fg, int n_fg, const uint8_t* bg, int n_bg, double* out);
+
+/* out[i * n_bg + j] = WCAG 2.1 contrast ratio of fg[i] and bg[j] */
+void hexa_contrast_ratio_matrix(const uint8_t* fg, int n_fg, const uint8_t* bg, int n_bg, double* out);
+
+/* out[i * 3 .. i * 3 + 2] = OKLCH (L, C, H degrees) of rgb[i] */
+void hexa_rgb_to_oklch(const uint8_t* rgb, int n, double* out);
+
+/* Solver fitness and rule margins of a 16-color ANSI palette (48 bytes) */
+void hexa_palette_metrics(const uint8_t* rgb16, hexa_metrics* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COLOR_ABI_H
@@ -12,6 +12,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <cassert>
+#include <vector>
 
 #include "color.cuh"
 
@@ -204,6 +205,48 @@ void test_apca_polarity() {
            dark_on_light, light_on_dark);
 }
 
+void test_apca_contrast_y() {
+    printf("\n== APCA Contrast from Cached Luminance ==\n");
+
+    // contrast_y() on soft-clamped luminances must match contrast() exactly
+    double fgY = color::apca::soft_clamp(color::apca::luminance(200, 120, 40));
+    double bgY = color::apca::soft_clamp(color::apca::luminance(10, 20, 60));
+    check_double("contrast_y matches contrast (light on dark)",
+                 color::apca::contrast(200, 120, 40, 10, 20, 60),
+                 color::apca::contrast_y(fgY, bgY), 1e-12);
+    check_double("contrast_y matches contrast (dark on light)",
+                 color::apca::contrast(10, 20, 60, 200, 120, 40),
+                 color::apca::contrast_y(bgY, fgY), 1e-12);
+
+    // contrast_prepared() must match contrast_y()
+    color::apca::Prepared fg = color::apca::prepare(fgY);
+    color::apca::Prepared bg = color::apca::prepare(bgY);
+    check_double("contrast_prepared matches contrast_y",
+                 color::apca::contrast_y(fgY, bgY),
+                 color::apca::contrast_prepared(fg, bg), 1e-9);
+}
+
+void test_apca_luminance_batch() {
+    printf("\n== APCA Luminance on Display Models ==\n");
+
+    const color::apca::DisplayModel models[] = {
+        {2.4, 0.0, 1.0},   // ideal display
+        {2.2, 0.0, 1.0},   // lower gamma: midtones brighter
+        {2.4, 0.01, 1.0},  // raised black level
+    };
+    double Y[3];
+    color::apca::luminance_batch(128, 64, 200, models, 3, Y);
+
+    double ideal = color::apca::soft_clamp(color::apca::luminance(128, 64, 200));
+    check_double("ideal model matches luminance()", ideal, Y[0], 1e-12);
+    check_bool("gamma 2.2 is brighter than 2.4", true, Y[1] > Y[0]);
+    check_bool("black lift raises luminance", true, Y[2] > Y[0]);
+
+    double black[3];
+    color::apca::luminance_batch(0, 0, 0, models, 3, black);
+    check_double("black on ideal model", color::apca::soft_clamp(0.0), black[0], 1e-12);
+}
+
 // =============================================================================
 // Oklab Tests
 // =============================================================================
@@ -347,6 +390,73 @@ void test_oklch_hue_similar() {
                color::oklch::hue_similar(255, 0, 0, 0, 255, 0, 30.0));
 }
 
+// =============================================================================
+// Color Vision Deficiency Tests
+// =============================================================================
+// Reference: Machado, Oliveira & Fernandes (2009)
+
+void test_cvd_simulation() {
+    printf("\n== CVD Simulation ==\n");
+
+    // Severity 0 is the identity transform
+    color::cvd::Matrix none = color::cvd::machado_matrix(color::cvd::DEUTAN, 0.0);
+    double r, g, b;
+    color::cvd::simulate_srgb(12, 200, 77, none, &r, &g, &b);
+    check_double("severity 0 keeps R", 12.0, r, 1e-9);
+    check_double("severity 0 keeps G", 200.0, g, 1e-9);
+    check_double("severity 0 keeps B", 77.0, b, 1e-9);
+
+    // Full protanopia: pure red turns a dark olive
+    color::cvd::Matrix protan = color::cvd::machado_matrix(color::cvd::PROTAN, 1.0);
+    color::cvd::simulate_srgb(255, 0, 0, protan, &r, &g, &b);
+    check_bool("protan red looks dark olive (R < 128)", true, r < 128.0);
+    check_double("protan red has no blue", 0.0, b, 1e-9);
+
+    // Red and green collapse toward each other under deutan
+    color::cvd::Matrix deutan = color::cvd::machado_matrix(color::cvd::DEUTAN, 1.0);
+    double rr, rg, rb, gr, gg, gb;
+    color::cvd::simulate_srgb(220, 60, 60, deutan, &rr, &rg, &rb);
+    color::cvd::simulate_srgb(60, 160, 60, deutan, &gr, &gg, &gb);
+    double normal = color::oklab::distance(220, 60, 60, 60, 160, 60);
+    double simulated = color::oklab::distance(rr, rg, rb, gr, gg, gb);
+    check_bool("deutan shrinks red/green distance", true, simulated < normal * 0.5);
+
+    // White is preserved (rows sum to ~1)
+    color::cvd::Matrix tritan = color::cvd::machado_matrix(color::cvd::TRITAN, 1.0);
+    color::cvd::simulate_srgb(255, 255, 255, tritan, &r, &g, &b);
+    check_double("tritan white stays white (G)", 255.0, g, 0.5);
+}
+
+void test_lut_index() {
+    printf("\n== Lookup Table Index ==\n");
+
+    using color::lut::index;
+    check_bool("linear white is last", true, index(255, 255, 255, color::lut::LINEAR) == 0xffffff);
+    check_bool("chunked white is last", true, index(255, 255, 255, color::lut::CHUNKED) == 0xffffff);
+    check_bool("chunked (0,0,15) stays in first block", true, index(0, 0, 15, color::lut::CHUNKED) == 15);
+    check_bool("chunked (0,0,16) starts second block", true, index(0, 0, 16, color::lut::CHUNKED) == 4096);
+
+    // Every color maps to a distinct entry
+    std::vector<unsigned char> seen(1u << 24, 0);
+    bool bijective = true;
+    for (int r = 0; r < 256; r++) {
+        for (int g = 0; g < 256; g++) {
+            for (int b = 0; b < 256; b++) {
+                unsigned int i = index(r, g, b, color::lut::CHUNKED);
+                if (i >= (1u << 24) || seen[i]) bijective = false;
+                else seen[i] = 1;
+            }
+        }
+    }
+    check_bool("chunked index is a bijection", true, bijective);
+
+    // Lookup variants read the right fields
+    color::lut::Entry table[1] = {{0.25f, 0.5f, 0.6f, -0.1f, 0.05f}};
+    check_double("lookup APCA Y", 0.25, color::lut::apca_luminance(table, color::lut::LINEAR, 0, 0, 0), 1e-7);
+    check_double("lookup WCAG Y", 0.5, color::lut::wcag_luminance(table, color::lut::LINEAR, 0, 0, 0), 1e-7);
+    check_double("lookup Oklab a", -0.1, color::lut::oklab(table, color::lut::LINEAR, 0, 0, 0).a, 1e-7);
+}
+
 // =============================================================================
 // Legacy Interface Tests
 // =============================================================================
@@ -445,6 +555,8 @@ int main() {
     test_apca_linearize();
     test_apca_contrast();
     test_apca_polarity();
+    test_apca_contrast_y();
+    test_apca_luminance_batch();
 
     // Oklab tests
     test_oklab_conversion();
@@ -455,6 +567,12 @@ int main() {
     test_oklch_hue_distance();
     test_oklch_hue_similar();
 
+    // CVD tests
+    test_cvd_simulation();
+
+    // Lookup table
+    test_lut_index();
+
     // Legacy interface
     test_legacy_interface();
 
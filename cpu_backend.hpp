@@ -0,0 +1,760 @@
+/**
+ * CPU Backend - Host implementation of the GA generation loop
+ *
+ * Runs the same operators (ga.cuh), genome layout (genome.cuh) and scoring
+ * (fitness.cuh) as the CUDA kernels on host threads. Each individual owns a
+ * small counter-based RNG stream, so results depend only on the seed, never
+ * on the thread count or scheduling.
+ *
+ * Evaluation and breeding run on a work-stealing pool (Pool), since the
+ * per-palette cost varies. With Options::slot_cache, identical slot triples
+ * across the population are converted once (slot_cache.hpp); generations
+ * that share too little bypass the cache for a while, since a lookup costs
+ * more than a conversion when almost every triple is new.
+ * Options::pipeline_chunks replaces the per-generation barriers with a
+ * chunked pipeline (solve_pipelined). Used by hexa-autotune to race
+ * parameter sets on all cores, with solves side by side and
+ * --solve-threads workers each.
+ */
+
+#ifndef CPU_BACKEND_HPP
+#define CPU_BACKEND_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "fitness.cuh"
+#include "genome.cuh"
+#include "ga.cuh"
+#include "rules.cuh"
+#include "slot_cache.hpp"
+
+namespace cpu {
+
+/**
+ * splitmix64 stream: 8 bytes of state per individual.
+ * uniform() is in (0, 1] like curand_uniform.
+ */
+struct HostRng {
+    uint64_t state;
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+    double uniform() { return ((next() >> 11) + 1) * (1.0 / 9007199254740992.0); }
+    double normal() {
+        // Box-Muller, one draw per call
+        double u1 = uniform();
+        double u2 = uniform();
+        return sqrt(-2.0 * log(u1)) * cos(2.0 * color::PI * u2);
+    }
+};
+
+inline HostRng stream(uint64_t seed, uint64_t index) {
+    HostRng rng = {seed * 0x632be59bd9b4e019ull + index};
+    rng.next();
+    return rng;
+}
+
+// =============================================================================
+// Work-stealing pool
+// =============================================================================
+
+/**
+ * Persistent threads running parallel_for(n, fn) with work stealing.
+ *
+ * [0, n) starts as one contiguous range per worker. A worker takes chunks
+ * from the front of its own range; once empty it steals the back half of
+ * another worker's range, which becomes its own. Chunks are a quarter of
+ * the remaining range, never below a grain sized from the measured per-item
+ * cost (about GRAIN_SECONDS of work), so cheap loops are not dominated by
+ * locking and expensive or uneven ones still balance at the tail.
+ *
+ * The calling thread is worker 0. Per worker the pool accumulates busy time
+ * (inside fn) and idle time (rest of the parallel_for, i.e. stealing and
+ * waiting for the slowest worker); tail is the time from the first worker
+ * running out of work to the end of the loop.
+ */
+class Pool {
+public:
+    static constexpr double GRAIN_SECONDS = 20e-6;
+
+    struct WorkerStats {
+        double busy, idle;
+        uint64_t items, chunks, steals;
+    };
+    struct Profile {
+        std::vector<WorkerStats> workers;
+        double tail;    // summed over loops
+        int loops;
+    };
+
+    explicit Pool(int threads) : ranges_(std::max(1, threads)) {
+        profile_.workers.assign(ranges_.size(), WorkerStats{});
+        profile_.tail = 0.0;
+        profile_.loops = 0;
+        for (int w = 1; w < (int)ranges_.size(); w++) {
+            threads_.emplace_back([this, w] { worker_main(w); });
+        }
+    }
+
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (std::thread& t : threads_) t.join();
+    }
+
+    int size() const { return (int)ranges_.size(); }
+    const Profile& profile() const { return profile_; }
+
+    template <typename Fn>
+    void parallel_for(int n, Fn fn) {
+        if (n <= 0) return;
+        body_ = [](void* ctx, int begin, int end) {
+            Fn& f = *(Fn*)ctx;
+            for (int i = begin; i < end; i++) f(i);
+        };
+        body_ctx_ = &fn;
+        run(n);
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct alignas(64) Range {
+        std::mutex lock;
+        int begin = 0, end = 0;
+        double busy = 0.0;       // this loop
+        clock::time_point done;  // when this worker ran out of work
+    };
+
+    static double seconds(clock::time_point a, clock::time_point b) {
+        return std::chrono::duration<double>(b - a).count();
+    }
+
+    void run(int n) {
+        int workers = size();
+        int per = n / workers, extra = n % workers, at = 0;
+        for (int w = 0; w < workers; w++) {
+            Range& r = ranges_[w];
+            r.begin = at;
+            at += per + (w < extra ? 1 : 0);
+            r.end = at;
+            r.busy = 0.0;
+        }
+
+        // Grain from the running per-item cost, at least one item
+        double item_cost = cost_items_ > 0 ? cost_seconds_ / cost_items_ : 0.0;
+        grain_ = item_cost > 0.0 ? std::max(1, (int)(GRAIN_SECONDS / item_cost)) : 1;
+
+        auto start = clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_ = workers - 1;
+            epoch_++;
+        }
+        start_cv_.notify_all();
+        work(0);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_cv_.wait(lock, [this] { return pending_ == 0; });
+        }
+        auto end = clock::now();
+
+        double wall = seconds(start, end);
+        clock::time_point first_done = end;
+        for (int w = 0; w < workers; w++) {
+            WorkerStats& st = profile_.workers[w];
+            st.busy += ranges_[w].busy;
+            st.idle += std::max(0.0, wall - ranges_[w].busy);
+            cost_seconds_ += ranges_[w].busy;
+            first_done = std::min(first_done, ranges_[w].done);
+        }
+        cost_items_ += n;
+        profile_.tail += seconds(first_done, end);
+        profile_.loops++;
+    }
+
+    void worker_main(int w) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [&] { return stop_ || epoch_ != seen; });
+                if (stop_) return;
+                seen = epoch_;
+            }
+            work(w);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_--;
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+    // Next chunk from the front of worker w's own range
+    bool take(int w, int* begin, int* end) {
+        Range& r = ranges_[w];
+        std::lock_guard<std::mutex> lock(r.lock);
+        int remaining = r.end - r.begin;
+        if (remaining <= 0) return false;
+        int chunk = std::min(remaining, std::max(grain_, remaining / 4));
+        *begin = r.begin;
+        *end = r.begin + chunk;
+        r.begin += chunk;
+        return true;
+    }
+
+    // Move the back half of some other worker's range into worker w's range
+    bool steal(int w) {
+        int workers = size();
+        for (int k = 1; k < workers; k++) {
+            Range& victim = ranges_[(w + k) % workers];
+            int begin, end;
+            {
+                std::lock_guard<std::mutex> lock(victim.lock);
+                int remaining = victim.end - victim.begin;
+                if (remaining <= 0) continue;
+                begin = victim.end - (remaining + 1) / 2;
+                end = victim.end;
+                victim.end = begin;
+            }
+            Range& own = ranges_[w];
+            std::lock_guard<std::mutex> lock(own.lock);
+            own.begin = begin;
+            own.end = end;
+            profile_.workers[w].steals++;
+            return true;
+        }
+        return false;
+    }
+
+    void work(int w) {
+        Range& r = ranges_[w];
+        WorkerStats& st = profile_.workers[w];
+        int begin, end;
+        for (;;) {
+            if (!take(w, &begin, &end)) {
+                if (!steal(w)) break;
+                continue;
+            }
+            auto t0 = clock::now();
+            body_(body_ctx_, begin, end);
+            r.busy += seconds(t0, clock::now());
+            st.items += end - begin;
+            st.chunks++;
+        }
+        r.done = clock::now();
+    }
+
+    std::vector<Range> ranges_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_, done_cv_;
+    uint64_t epoch_ = 0;
+    int pending_ = 0;
+    bool stop_ = false;
+
+    void (*body_)(void*, int, int) = nullptr;
+    void* body_ctx_ = nullptr;
+    int grain_ = 1;
+    double cost_seconds_ = 0.0;
+    uint64_t cost_items_ = 0;
+    Profile profile_;
+};
+
+/**
+ * Print per-worker busy/idle time of a pool profile.
+ */
+inline void print_profile(const Pool::Profile& p) {
+    printf("  %-7s %9s %9s %6s %10s %8s %7s\n", "Worker", "Busy(s)", "Idle(s)", "Busy%", "Items", "Chunks", "Steals");
+    for (size_t w = 0; w < p.workers.size(); w++) {
+        const Pool::WorkerStats& st = p.workers[w];
+        double total = st.busy + st.idle;
+        printf("  %-7zu %9.3f %9.3f %5.1f%% %10llu %8llu %7llu\n", w, st.busy, st.idle,
+               total > 0.0 ? 100.0 * st.busy / total : 0.0, (unsigned long long)st.items,
+               (unsigned long long)st.chunks, (unsigned long long)st.steals);
+    }
+    if (p.loops > 0) {
+        printf("  Tail: %.1f us per loop (first worker out of work to loop end, %d loops)\n",
+               1e6 * p.tail / p.loops, p.loops);
+    }
+}
+
+// =============================================================================
+// GA driver
+// =============================================================================
+
+// Slot cache policy: a generation sharing less than SLOT_CACHE_MIN_SHARED of
+// its triples bypasses the cache for SLOT_CACHE_BYPASS generations
+constexpr double SLOT_CACHE_MIN_SHARED = 0.15;
+constexpr int SLOT_CACHE_BYPASS = 64;
+
+struct Problem {
+    const OklchSlotConstraint* slots;  // constraint of every slot
+    int n_slots;
+    genome::Layout layout;
+    // Score of a decoded palette; called concurrently from worker threads
+    std::function<double(const fitness::SlotColor*)> score;
+};
+
+/**
+ * The default ANSI problem: the 16-slot constraint table scored with the
+ * APCA pair rules (what the solver runs without --xterm/--dual/--semantic).
+ */
+inline Problem ansi_problem() {
+    Problem problem;
+    problem.slots = oklch_slot_constraints;
+    problem.n_slots = 16;
+    problem.layout = genome::build_layout(oklch_slot_constraints, 16);
+    problem.score = [](const fitness::SlotColor* s) {
+        return fitness::palette_score(s, oklch_slot_constraints, apca_pair_constraints, APCA_CONSTRAINT_COUNT);
+    };
+    return problem;
+}
+
+struct Options {
+    int generations;
+    uint64_t seed;
+    int threads;             // pool workers for evaluation/breeding (1 = serial)
+    double target_fitness;   // stop once the best reaches this (use 1e300 to disable)
+    double time_budget;      // seconds, 0 = unlimited
+    bool verbose;            // print progress every 500 generations
+    bool slot_cache;         // share slot conversions across the population (same results)
+    int pipeline_chunks;     // 0 = generation barriers; N = pipelined over N chunks (solve_pipelined)
+    int pipeline_lag;        // chunks of g a chunk of g + 1 waits for past its own index (0 = chunks / 2)
+};
+
+struct Result {
+    std::vector<double> best_genome;
+    double best_fitness;
+    int best_generation;
+    int generations_run;
+    double seconds;
+    double time_to_target;   // seconds until target_fitness was reached, -1 if never
+    Pool::Profile profile;   // per-worker busy/idle time of the pool
+    slot_cache::Stats slot_cache;  // lookups and conversions (zero without Options::slot_cache)
+};
+
+inline Result solve_pipelined(const Problem& problem, const ga::Params& params, const Options& options);
+
+/**
+ * Run the GA on the host. Same selection, elitism and adaptive mutation as
+ * the GPU driver (evolve() in hexa-color-solver.cu).
+ */
+inline Result solve(const Problem& problem, const ga::Params& params, const Options& options) {
+    if (options.pipeline_chunks > 0 && params.population > ga::elite_count(params)) {
+        return solve_pipelined(problem, params, options);
+    }
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    auto elapsed = [&] { return std::chrono::duration<double>(clock::now() - start).count(); };
+
+    const genome::Layout& layout = problem.layout;
+    int n = params.population;
+    int elite_count = ga::elite_count(params);
+    int stride = layout.genes() * 3;
+
+    std::vector<double> pop1((size_t)n * stride), pop2((size_t)n * stride);
+    std::vector<double> fitness(n);
+    std::vector<int> indices(n), elite(elite_count);
+    std::vector<HostRng> rngs(n);
+    Pool pool(options.threads);
+    std::unique_ptr<slot_cache::Table> cache;
+    size_t lookups = (size_t)n * layout.genes();
+    if (options.slot_cache && lookups <= slot_cache::Table::MAX_ENTRIES) {
+        cache.reset(new slot_cache::Table(lookups));
+    }
+    int bypass = 1;  // generations left that decode directly (the random first one shares nothing)
+    for (int i = 0; i < n; i++) {
+        rngs[i] = stream(options.seed, i);
+    }
+
+    pool.parallel_for(n, [&](int i) {
+        for (int g = 0; g < layout.genes(); g++) {
+            ga::random_gene(problem.slots[layout.gene_slots[g]], rngs[i], &pop1[(size_t)i * stride + g * 3]);
+        }
+    });
+
+    Result result;
+    result.best_fitness = -1e300;
+    result.best_genome.assign(stride, 0.0);
+    result.best_generation = 0;
+    result.generations_run = 0;
+    result.time_to_target = -1.0;
+
+    int stagnant_generations = 0;
+    double current_mutation = params.mutation_rate;
+
+    for (int gen = 0; gen < options.generations; gen++) {
+        pool.parallel_for(n, [&](int i) {
+            thread_local std::vector<fitness::SlotColor> slots;
+            slots.resize(problem.n_slots);
+            const double* genes = &pop1[(size_t)i * stride];
+            if (cache && bypass == 0) {
+                for (const genome::FixedSlot& f : layout.fixed) slots[f.slot] = f.color;
+                for (int g = 0; g < layout.genes(); g++) slots[layout.gene_slots[g]] = cache->lookup(&genes[g * 3]);
+            } else {
+                genome::decode(layout, genes, slots.data());
+            }
+            fitness[i] = problem.score(slots.data());
+        });
+        if (cache && bypass > 0) {
+            bypass--;
+            cache->next_generation(0);
+        } else if (cache) {
+            uint64_t conversions = cache->next_generation(lookups);
+            if (conversions > (1.0 - SLOT_CACHE_MIN_SHARED) * lookups) {
+                bypass = SLOT_CACHE_BYPASS;
+            }
+        }
+
+        std::iota(indices.begin(), indices.end(), 0);
+        // Ties broken by index, like solve_pipelined's prefix merge
+        std::partial_sort(indices.begin(), indices.begin() + elite_count, indices.end(),
+            [&](int a, int b) { return fitness[a] > fitness[b] || (fitness[a] == fitness[b] && a < b); });
+        std::copy(indices.begin(), indices.begin() + elite_count, elite.begin());
+
+        double gen_best = fitness[elite[0]];
+        if (gen_best > result.best_fitness) {
+            result.best_fitness = gen_best;
+            result.best_generation = gen;
+            std::copy(&pop1[(size_t)elite[0] * stride], &pop1[(size_t)elite[0] * stride] + stride,
+                      result.best_genome.begin());
+            stagnant_generations = 0;
+        } else {
+            stagnant_generations++;
+        }
+        current_mutation = ga::next_mutation(params, current_mutation, stagnant_generations);
+
+        if (options.verbose && (gen % 500 == 0 || gen == options.generations - 1)) {
+            printf("Gen %5d: best=%.2f, avg=%.2f, mutation=%.3f\n", gen, gen_best,
+                   std::accumulate(fitness.begin(), fitness.end(), 0.0) / n, current_mutation);
+        }
+
+        result.generations_run = gen + 1;
+        if (result.best_fitness >= options.target_fitness) {
+            result.time_to_target = elapsed();
+            break;
+        }
+        if (gen == options.generations - 1 ||
+            (options.time_budget > 0.0 && elapsed() >= options.time_budget)) {
+            break;
+        }
+
+        pool.parallel_for(n, [&](int i) {
+            double* child = &pop2[(size_t)i * stride];
+            if (i < elite_count) {
+                std::copy(&pop1[(size_t)elite[i] * stride], &pop1[(size_t)elite[i] * stride] + stride, child);
+                return;
+            }
+            int p1 = elite[ga::pick(elite_count, rngs[i])];
+            int p2 = elite[ga::pick(elite_count, rngs[i])];
+            ga::breed(&pop1[(size_t)p1 * stride], &pop1[(size_t)p2 * stride], child,
+                      layout.gene_slots.data(), layout.genes(), problem.slots,
+                      params.crossover, current_mutation, 1.0, rngs[i]);
+        });
+        std::swap(pop1, pop2);
+    }
+
+    result.seconds = elapsed();
+    result.profile = pool.profile();
+    if (cache) {
+        result.slot_cache = cache->stats();
+    }
+    if (options.verbose && pool.size() > 1) {
+        print_profile(result.profile);
+    }
+    if (options.verbose && cache && result.slot_cache.lookups > 0) {
+        printf("  Slot cache: %llu conversions for %llu slot lookups (%.1f%% shared)\n",
+               (unsigned long long)result.slot_cache.conversions, (unsigned long long)result.slot_cache.lookups,
+               100.0 * (1.0 - (double)result.slot_cache.conversions / result.slot_cache.lookups));
+    }
+    return result;
+}
+
+/**
+ * Pipelined generations: no barrier between evaluate, select and breed.
+ *
+ * Generation g holds its elites' copies (E[g-1], fitness known) in
+ * [0, elite_count) and bred children in [elite_count, n), split into
+ * pipeline_chunks chunks. One task breeds and evaluates one chunk. The
+ * elite set is built incrementally: prefix P[g][j] is the top elite_count
+ * of the elite copies and chunks 0..j, merged in chunk order as chunks
+ * finish. Chunk j of generation g + 1 breeds from P[g][j + chunks / 2]
+ * (clamped to the last chunk), so it starts once generation g is scored up
+ * to half a generation past it instead of after the whole generation, and
+ * the tail of g overlaps the head of g + 1. Those chunks pick parents from
+ * an approximate cutoff; the last prefix is the exact elite set E[g], which
+ * is corrected into the elite copies of g + 1, the best genome and the
+ * adaptive mutation. Breeding uses the mutation rate of generation g - 1,
+ * the newest one complete whenever a chunk of g + 1 can start.
+ *
+ * Parents from only chunks 0..j lag too far behind (uniform crossover then
+ * needs ~50% more generations to the target); at half a generation (the
+ * default Options::pipeline_lag) the final fitness matches the barrier loop
+ * and generations to target stay within the seed-to-seed spread
+ * (hexa-crossover-bench --pipeline). With the full lag (chunks - 1) every
+ * chunk breeds from E[g] with the rate of g, which reproduces the barrier
+ * loop bit for bit (parity_test pipeline_lag), without the overlap.
+ *
+ * Two generations are in flight at a time (three population buffers).
+ * Prefixes are merged in chunk order with index tie-breaks, so results
+ * depend only on the seed and chunk count, never on the thread count or
+ * scheduling. The slot cache is not used here (its epochs assume one
+ * generation at a time). The random first generation is scored on the pool.
+ */
+inline Result solve_pipelined(const Problem& problem, const ga::Params& params, const Options& options) {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    auto elapsed = [&] { return std::chrono::duration<double>(clock::now() - start).count(); };
+
+    const genome::Layout& layout = problem.layout;
+    int n = params.population;
+    int elite_count = ga::elite_count(params);
+    int stride = layout.genes() * 3;
+    int chunks = std::min(options.pipeline_chunks, n - elite_count);
+    int chunk_size = (n - elite_count + chunks - 1) / chunks;
+    chunks = (n - elite_count + chunk_size - 1) / chunk_size;
+    // Prefix of the previous generation chunk j breeds from
+    int lag = options.pipeline_lag > 0 ? options.pipeline_lag : chunks / 2;
+    auto parent_prefix = [&](int j) { return std::min(chunks - 1, j + lag); };
+    // With the full lag no chunk starts before the previous generation is complete
+    bool exact = parent_prefix(0) == chunks - 1;
+
+    struct Generation {
+        int gen = -1;
+        std::vector<double> genomes;
+        std::vector<double> fitness;
+        double mutation = 0.0;           // rate its children are bred with
+        int next_chunk = 0;              // next chunk to hand out
+        std::vector<char> done;          // chunk bred and scored
+        int merged = -1;                 // chunks in prefix (-1: elite copies not written yet)
+        std::vector<int> prefix;         // running elite set, best first
+        std::vector<std::vector<int>> parents;  // parents[j] = P[gen][j]
+    };
+    Generation buffers[3];
+    for (Generation& b : buffers) {
+        b.genomes.resize((size_t)n * stride);
+        b.fitness.resize(n);
+        b.done.resize(chunks);
+        b.parents.resize(chunks);
+    }
+    auto buffer = [&](int gen) -> Generation& { return buffers[gen % 3]; };
+    auto setup = [&](int gen, double mutation) {
+        Generation& b = buffer(gen);
+        b.gen = gen;
+        b.mutation = mutation;
+        b.next_chunk = 0;
+        std::fill(b.done.begin(), b.done.end(), 0);
+        b.merged = -1;
+    };
+    auto better = [](const std::vector<double>& fitness) {
+        return [&fitness](int a, int b) { return fitness[a] > fitness[b] || (fitness[a] == fitness[b] && a < b); };
+    };
+    auto score = [&](const double* genes) {
+        thread_local std::vector<fitness::SlotColor> slots;
+        slots.resize(problem.n_slots);
+        genome::decode(layout, genes, slots.data());
+        return problem.score(slots.data());
+    };
+
+    std::vector<HostRng> rngs(n);
+    for (int i = 0; i < n; i++) {
+        rngs[i] = stream(options.seed, i);
+    }
+
+    Result result;
+    result.best_fitness = -1e300;
+    result.best_genome.assign(stride, 0.0);
+    result.best_generation = 0;
+    result.generations_run = 0;
+    result.time_to_target = -1.0;
+
+    int stagnant_generations = 0;
+    double current_mutation = params.mutation_rate;
+    bool stop = false;
+
+    // Merge finished chunks of gen into its prefix, in chunk order; the last
+    // one completes the generation. Called with the lock held.
+    std::function<void(int)> advance;
+    auto complete = [&](int gen) {
+        Generation& b = buffer(gen);
+        const std::vector<int>& elite = b.prefix;
+        double gen_best = b.fitness[elite[0]];
+        if (gen_best > result.best_fitness) {
+            result.best_fitness = gen_best;
+            result.best_generation = gen;
+            std::copy(&b.genomes[(size_t)elite[0] * stride], &b.genomes[(size_t)elite[0] * stride] + stride,
+                      result.best_genome.begin());
+            stagnant_generations = 0;
+        } else {
+            stagnant_generations++;
+        }
+        current_mutation = ga::next_mutation(params, current_mutation, stagnant_generations);
+
+        if (options.verbose && (gen % 500 == 0 || gen == options.generations - 1)) {
+            printf("Gen %5d: best=%.2f, avg=%.2f, mutation=%.3f\n", gen, gen_best,
+                   std::accumulate(b.fitness.begin(), b.fitness.end(), 0.0) / n, current_mutation);
+        }
+
+        result.generations_run = gen + 1;
+        if (result.best_fitness >= options.target_fitness) {
+            result.time_to_target = elapsed();
+            stop = true;
+        }
+        if (gen == options.generations - 1 || (options.time_budget > 0.0 && elapsed() >= options.time_budget)) {
+            stop = true;
+        }
+        if (stop) return;
+
+        // Correction: the exact elites become the elite copies of gen + 1
+        Generation& next = buffer(gen + 1);
+        for (int e = 0; e < elite_count; e++) {
+            std::copy(&b.genomes[(size_t)elite[e] * stride], &b.genomes[(size_t)elite[e] * stride] + stride,
+                      &next.genomes[(size_t)e * stride]);
+            next.fitness[e] = b.fitness[elite[e]];
+        }
+        next.prefix.resize(elite_count);
+        std::iota(next.prefix.begin(), next.prefix.end(), 0);
+        next.merged = 0;
+        if (exact) next.mutation = current_mutation;
+        // gen - 1 is complete and gen's children are all bred: its buffer is free
+        if (gen + 2 < options.generations) {
+            setup(gen + 2, current_mutation);
+        }
+        advance(gen + 1);
+    };
+    advance = [&](int gen) {
+        Generation& b = buffer(gen);
+        if (b.gen != gen || b.merged < 0) return;
+        std::vector<int> candidates;
+        while (b.merged < chunks && b.done[b.merged]) {
+            int begin = elite_count + b.merged * chunk_size;
+            int end = std::min(n, begin + chunk_size);
+            candidates.assign(b.prefix.begin(), b.prefix.end());
+            for (int i = begin; i < end; i++) candidates.push_back(i);
+            std::partial_sort(candidates.begin(), candidates.begin() + elite_count, candidates.end(),
+                              better(b.fitness));
+            b.prefix.assign(candidates.begin(), candidates.begin() + elite_count);
+            b.parents[b.merged] = b.prefix;
+            b.merged++;
+        }
+        if (b.merged == chunks) complete(gen);
+    };
+
+    // Generation 0: random, scored on the pool
+    {
+        Pool pool(options.threads);
+        setup(0, params.mutation_rate);
+        Generation& b = buffer(0);
+        pool.parallel_for(n, [&](int i) {
+            for (int g = 0; g < layout.genes(); g++) {
+                ga::random_gene(problem.slots[layout.gene_slots[g]], rngs[i], &b.genomes[(size_t)i * stride + g * 3]);
+            }
+            b.fitness[i] = score(&b.genomes[(size_t)i * stride]);
+        });
+        b.next_chunk = chunks;
+        std::fill(b.done.begin(), b.done.end(), 1);
+        b.prefix.resize(elite_count);
+        std::iota(b.prefix.begin(), b.prefix.end(), 0);
+        std::sort(b.prefix.begin(), b.prefix.end(), better(b.fitness));
+        b.merged = 0;
+        if (options.generations > 1) {
+            setup(1, params.mutation_rate);
+        }
+        advance(0);
+    }
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    int workers = std::max(1, options.threads);
+    result.profile.workers.assign(workers, Pool::WorkerStats{});
+    result.profile.tail = 0.0;
+    result.profile.loops = 0;
+
+    auto worker = [&](int w) {
+        Pool::WorkerStats& st = result.profile.workers[w];
+        auto t_start = clock::now();
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            if (stop) break;
+            // Oldest generation first; a chunk is ready once its parents are
+            int gen = -1;
+            for (int g = result.generations_run; g <= result.generations_run + 1; g++) {
+                Generation& b = buffer(g);
+                if (g < options.generations && b.gen == g && b.next_chunk < chunks &&
+                    buffer(g - 1).merged > parent_prefix(b.next_chunk)) {
+                    gen = g;
+                    break;
+                }
+            }
+            if (gen < 0) {
+                ready.wait(lock);
+                continue;
+            }
+            Generation& b = buffer(gen);
+            const Generation& prev = buffer(gen - 1);
+            int j = b.next_chunk++;
+            const std::vector<int>& parents = prev.parents[parent_prefix(j)];
+            double mutation = b.mutation;
+            lock.unlock();
+
+            auto t0 = clock::now();
+            int begin = elite_count + j * chunk_size;
+            int end = std::min(n, begin + chunk_size);
+            for (int i = begin; i < end; i++) {
+                double* child = &b.genomes[(size_t)i * stride];
+                int p1 = parents[ga::pick(elite_count, rngs[i])];
+                int p2 = parents[ga::pick(elite_count, rngs[i])];
+                ga::breed(&prev.genomes[(size_t)p1 * stride], &prev.genomes[(size_t)p2 * stride], child,
+                          layout.gene_slots.data(), layout.genes(), problem.slots,
+                          params.crossover, mutation, 1.0, rngs[i]);
+                b.fitness[i] = score(child);
+            }
+            st.busy += std::chrono::duration<double>(clock::now() - t0).count();
+            st.items += end - begin;
+            st.chunks++;
+
+            lock.lock();
+            b.done[j] = 1;
+            advance(gen);
+            ready.notify_all();
+        }
+        ready.notify_all();
+        st.idle = std::max(0.0, std::chrono::duration<double>(clock::now() - t_start).count() - st.busy);
+    };
+
+    if (!stop) {
+        std::vector<std::thread> threads;
+        for (int w = 1; w < workers; w++) threads.emplace_back(worker, w);
+        worker(0);
+        for (std::thread& t : threads) t.join();
+    }
+
+    result.seconds = elapsed();
+    if (options.verbose && workers > 1) {
+        print_profile(result.profile);
+    }
+    return result;
+}
+
+} // namespace cpu
+
+#endif // CPU_BACKEND_HPP
@@ -0,0 +1,173 @@
+/**
+ * Crossover Benchmark - Generations to target per crossover operator
+ *
+ * Runs the CPU backend (cpu_backend.hpp) on the 16-slot ANSI problem with
+ * every crossover operator of ga.cuh on the same seeds and reports how many
+ * generations each needs to reach a target fitness. Fewer generations is a
+ * speedup on any backend, since a generation costs the same whatever the
+ * operator.
+ *
+ * The target defaults to the median best fitness the default operator
+ * (blend) reaches in half the generation budget. A run that misses the
+ * target counts as the full budget in the mean.
+ *
+ * With --pipeline N every operator also runs with pipelined generations
+ * (N chunks, cpu::solve_pipelined) on the same seeds, one row each, to
+ * check that the approximate elite cutoff costs no convergence.
+ *
+ * Build: g++ -std=c++17 -O2 crossover-bench.cpp -o hexa-crossover-bench -lpthread
+ * Run: ./hexa-crossover-bench --seeds 16 --generations 2000
+ *      ./hexa-crossover-bench --seeds 16 --pipeline 16
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "cpu_backend.hpp"
+
+struct Run {
+    int crossover;
+    int pipeline_chunks;  // 0 = generation barriers
+    uint64_t seed;
+    cpu::Result result;
+};
+
+/**
+ * Solve every run single-threaded, `threads` runs at a time.
+ */
+static void run_all(const cpu::Problem& problem, int population, int generations, double target,
+                    std::vector<Run>& runs, int threads) {
+    std::atomic<size_t> next(0);
+    auto worker = [&] {
+        for (size_t j = next++; j < runs.size(); j = next++) {
+            Run& run = runs[j];
+            ga::Params params = ga::default_params(population);
+            params.crossover = run.crossover;
+            // The slot cache only saves time; generation counts are unchanged
+            cpu::Options options = {generations, run.seed, 1, target, 0.0, false, true, run.pipeline_chunks, 0};
+            run.result = cpu::solve(problem, params, options);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) workers.emplace_back(worker);
+    for (std::thread& w : workers) w.join();
+}
+
+static double median(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("\nOptions:\n");
+    printf("  --population N   Population size (default: 2000)\n");
+    printf("  --generations N  Generation budget per run (default: 2000)\n");
+    printf("  --seeds N        Runs per operator (default: 8)\n");
+    printf("  --target F       Fitness to reach (default: calibrated with blend)\n");
+    printf("  --threads N      Runs side by side (default: hardware threads)\n");
+    printf("  --pipeline N     Also run every operator with pipelined generations over N chunks\n");
+}
+
+int main(int argc, char** argv) {
+    int population = 2000;
+    int generations = 2000;
+    int seeds = 8;
+    double target = 0.0;
+    bool target_set = false;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int pipeline_chunks = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--population") == 0 && i + 1 < argc) {
+            population = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--generations") == 0 && i + 1 < argc) {
+            generations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seeds") == 0 && i + 1 < argc) {
+            seeds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc) {
+            target = atof(argv[++i]);
+            target_set = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--pipeline") == 0 && i + 1 < argc) {
+            pipeline_chunks = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (population < 10 || generations < 2 || seeds < 1 || threads < 1 || pipeline_chunks < 0) {
+        printf("Error: --population must be >= 10, --generations >= 2, --seeds and --threads >= 1, --pipeline >= 0\n");
+        return 1;
+    }
+
+    cpu::Problem problem = cpu::ansi_problem();
+    printf("Problem: ANSI 16 slots, %d genes, population %d, %d generations, %d seeds\n",
+           problem.layout.genes(), population, generations, seeds);
+
+    // Calibrate: median of what blend reaches in half the budget
+    if (!target_set) {
+        std::vector<Run> runs;
+        for (int s = 0; s < seeds; s++) runs.push_back({ga::CROSSOVER_BLEND, 0, 1000 + (uint64_t)s, {}});
+        run_all(problem, population, generations / 2, 1e300, runs, threads);
+        std::vector<double> best;
+        for (const Run& r : runs) best.push_back(r.result.best_fitness);
+        target = median(best);
+        printf("Target: %.2f (blend median after %d generations)\n", target, generations / 2);
+    } else {
+        printf("Target: %.2f\n", target);
+    }
+
+    // One row per operator and mode
+    std::vector<std::pair<int, int>> rows;
+    for (int op = 0; op < ga::CROSSOVER_COUNT; op++) {
+        rows.push_back({op, 0});
+        if (pipeline_chunks > 0) rows.push_back({op, pipeline_chunks});
+    }
+    std::vector<Run> runs;
+    for (const auto& row : rows) {
+        for (int s = 0; s < seeds; s++) runs.push_back({row.first, row.second, 1 + (uint64_t)s, {}});
+    }
+    run_all(problem, population, generations, target, runs, threads);
+
+    printf("\n  %-14s %6s %12s %12s %12s %10s\n", "Operator", "Hits", "Median gens", "Mean gens", "Mean best", "Speedup");
+    double blend_mean = 0.0;
+    for (const auto& row : rows) {
+        int op = row.first, chunks = row.second;
+        std::vector<double> gens;
+        double sum_gens = 0.0, sum_best = 0.0;
+        int hits = 0;
+        for (const Run& r : runs) {
+            if (r.crossover != op || r.pipeline_chunks != chunks) continue;
+            bool hit = r.result.time_to_target >= 0.0;
+            double g = hit ? r.result.generations_run : generations;
+            hits += hit;
+            gens.push_back(g);
+            sum_gens += g;
+            sum_best += r.result.best_fitness;
+        }
+        double mean_gens = sum_gens / seeds;
+        if (op == ga::CROSSOVER_BLEND && chunks == 0) blend_mean = mean_gens;
+        char hit_text[32], name[32];
+        snprintf(hit_text, sizeof(hit_text), "%d/%d", hits, seeds);
+        if (chunks > 0) {
+            snprintf(name, sizeof(name), "%s/pipe%d", ga::crossover_names[op], chunks);
+        } else {
+            snprintf(name, sizeof(name), "%s", ga::crossover_names[op]);
+        }
+        printf("  %-14s %6s %12.0f %12.1f %12.2f %9.2fx\n", name, hit_text,
+               median(gens), mean_gens, sum_best / seeds, blend_mean / mean_gens);
+    }
+    return 0;
+}
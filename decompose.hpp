@@ -0,0 +1,147 @@
+/**
+ * Decomposition Module - Slot interaction graph and block-coordinate groups
+ *
+ * Derives which slots interact from the constraint tables and the structure
+ * of fitness::palette_score():
+ *
+ *   strong edges (terms on exactly two slots):
+ *     - APCA pair constraints (fg, bg)
+ *     - hue drift between a bright slot and its base_slot
+ *     - CVD rules, when enabled (add_cvd_edges())
+ *   weak edges (aggregate terms spread over many slots):
+ *     - BONUS 1 hue spacing over the minimum of slots 1-6
+ *     - BONUS 3 Oklab separation over the minimum of slots 1-7
+ *     - BONUS 4 readability pairs (backgrounds 0-7 x all foregrounds)
+ *
+ * Groups are the connected components of the strong edges among free slots;
+ * fixed slots never join a group. Each group is then refined as a small
+ * subproblem with every other slot held at the current best palette.
+ */
+
+#ifndef DECOMPOSE_HPP
+#define DECOMPOSE_HPP
+
+#include <vector>
+#include <cstdio>
+
+#include "fitness.cuh"
+
+namespace decompose {
+
+constexpr double STRONG_EDGE = 1.0;
+constexpr double WEAK_EDGE = 0.1;
+
+struct SlotGraph {
+    int n_slots;
+    std::vector<double> weight;  // [n][n] symmetric coupling weight (0 = independent)
+
+    double at(int a, int b) const { return weight[a * n_slots + b]; }
+};
+
+// Groups in CSR form: slots of group g are slots[offsets[g] .. offsets[g+1])
+struct SlotGroups {
+    std::vector<int> offsets;
+    std::vector<int> slots;
+
+    int count() const { return (int)offsets.size() - 1; }
+    int size(int g) const { return offsets[g + 1] - offsets[g]; }
+};
+
+inline void add_edge(SlotGraph& g, int a, int b, double w) {
+    if (a == b) return;
+    double& ab = g.weight[a * g.n_slots + b];
+    double& ba = g.weight[b * g.n_slots + a];
+    if (w > ab) ab = w;
+    if (w > ba) ba = w;
+}
+
+/**
+ * Build the slot interaction graph for a 16-slot ANSI palette.
+ */
+inline SlotGraph build_slot_graph(const OklchSlotConstraint* slots, int n_slots,
+                                  const ApcaPairConstraint* pairs, int pair_count) {
+    SlotGraph g;
+    g.n_slots = n_slots;
+    g.weight.assign(n_slots * n_slots, 0.0);
+
+    // Weak: aggregate bonuses
+    for (int i = RED; i <= CYAN; i++)
+        for (int j = i + 1; j <= CYAN; j++) add_edge(g, i, j, WEAK_EDGE);
+    for (int i = RED; i <= WHITE; i++)
+        for (int j = i + 1; j <= WHITE; j++) add_edge(g, i, j, WEAK_EDGE);
+    for (int bg = 0; bg < n_slots; bg++)
+        for (int fg = 0; fg < n_slots; fg++)
+            if (fitness::is_readability_pair(fg, bg)) add_edge(g, fg, bg, WEAK_EDGE);
+
+    // Strong: pairwise constraints
+    for (int i = 0; i < pair_count; i++) {
+        add_edge(g, pairs[i].fg_index, pairs[i].bg_index, STRONG_EDGE);
+    }
+    for (int s = 0; s < n_slots; s++) {
+        if (slots[s].base_slot >= 0 && slots[s].max_hue_drift > 0.0) {
+            add_edge(g, s, slots[s].base_slot, STRONG_EDGE);
+        }
+    }
+
+    return g;
+}
+
+/**
+ * Add the CVD rule pairs as strong edges.
+ */
+inline void add_cvd_edges(SlotGraph& g, const CvdRule* rules, int rule_count) {
+    for (int i = 0; i < rule_count; i++) {
+        add_edge(g, rules[i].a_index, rules[i].b_index, STRONG_EDGE);
+    }
+}
+
+/**
+ * Split the free slots into groups: connected components of strong edges.
+ */
+inline SlotGroups find_groups(const SlotGraph& g, const OklchSlotConstraint* slots) {
+    int n = g.n_slots;
+    std::vector<int> component(n, -1);
+    SlotGroups groups;
+    groups.offsets.push_back(0);
+
+    for (int start = 0; start < n; start++) {
+        if (slots[start].fixed || component[start] >= 0) continue;
+
+        // Flood fill over strong edges between free slots
+        int id = groups.count();
+        std::vector<int> stack = {start};
+        component[start] = id;
+        while (!stack.empty()) {
+            int s = stack.back();
+            stack.pop_back();
+            groups.slots.push_back(s);
+            for (int t = 0; t < n; t++) {
+                if (slots[t].fixed || component[t] >= 0) continue;
+                if (g.at(s, t) >= STRONG_EDGE) {
+                    component[t] = id;
+                    stack.push_back(t);
+                }
+            }
+        }
+        groups.offsets.push_back((int)groups.slots.size());
+    }
+
+    return groups;
+}
+
+inline void print_groups(const SlotGroups& groups, const char** names) {
+    int max_size = 0;
+    for (int g = 0; g < groups.count(); g++) {
+        printf("  group %d:", g);
+        for (int k = groups.offsets[g]; k < groups.offsets[g + 1]; k++) {
+            printf(" %s", names[groups.slots[k]]);
+        }
+        printf("  (%d vars)\n", groups.size(g) * 3);
+        if (groups.size(g) > max_size) max_size = groups.size(g);
+    }
+    printf("  Largest subproblem: %d variables\n", max_size * 3);
+}
+
+} // namespace decompose
+
+#endif // DECOMPOSE_HPP
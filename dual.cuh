@@ -0,0 +1,120 @@
+/**
+ * Dual Theme Module - Dark and light variants co-optimized in one genome
+ *
+ * Genome layout: slots 0-15 are the dark theme, slots 16-31 the light theme.
+ * Each half has its own slot constraints and polarity-aware APCA rules
+ * (reverse polarity on the dark background, normal polarity on the light one).
+ *
+ * The chromatic slots (red..cyan, br.red..br.cyan) share one hue between the
+ * two halves: the dark hue is used for both, so the variants match by
+ * construction and each shared hue's cos/sin is computed once. The light
+ * half's hue genes of those slots stay in the layout but are pinned to their
+ * target hue (freeze_shared_hues), so the search does not spend mutations on
+ * them. Fixed slots (black and white in both halves) carry no genes
+ * and are copied from their precomputed colors.
+ */
+
+#ifndef DUAL_CUH
+#define DUAL_CUH
+
+#include "fitness.cuh"
+#include "genome.cuh"
+
+namespace dual {
+
+constexpr int SLOTS = 32;
+constexpr int LIGHT_BASE = 16;
+
+// Max chroma difference between the dark and light variant of a slot
+constexpr double MAX_CHROMA_GAP = 0.06;
+
+COLOR_FUNC inline bool hue_shared(int slot) {
+    return (slot >= RED && slot <= CYAN) || (slot >= BR_RED && slot <= BR_CYAN);
+}
+
+/**
+ * Pin the light half's shared hue genes: convert() never reads them, so a
+ * zero hue tolerance keeps initialization and mutation from moving them.
+ */
+inline void freeze_shared_hues(OklchSlotConstraint* light_slots) {
+    for (int i = 0; i < LIGHT_BASE; i++) {
+        if (hue_shared(i)) light_slots[i].hue_tolerance = 0.0;
+    }
+}
+
+/**
+ * Convert both halves of a dual genome, sharing hue and conversions.
+ * Fixed slots (see genome.cuh) are copied from their precomputed colors.
+ */
+COLOR_FUNC inline void convert(const double* g, const int16_t* slot_genes,
+                               const genome::FixedSlot* fixed, int n_fixed,
+                               fitness::SlotColor* s) {
+    for (int i = 0; i < n_fixed; i++) {
+        s[fixed[i].slot] = fixed[i].color;
+    }
+    for (int i = 0; i < LIGHT_BASE; i++) {
+        int dark = slot_genes[i];
+        int light = slot_genes[LIGHT_BASE + i];
+
+        fitness::HueBasis hb;
+        if (dark >= 0) {
+            hb = fitness::hue_basis(g[dark * 3 + 2]);
+            s[i] = fitness::slot_from_oklch(g[dark * 3 + 0], g[dark * 3 + 1], g[dark * 3 + 2], hb);
+        }
+        if (light < 0) continue;
+
+        if (dark >= 0 && hue_shared(i)) {
+            s[LIGHT_BASE + i] = fitness::slot_from_oklch(g[light * 3 + 0], g[light * 3 + 1],
+                                                         g[dark * 3 + 2], hb);
+        } else {
+            s[LIGHT_BASE + i] = fitness::slot_from_oklch(g[light * 3 + 0], g[light * 3 + 1],
+                                                         g[light * 3 + 2]);
+        }
+    }
+}
+
+/**
+ * Copy the shared hues into the light half's genes (for output).
+ */
+inline void tie_hues(const int16_t* slot_genes, double* g) {
+    for (int i = 0; i < LIGHT_BASE; i++) {
+        int dark = slot_genes[i];
+        int light = slot_genes[LIGHT_BASE + i];
+        if (hue_shared(i) && dark >= 0 && light >= 0) {
+            g[light * 3 + 2] = g[dark * 3 + 2];
+        }
+    }
+}
+
+/**
+ * Coupling between the halves: a slot keeps its identity across variants,
+ * so chroma may differ only by MAX_CHROMA_GAP (hue is already shared).
+ */
+COLOR_FUNC inline double coupling_terms(const fitness::SlotColor* s) {
+    double score = 0.0;
+    for (int i = 0; i < LIGHT_BASE; i++) {
+        if (!hue_shared(i)) continue;
+        double gap = fabs(s[i].C - s[LIGHT_BASE + i].C);
+        if (gap > MAX_CHROMA_GAP) {
+            score -= (gap - MAX_CHROMA_GAP) * 200.0;
+        }
+    }
+    return score;
+}
+
+/**
+ * Score a converted dual genome: both palette scores plus coupling.
+ */
+COLOR_FUNC inline double dual_score(const fitness::SlotColor* s,
+                                    const OklchSlotConstraint* dark_slots,
+                                    const ApcaPairConstraint* dark_pairs, int dark_pair_count,
+                                    const OklchSlotConstraint* light_slots,
+                                    const ApcaPairConstraint* light_pairs, int light_pair_count) {
+    return fitness::palette_score(s, dark_slots, dark_pairs, dark_pair_count) +
+           fitness::palette_score(s + LIGHT_BASE, light_slots, light_pairs, light_pair_count) +
+           coupling_terms(s);
+}
+
+} // namespace dual
+
+#endif // DUAL_CUH
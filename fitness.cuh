@@ -0,0 +1,502 @@
+/**
+ * Fitness Module - Palette Scoring Shared by GPU Kernels and Host Code
+ *
+ * This module provides:
+ * - Slot and APCA pair constraint definitions
+ * - Per-slot derived color data (sRGB, APCA luminance, Oklab), computed once
+ *   per slot and reused by every term that touches the slot
+ * - The individual fitness terms and the full palette score
+ * - Color vision deficiency rules, scored on simulated slot colors
+ *
+ * All functions work on both CUDA device and host, so host-side search stages
+ * score palettes with exactly the same math as the evaluation kernel.
+ */
+
+#ifndef FITNESS_CUH
+#define FITNESS_CUH
+
+#include <cstdint>
+
+#include "color.cuh"
+
+// =============================================================================
+// Color indices
+// =============================================================================
+enum ColorIndex {
+    BLACK = 0, RED, GREEN, YELLOW, BLUE, MAGENTA, CYAN, WHITE,
+    BR_BLACK, BR_RED, BR_GREEN, BR_YELLOW, BR_BLUE, BR_MAGENTA, BR_CYAN, BR_WHITE
+};
+
+// =============================================================================
+// OKLCH Constraint System
+// =============================================================================
+
+// Slot constraint in OKLCH space
+struct OklchSlotConstraint {
+    double target_hue;      // Target hue in degrees (0-360)
+    double hue_tolerance;   // Allowed hue deviation (+/- degrees)
+    double min_L, max_L;    // Lightness range (0-1)
+    double min_C, max_C;    // Chroma range (0-~0.4)
+    bool fixed;            // Is this a fixed RGB color?
+    double fixed_r, fixed_g, fixed_b;  // Fixed RGB values (0-255)
+    int8_t base_slot;      // For bright colors: base slot index (-1 if none)
+    double max_hue_drift;   // Max hue deviation from base color (degrees, 0 = unlimited)
+};
+
+// APCA polarity required by a pair constraint
+constexpr int8_t POLARITY_ANY = 0;       // |Lc|
+constexpr int8_t POLARITY_NORMAL = 1;    // dark text on light background (Lc > 0)
+constexpr int8_t POLARITY_REVERSE = -1;  // light text on dark background (Lc < 0)
+
+// APCA pair constraint
+struct ApcaPairConstraint {
+    int16_t fg_index;      // Foreground color index (0-15, or 0-255 in 256-color mode)
+    int16_t bg_index;      // Background color index
+    double min_apca;       // Minimum APCA contrast (absolute value)
+    double target_apca;    // Target APCA for uniformity (0 = no target, just meet minimum)
+    int8_t polarity;       // POLARITY_* (wrong polarity scores as negative contrast)
+};
+
+// CVD rule: a slot pair that must stay distinguishable under the deficiencies
+// in deficiency_mask (bit = 1 << color::cvd::Deficiency)
+struct CvdRule {
+    int8_t a_index;        // First slot (foreground for the APCA check)
+    int8_t b_index;        // Second slot (background for the APCA check)
+    uint8_t deficiency_mask;
+    double min_distance;   // Minimum Oklab distance when simulated (0 = unchecked)
+    double min_apca;       // Minimum APCA contrast when simulated (0 = unchecked)
+};
+
+namespace fitness {
+
+// =============================================================================
+// Per-slot color data
+// =============================================================================
+
+/**
+ * Everything the fitness terms need to know about one palette slot.
+ * OKLCH is kept as stored in the genome (hue and chroma terms use it);
+ * sRGB is gamut-clamped, and APCA luminance / Oklab derive from that sRGB.
+ */
+struct SlotColor {
+    double L, C, H;         // OKLCH (genome values)
+    double r, g, b;         // sRGB (0-255), clamped to gamut
+    color::apca::Prepared lum;  // APCA luminance (soft-clamped) and exponent powers
+    color::oklab::Lab lab;  // Oklab of the clamped sRGB color
+    bool in_gamut;          // Was the OKLCH color inside sRGB?
+};
+
+// cos/sin of a hue, shared by every slot converted at that hue
+struct HueBasis {
+    double cos_h, sin_h;
+};
+
+COLOR_FUNC inline HueBasis hue_basis(double H) {
+    double h_rad = H * color::PI / 180.0;
+    return {cos(h_rad), sin(h_rad)};
+}
+
+/**
+ * Derive slot data from an OKLCH genome triple whose hue basis is known.
+ */
+COLOR_FUNC inline SlotColor slot_from_oklch(double L, double C, double H, const HueBasis& hb) {
+    SlotColor s;
+    s.L = L;
+    s.C = C;
+    s.H = H;
+    color::oklab::Lab unclamped = {L, C * hb.cos_h, C * hb.sin_h};
+    color::oklab::to_srgb(unclamped, &s.r, &s.g, &s.b);
+    s.lum = color::apca::prepare(color::apca::soft_clamp(color::apca::luminance(s.r, s.g, s.b)));
+    s.lab = color::oklab::from_srgb(s.r, s.g, s.b);
+    s.in_gamut = color::oklab::is_in_gamut(unclamped);
+    return s;
+}
+
+/**
+ * Derive slot data from an OKLCH genome triple.
+ */
+COLOR_FUNC inline SlotColor slot_from_oklch(double L, double C, double H) {
+    return slot_from_oklch(L, C, H, hue_basis(H));
+}
+
+/**
+ * Derive slot data from an sRGB color (0-255).
+ */
+COLOR_FUNC inline SlotColor slot_from_srgb(double r, double g, double b) {
+    SlotColor s;
+    s.r = r;
+    s.g = g;
+    s.b = b;
+    s.lum = color::apca::prepare(color::apca::soft_clamp(color::apca::luminance(r, g, b)));
+    s.lab = color::oklab::from_srgb(r, g, b);
+    double C = sqrt(s.lab.a * s.lab.a + s.lab.b * s.lab.b);
+    double H = atan2(s.lab.b, s.lab.a) * 180.0 / color::PI;
+    s.L = s.lab.L;
+    s.C = C;
+    s.H = H < 0.0 ? H + 360.0 : H;
+    s.in_gamut = true;
+    return s;
+}
+
+/**
+ * Oklab distance between two slots (uses the cached Oklab values).
+ */
+COLOR_FUNC inline double slot_distance(const SlotColor& a, const SlotColor& b) {
+    double dL = a.lab.L - b.lab.L;
+    double da = a.lab.a - b.lab.a;
+    double db = a.lab.b - b.lab.b;
+    return sqrt(dL * dL + da * da + db * db);
+}
+
+// =============================================================================
+// Fitness terms
+// =============================================================================
+
+/**
+ * APCA contrast of a pair as seen by its constraint: |Lc| for POLARITY_ANY,
+ * otherwise signed so that the wrong polarity counts as negative contrast.
+ */
+COLOR_FUNC inline double pair_contrast(const ApcaPairConstraint& p,
+                                       const color::apca::Prepared& fg,
+                                       const color::apca::Prepared& bg) {
+    double lc = color::apca::contrast_prepared(fg, bg);
+    return p.polarity == POLARITY_ANY ? fabs(lc) : lc * p.polarity;
+}
+
+/**
+ * CONSTRAINT 1: one APCA pair constraint (hard requirement + uniformity).
+ */
+COLOR_FUNC inline double apca_pair_score(const ApcaPairConstraint& p, double apca) {
+    if (apca >= p.min_apca) {
+        // Constraint met - base reward
+        double score = 100.0;
+
+        if (p.target_apca > 0.0) {
+            // Uniformity mode: asymmetric penalty (heavier below, lighter above)
+            if (apca < p.target_apca) {
+                double shortfall = p.target_apca - apca;
+                score -= shortfall * 3.0;  // Heavy penalty for below target
+            } else {
+                double excess = apca - p.target_apca;
+                score -= excess * 1.0;  // Light penalty for exceeding (uniformity)
+            }
+        } else {
+            // No target: reward exceeding minimum (old behavior)
+            score += (apca - p.min_apca) * 5.0;
+        }
+        return score;
+    }
+
+    // Constraint violated - heavy penalty proportional to shortfall
+    return -(p.min_apca - apca) * 50.0;
+}
+
+/**
+ * CONSTRAINT 2: hue drift of a bright slot from its base slot.
+ */
+COLOR_FUNC inline double hue_drift_score(double H_bright, double H_base, double max_drift) {
+    double hdist = color::hue_distance(H_bright, H_base);
+    if (hdist <= max_drift) {
+        return 30.0;  // Bonus for matching hue
+    }
+    return -(hdist - max_drift) * 5.0;  // Penalty for drift
+}
+
+/**
+ * CONSTRAINT 3: gamut validity of one slot.
+ */
+COLOR_FUNC inline double gamut_score(bool in_gamut) {
+    return in_gamut ? 0.0 : -500.0;  // Heavy penalty for out-of-gamut
+}
+
+/**
+ * BONUS 1: minimum pairwise hue distance among the base colors.
+ * Ideal minimum spacing for 6 colors is 60° but we accept 40°.
+ */
+COLOR_FUNC inline double hue_spacing_score(double min_hue_dist) {
+    if (min_hue_dist >= 40.0) {
+        return min_hue_dist * 2.0;
+    }
+    return -(40.0 - min_hue_dist) * 5.0;
+}
+
+/**
+ * BONUS 2: chroma of one base color (prefer more saturated colors).
+ */
+COLOR_FUNC inline bool has_chroma_bonus(int slot) {
+    return slot >= RED && slot <= CYAN;
+}
+
+COLOR_FUNC inline double chroma_score(double C) {
+    return C * 50.0;  // Small bonus for saturation
+}
+
+/**
+ * BONUS 3: minimum Oklab distance among the base colors.
+ * Reward good separation (0.15 is noticeable difference).
+ */
+COLOR_FUNC inline double separation_score(double min_dist) {
+    if (min_dist >= 0.15) {
+        return min_dist * 100.0;
+    }
+    return -(0.15 - min_dist) * 300.0;
+}
+
+/**
+ * BONUS 4: one general fg/bg pair (soft bonus for general readability).
+ * Pairs use backgrounds 0-7 against every other slot.
+ */
+COLOR_FUNC inline bool is_readability_pair(int fg, int bg) {
+    return bg < 8 && fg != bg;
+}
+
+COLOR_FUNC inline double readability_score(double apca) {
+    return apca >= 40.0 ? 1.0 : 0.0;  // Small bonus for readable pairs
+}
+
+// =============================================================================
+// Full palette score
+// =============================================================================
+
+// Upper bound on display models in one robust evaluation
+constexpr int MAX_DISPLAY_MODELS = 32;
+
+/**
+ * Contrast terms (CONSTRAINT 1 + BONUS 4) of a 16-slot palette.
+ * Only reads each slot's prepared APCA luminance, so it can be re-run cheaply
+ * for the same palette seen through different display models.
+ */
+COLOR_FUNC inline double contrast_terms(const color::apca::Prepared* lum,
+                                        const ApcaPairConstraint* pairs,
+                                        int pair_count) {
+    double score = 0.0;
+
+    // CONSTRAINT 1: APCA pair constraints
+    for (int i = 0; i < pair_count; i++) {
+        const ApcaPairConstraint& p = pairs[i];
+        double apca = pair_contrast(p, lum[p.fg_index], lum[p.bg_index]);
+        score += apca_pair_score(p, apca);
+    }
+
+    // BONUS 4: All other APCA pairs
+    for (int bg = 0; bg < 8; bg++) {
+        for (int fg = 0; fg < 16; fg++) {
+            if (!is_readability_pair(fg, bg)) continue;
+            double apca = fabs(color::apca::contrast_prepared(lum[fg], lum[bg]));
+            score += readability_score(apca);
+        }
+    }
+
+    return score;
+}
+
+/**
+ * Display-independent terms (CONSTRAINT 2-3, BONUS 1-3) of a 16-slot palette.
+ */
+COLOR_FUNC inline double perceptual_terms(const SlotColor* s,
+                                          const OklchSlotConstraint* slots) {
+    double score = 0.0;
+
+    // CONSTRAINT 2: Hue drift for bright colors (must match base)
+    for (int slot = 8; slot <= 14; slot++) {
+        const OklchSlotConstraint& c = slots[slot];
+        if (c.base_slot < 0 || c.max_hue_drift <= 0.0) continue;
+        score += hue_drift_score(s[slot].H, s[c.base_slot].H, c.max_hue_drift);
+    }
+
+    // CONSTRAINT 3: Gamut validity
+    for (int i = 0; i < 16; i++) {
+        score += gamut_score(s[i].in_gamut);
+    }
+
+    // BONUS 1: Hue spacing for base colors (1-6)
+    {
+        double min_hue_dist = 360.0;
+        for (int i = RED; i <= CYAN; i++) {
+            for (int j = i + 1; j <= CYAN; j++) {
+                double hdist = color::hue_distance(s[i].H, s[j].H);
+                if (hdist < min_hue_dist) {
+                    min_hue_dist = hdist;
+                }
+            }
+        }
+        score += hue_spacing_score(min_hue_dist);
+    }
+
+    // BONUS 2: Chroma (base colors only)
+    for (int i = RED; i <= CYAN; i++) {
+        score += chroma_score(s[i].C);
+    }
+
+    // BONUS 3: Perceptual distance (Oklab) between base colors (1-7)
+    {
+        double min_dist = 1000.0;
+        for (int i = RED; i <= WHITE; i++) {
+            for (int j = i + 1; j <= WHITE; j++) {
+                double dist = slot_distance(s[i], s[j]);
+                if (dist < min_dist) {
+                    min_dist = dist;
+                }
+            }
+        }
+        score += separation_score(min_dist);
+    }
+
+    return score;
+}
+
+/**
+ * Score a 16-slot palette from its per-slot color data.
+ */
+COLOR_FUNC inline double palette_score(const SlotColor* s,
+                                       const OklchSlotConstraint* slots,
+                                       const ApcaPairConstraint* pairs,
+                                       int pair_count) {
+    color::apca::Prepared lum[16];
+    for (int i = 0; i < 16; i++) {
+        lum[i] = s[i].lum;
+    }
+    return perceptual_terms(s, slots) + contrast_terms(lum, pairs, pair_count);
+}
+
+/**
+ * Score a 16-slot palette under a batch of display models.
+ * Perceptual terms are computed once; the contrast terms are computed per
+ * model from one batched linearization per slot, then reduced to the worst
+ * case (quantile = 0) or the given lower quantile across models.
+ */
+COLOR_FUNC inline double robust_palette_score(const SlotColor* s,
+                                              const OklchSlotConstraint* slots,
+                                              const ApcaPairConstraint* pairs,
+                                              int pair_count,
+                                              const color::apca::DisplayModel* models,
+                                              int n_models, double quantile) {
+    // Y[slot][model], one batched linearization per slot
+    double Y[16][MAX_DISPLAY_MODELS];
+    for (int i = 0; i < 16; i++) {
+        color::apca::luminance_batch(s[i].r, s[i].g, s[i].b, models, n_models, Y[i]);
+    }
+
+    // Contrast terms per model, kept sorted ascending (insertion sort, n is small)
+    double scores[MAX_DISPLAY_MODELS];
+    for (int m = 0; m < n_models; m++) {
+        color::apca::Prepared lum[16];
+        for (int i = 0; i < 16; i++) {
+            lum[i] = color::apca::prepare(Y[i][m]);
+        }
+        double v = contrast_terms(lum, pairs, pair_count);
+        int k = m;
+        while (k > 0 && scores[k - 1] > v) {
+            scores[k] = scores[k - 1];
+            k--;
+        }
+        scores[k] = v;
+    }
+
+    int q = (int)(quantile * (n_models - 1));
+    return perceptual_terms(s, slots) + scores[q];
+}
+
+// =============================================================================
+// Color vision deficiency terms
+// =============================================================================
+
+// Simulated appearance of one slot under one deficiency
+struct CvdSlot {
+    color::oklab::Lab lab;
+    color::apca::Prepared lum;
+};
+
+/**
+ * CVD rule terms. models[d] is the simulation matrix for deficiency d
+ * (n_models = color::cvd::DEFICIENCY_COUNT). Every slot that appears in a rule
+ * is simulated once under all models, and the results are shared by every
+ * rule that reads it.
+ */
+COLOR_FUNC inline double cvd_terms(const SlotColor* s,
+                                   const CvdRule* rules, int rule_count,
+                                   const color::cvd::Matrix* models, int n_models) {
+    CvdSlot sim[16][color::cvd::DEFICIENCY_COUNT];
+    bool simulated[16] = {};
+
+    double score = 0.0;
+    for (int i = 0; i < rule_count; i++) {
+        const CvdRule& rule = rules[i];
+        int pair[2] = {rule.a_index, rule.b_index};
+        for (int k = 0; k < 2; k++) {
+            int slot = pair[k];
+            if (simulated[slot]) continue;
+            simulated[slot] = true;
+
+            double lin[3 * color::cvd::DEFICIENCY_COUNT];
+            color::cvd::simulate_linear(color::wcag2::linearize(s[slot].r),
+                                        color::wcag2::linearize(s[slot].g),
+                                        color::wcag2::linearize(s[slot].b),
+                                        models, n_models, lin);
+            for (int d = 0; d < n_models; d++) {
+                const double* c = &lin[d * 3];
+                sim[slot][d].lab = color::oklab::from_linear_rgb(c[0], c[1], c[2]);
+                sim[slot][d].lum = color::apca::prepare(color::apca::soft_clamp(color::apca::luminance(
+                    color::oklab::linear_to_srgb_channel(c[0]),
+                    color::oklab::linear_to_srgb_channel(c[1]),
+                    color::oklab::linear_to_srgb_channel(c[2]))));
+            }
+        }
+
+        for (int d = 0; d < n_models; d++) {
+            if (!(rule.deficiency_mask & (1 << d))) continue;
+            const CvdSlot& a = sim[rule.a_index][d];
+            const CvdSlot& b = sim[rule.b_index][d];
+
+            if (rule.min_distance > 0.0) {
+                double dL = a.lab.L - b.lab.L;
+                double da = a.lab.a - b.lab.a;
+                double db = a.lab.b - b.lab.b;
+                double dist = sqrt(dL * dL + da * da + db * db);
+                if (dist < rule.min_distance) {
+                    score -= (rule.min_distance - dist) * 300.0;  // Same scale as BONUS 3
+                }
+            }
+            if (rule.min_apca > 0.0) {
+                double apca = fabs(color::apca::contrast_prepared(a.lum, b.lum));
+                if (apca < rule.min_apca) {
+                    score -= (rule.min_apca - apca) * 50.0;  // Same scale as CONSTRAINT 1
+                }
+            }
+        }
+    }
+
+    return score;
+}
+
+// =============================================================================
+// Usage-weighted contrast
+// =============================================================================
+
+// Full usage bonus, split over the pairs by their share of the cell-seconds
+constexpr double USAGE_BONUS = 200.0;
+// APCA Lc at which a pair counts as fully readable (body text)
+constexpr double USAGE_TARGET_LC = 75.0;
+
+/**
+ * BONUS 5: contrast of the pairs real sessions draw. weights[fg * 16 + bg]
+ * is the pair's share of the captured cell-seconds (usage.hpp, sums to 1),
+ * so the bonus follows where text actually is instead of treating every
+ * pair alike. Contrast saturates at the body text level.
+ */
+COLOR_FUNC inline double usage_terms(const SlotColor* s, const double* weights) {
+    double score = 0.0;
+    for (int fg = 0; fg < 16; fg++) {
+        for (int bg = 0; bg < 16; bg++) {
+            double w = weights[fg * 16 + bg];
+            if (w <= 0.0) continue;
+            double apca = fabs(color::apca::contrast_prepared(s[fg].lum, s[bg].lum));
+            score += w * USAGE_BONUS * fmin(apca, USAGE_TARGET_LC) / USAGE_TARGET_LC;
+        }
+    }
+    return score;
+}
+
+} // namespace fitness
+
+#endif // FITNESS_CUH
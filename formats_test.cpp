@@ -0,0 +1,115 @@
+/**
+ * Theme Format Test Suite
+ *
+ * Every fixture in palettes/formats holds the same 16 colors in another
+ * terminal's theme format. Each must be detected as its format and decode
+ * to exactly the Ghostty fixture's RGB, so it also scores the same fitness.
+ * A few inline snippets cover the color notations and Xresources defines.
+ *
+ * Build: g++ -std=c++17 -O2 formats_test.cpp -o formats_test
+ * Run: ./formats_test palettes/formats
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "theme_formats.hpp"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+static void check(const char* name, bool ok) {
+    tests_run++;
+    if (!ok) tests_failed++;
+    printf("  %s %s\n", ok ? "✓" : "✗", name);
+}
+
+static bool same_palette(const theme_metrics::Palette& a, const theme_metrics::Palette& b) {
+    return memcmp(a.rgb, b.rgb, sizeof(a.rgb)) == 0;
+}
+
+static bool parse_text(theme_formats::Format format, const char* text, theme_metrics::Palette* out) {
+    theme_formats::Text t = {text, text + strlen(text)};
+    return theme_formats::parse(format, t, out);
+}
+
+struct Fixture {
+    const char* file;
+    theme_formats::Format format;
+};
+
+constexpr Fixture fixtures[] = {
+    {"kitty-default.conf", theme_formats::KITTY},
+    {"alacritty-default.toml", theme_formats::ALACRITTY},
+    {"alacritty-default.yml", theme_formats::ALACRITTY},
+    {"wezterm-default.toml", theme_formats::WEZTERM},
+    {"default.Xresources", theme_formats::XRESOURCES},
+    {"kitty-default.itermcolors", theme_formats::ITERM2},
+};
+
+void test_fixtures(const std::string& dir) {
+    printf("\nFixtures (%s):\n", dir.c_str());
+    theme_metrics::Palette reference;
+    theme_formats::Format format;
+    bool loaded = theme_formats::load_file((dir + "/ghostty-default").c_str(), &reference, &format);
+    check("ghostty-default loads as ghostty", loaded && format == theme_formats::GHOSTTY);
+    if (!loaded) return;
+    double fitness = theme_metrics::compute(reference).fitness;
+
+    for (const Fixture& f : fixtures) {
+        theme_metrics::Palette palette;
+        std::string name = f.file;
+        bool ok = theme_formats::load_file((dir + "/" + f.file).c_str(), &palette, &format);
+        check((name + " loads as " + theme_formats::format_names[f.format]).c_str(), ok && format == f.format);
+        if (!ok) continue;
+        check((name + " has the ghostty RGB").c_str(), same_palette(palette, reference));
+        check((name + " has the ghostty fitness").c_str(), theme_metrics::compute(palette).fitness == fitness);
+    }
+}
+
+void test_snippets() {
+    printf("\nSnippets:\n");
+    std::string kitty, ghostty;
+    for (int i = 0; i < 16; i++) {
+        char line[64];
+        snprintf(line, sizeof(line), "color%d #%02x%02x%02x\n", i, i * 16, 255 - i, i);
+        kitty += line;
+        snprintf(line, sizeof(line), "palette = %d=#%02x%02x%02x\n", i, i * 16, 255 - i, i);
+        ghostty += line;
+    }
+    theme_metrics::Palette a, b;
+    check("kitty and ghostty text agree",
+          parse_text(theme_formats::KITTY, kitty.c_str(), &a) &&
+          parse_text(theme_formats::GHOSTTY, ghostty.c_str(), &b) && same_palette(a, b));
+
+    std::string missing = kitty.substr(0, kitty.rfind("color15"));
+    check("15 of 16 colors is incomplete", !parse_text(theme_formats::KITTY, missing.c_str(), &a));
+
+    uint8_t rgb[3];
+    const char* notations[] = {"#fa0", "#ffaa00", "0xffaa00", "rgb:ff/aa/00", "rgb:ffff/aaaa/0000"};
+    for (const char* n : notations) {
+        bool ok = theme_formats::parse_color({n, n + strlen(n)}, rgb) &&
+                  rgb[0] == 0xff && rgb[1] == 0xaa && rgb[2] == 0x00;
+        check((std::string(n) + " is ffaa00").c_str(), ok);
+    }
+
+    std::string xresources = "#define base #102030\n";
+    for (int i = 0; i < 16; i++) {
+        xresources += "*.color" + std::to_string(i) + (i == 4 ? ": base\n" : ": #000000\n");
+    }
+    bool ok = parse_text(theme_formats::XRESOURCES, xresources.c_str(), &a);
+    check("xresources #define is substituted", ok && a.rgb[4][0] == 0x10 && a.rgb[4][1] == 0x20 && a.rgb[4][2] == 0x30);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        printf("Usage: %s <palettes/formats directory>\n", argv[0]);
+        return 2;
+    }
+    test_fixtures(argv[1]);
+    test_snippets();
+
+    printf("\n%d tests, %d failed\n", tests_run, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
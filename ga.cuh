@@ -0,0 +1,337 @@
+/**
+ * GA Operators Module - Genetic operators shared by the GPU and CPU backends
+ *
+ * Initialization, crossover and mutation of OKLCH genomes (see genome.cuh),
+ * templated on the random number source so the CUDA kernels (curand) and the
+ * CPU backend (HostRng) run exactly the same operator code. An Rng provides:
+ *   double uniform();  // (0, 1]
+ *   double normal();   // N(0, 1)
+ *
+ * Also holds the tunable GA parameters (population, elite ratio, the
+ * adaptive mutation schedule and the crossover operator) and their
+ * key = value file format, written by hexa-autotune and read with --params.
+ */
+
+#ifndef GA_CUH
+#define GA_CUH
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "fitness.cuh"
+
+namespace ga {
+
+// =============================================================================
+// Parameters
+// =============================================================================
+
+/**
+ * Crossover operators. Each one places every child coordinate at x1 + t *
+ * (x2 - x1) for some t, hue along the shorter arc (lerp_hue):
+ *   BLEND    one t in [0, 1] per gene, shared by L, C and H
+ *   UNIFORM  each gene copied whole from one parent (t = 0 or 1)
+ *   BLX      BLX-alpha: independent t in [-alpha, 1 + alpha] per coordinate
+ *   SBX      simulated binary crossover, independent t per coordinate
+ *   GROUP    UNIFORM over slot groups: a bright slot and its base slot
+ *            always come from the same parent
+ * BLX and SBX can leave the parents' box, so their children are clamped
+ * back into the slot constraint before mutation.
+ */
+enum Crossover { CROSSOVER_BLEND, CROSSOVER_UNIFORM, CROSSOVER_BLX, CROSSOVER_SBX, CROSSOVER_GROUP,
+                 CROSSOVER_COUNT };
+
+constexpr const char* crossover_names[CROSSOVER_COUNT] = {"blend", "uniform", "blx", "sbx", "group"};
+
+constexpr double BLX_ALPHA = 0.5;  // extension beyond the parents on each side
+constexpr double SBX_ETA = 2.0;    // distribution index (larger = children nearer the parents)
+
+// Operator of a name, -1 if unknown
+inline int crossover_from_name(const char* name) {
+    for (int i = 0; i < CROSSOVER_COUNT; i++) {
+        if (strcmp(name, crossover_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+struct Params {
+    int population;
+    double mutation_rate;     // per-coordinate mutation probability
+    double elite_ratio;       // fraction of the population kept and bred from
+    int stagnation_limit;     // generations without improvement before mutation grows
+    double mutation_growth;   // per-generation mutation growth once stagnant
+    double max_mutation;      // cap of the grown mutation rate
+    int crossover;            // Crossover
+};
+
+inline Params default_params(int population) {
+    return {population, 0.15, 0.1, 100, 1.01, 0.5, CROSSOVER_BLEND};
+}
+
+inline int elite_count(const Params& p) {
+    int n = (int)(p.population * p.elite_ratio);
+    return n < 1 ? 1 : n;
+}
+
+/**
+ * Adaptive mutation: reset on improvement, grow while stagnant.
+ */
+inline double next_mutation(const Params& p, double current, int stagnant_generations) {
+    if (stagnant_generations == 0) return p.mutation_rate;
+    if (stagnant_generations > p.stagnation_limit) {
+        return fmin(p.max_mutation, current * p.mutation_growth);
+    }
+    return current;
+}
+
+/**
+ * Load a parameter file ("key = value" lines, '#' comments). Keys not in the
+ * file keep their value in *p. Prints an error and returns false on bad input.
+ */
+inline bool load_params(const char* path, Params* p) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("Error: Could not open %s\n", path);
+        return false;
+    }
+    char line[256];
+    int line_no = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        line_no++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char key[64], text[64];
+        int n = sscanf(line, " %63[a-z_] = %63s", key, text);
+        if (n <= 0) continue;
+        double value = n == 2 ? atof(text) : 0.0;
+        if (n != 2) {
+            printf("Error: %s:%d: expected 'key = value'\n", path, line_no);
+            ok = false;
+        } else if (strcmp(key, "crossover") == 0) {
+            p->crossover = crossover_from_name(text);
+            if (p->crossover < 0) {
+                printf("Error: %s:%d: unknown crossover '%s'\n", path, line_no, text);
+                ok = false;
+            }
+        } else if (strcmp(key, "population") == 0) {
+            p->population = (int)value;
+        } else if (strcmp(key, "mutation_rate") == 0) {
+            p->mutation_rate = value;
+        } else if (strcmp(key, "elite_ratio") == 0) {
+            p->elite_ratio = value;
+        } else if (strcmp(key, "stagnation_limit") == 0) {
+            p->stagnation_limit = (int)value;
+        } else if (strcmp(key, "mutation_growth") == 0) {
+            p->mutation_growth = value;
+        } else if (strcmp(key, "max_mutation") == 0) {
+            p->max_mutation = value;
+        } else {
+            printf("Error: %s:%d: unknown key '%s'\n", path, line_no, key);
+            ok = false;
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+/**
+ * Write a parameter file for --params. The population is tuned on the CPU
+ * backend, so it is written as a comment: the GPU solver picks its own.
+ */
+inline bool save_params(const char* path, const Params& p, const char* comment) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        printf("Error: Could not open %s for writing\n", path);
+        return false;
+    }
+    fprintf(f, "# %s\n", comment);
+    fprintf(f, "# population = %d (CPU backend; pass -p to use it on the GPU)\n", p.population);
+    fprintf(f, "mutation_rate = %.4f\n", p.mutation_rate);
+    fprintf(f, "elite_ratio = %.4f\n", p.elite_ratio);
+    fprintf(f, "stagnation_limit = %d\n", p.stagnation_limit);
+    fprintf(f, "mutation_growth = %.4f\n", p.mutation_growth);
+    fprintf(f, "max_mutation = %.4f\n", p.max_mutation);
+    fprintf(f, "crossover = %s\n", crossover_names[p.crossover]);
+    return fclose(f) == 0;
+}
+
+// =============================================================================
+// Operators
+// =============================================================================
+
+/**
+ * Random OKLCH gene within a slot constraint, chroma clamped to gamut.
+ */
+template <typename Rng>
+COLOR_FUNC inline void random_gene(const OklchSlotConstraint& c, Rng& rng, double* gene) {
+    double L = c.min_L + rng.uniform() * (c.max_L - c.min_L);
+    double H = c.target_hue + (rng.uniform() - 0.5) * 2.0 * c.hue_tolerance;
+    H = color::oklch::normalize_hue(H);
+
+    // Determine chroma range, clamped to gamut
+    double max_C = color::oklch_max_chroma(L, H);
+    double C_min = fmin(c.min_C, max_C);
+    double C_max = fmin(c.max_C, max_C);
+
+    gene[0] = L;
+    gene[1] = C_min + rng.uniform() * (C_max - C_min);
+    gene[2] = H;
+}
+
+/**
+ * Push a hue back within the slot's tolerance of its target hue.
+ */
+COLOR_FUNC inline double clamp_hue(const OklchSlotConstraint& c, double H) {
+    double hdist = color::hue_distance(H, c.target_hue);
+    if (hdist > c.hue_tolerance) {
+        H = color::oklch::lerp_hue(c.target_hue, H, c.hue_tolerance / hdist);
+    }
+    return H;
+}
+
+/**
+ * Clamp an OKLCH gene into the slot's constraint box and the sRGB gamut.
+ */
+COLOR_FUNC inline void clamp_gene(const OklchSlotConstraint& c, double* L, double* C, double* H) {
+    *L = fmin(c.max_L, fmax(c.min_L, *L));
+    *H = clamp_hue(c, *H);
+    *C = fmin(fmin(c.max_C, color::oklch_max_chroma(*L, *H)), fmax(c.min_C, *C));
+}
+
+/**
+ * Mutate one slot's OKLCH values in place.
+ * Each of L, H, C is perturbed with probability mutation_rate by a Gaussian
+ * step scaled to the slot's constraint range (times step_scale), then clamped
+ * back into the constraint box and sRGB gamut.
+ */
+template <typename Rng>
+COLOR_FUNC inline void mutate_slot(double* L_io, double* C_io, double* H_io,
+                                   const OklchSlotConstraint& c, double mutation_rate,
+                                   double step_scale, Rng& rng) {
+    double L = *L_io;
+    double C = *C_io;
+    double H = *H_io;
+
+    if (rng.uniform() < mutation_rate) {
+        // Mutate L
+        double L_range = c.max_L - c.min_L;
+        L += rng.normal() * L_range * 0.1 * step_scale;
+        if (L < c.min_L) L = c.min_L;
+        if (L > c.max_L) L = c.max_L;
+    }
+
+    if (rng.uniform() < mutation_rate) {
+        // Mutate H (circular), then clamp to constraint range
+        H += rng.normal() * c.hue_tolerance * 0.3 * step_scale;
+        H = clamp_hue(c, color::oklch::normalize_hue(H));
+    }
+
+    if (rng.uniform() < mutation_rate) {
+        // Mutate C
+        double C_range = c.max_C - c.min_C;
+        C += rng.normal() * C_range * 0.15 * step_scale;
+
+        // Clamp to constraint range and gamut
+        double max_C = color::oklch_max_chroma(L, H);
+        if (C < c.min_C) C = c.min_C;
+        if (C > c.max_C) C = c.max_C;
+        if (C > max_C) C = max_C;
+    }
+
+    // Ensure gamut validity
+    double max_C = color::oklch_max_chroma(L, H);
+    if (C > max_C) C = max_C;
+
+    *L_io = L;
+    *C_io = C;
+    *H_io = H;
+}
+
+/**
+ * Pick one of the first n elite ranks uniformly.
+ */
+template <typename Rng>
+COLOR_FUNC inline int pick(int n, Rng& rng) {
+    int k = (int)(rng.uniform() * n);
+    return k < n ? k : n - 1;  // uniform() may return exactly 1
+}
+
+/**
+ * Interpolation parameter of one coordinate under BLX or SBX.
+ */
+template <typename Rng>
+COLOR_FUNC inline double coordinate_t(int crossover, Rng& rng) {
+    if (crossover == CROSSOVER_BLX) {
+        return -BLX_ALPHA + rng.uniform() * (1.0 + 2.0 * BLX_ALPHA);
+    }
+    // SBX spread factor beta, then one of the two children at (1 -+ beta) / 2
+    double u = fmin(rng.uniform(), 1.0 - 1e-9);
+    double beta = u <= 0.5 ? pow(2.0 * u, 1.0 / (SBX_ETA + 1.0))
+                           : pow(1.0 / (2.0 * (1.0 - u)), 1.0 / (SBX_ETA + 1.0));
+    return rng.uniform() <= 0.5 ? 0.5 * (1.0 - beta) : 0.5 * (1.0 + beta);
+}
+
+// Integer hash (murmur3 finalizer), for per-group parent choices
+COLOR_FUNC inline unsigned int mix32(unsigned int x) {
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * Cross two parent genomes gene by gene with the given operator (Crossover;
+ * circular hue interpolation), then mutate each gene within its slot's
+ * constraint.
+ */
+template <typename Rng>
+COLOR_FUNC inline void breed(const double* p1, const double* p2, double* child,
+                             const int16_t* gene_slots, int n_genes,
+                             const OklchSlotConstraint* slots, int crossover,
+                             double mutation_rate, double step_scale, Rng& rng) {
+    // GROUP: the parent of a group is one bit of a per-child salted hash
+    unsigned int salt = crossover == CROSSOVER_GROUP ? (unsigned int)(rng.uniform() * 4294967295.0) : 0u;
+
+    for (int gene = 0; gene < n_genes; gene++) {
+        const OklchSlotConstraint& c = slots[gene_slots[gene]];
+        const double* a = &p1[gene * 3];
+        const double* b = &p2[gene * 3];
+
+        double t[3];
+        if (crossover == CROSSOVER_BLX || crossover == CROSSOVER_SBX) {
+            for (int k = 0; k < 3; k++) t[k] = coordinate_t(crossover, rng);
+        } else {
+            double tg;
+            if (crossover == CROSSOVER_UNIFORM) {
+                tg = rng.uniform() <= 0.5 ? 0.0 : 1.0;
+            } else if (crossover == CROSSOVER_GROUP) {
+                unsigned int group = c.base_slot >= 0 ? (unsigned int)c.base_slot : (unsigned int)gene_slots[gene];
+                tg = (mix32(group ^ salt) & 1u) ? 1.0 : 0.0;
+            } else {
+                tg = rng.uniform();
+            }
+            t[0] = t[1] = t[2] = tg;
+        }
+        double L = a[0] + t[0] * (b[0] - a[0]);
+        double C = a[1] + t[1] * (b[1] - a[1]);
+        double H = color::oklch::lerp_hue(a[2], b[2], t[2]);
+        if (crossover == CROSSOVER_BLX || crossover == CROSSOVER_SBX) {
+            clamp_gene(c, &L, &C, &H);
+        }
+
+        mutate_slot(&L, &C, &H, c, mutation_rate, step_scale, rng);
+
+        child[gene * 3 + 0] = L;
+        child[gene * 3 + 1] = C;
+        child[gene * 3 + 2] = H;
+    }
+}
+
+} // namespace ga
+
+#endif // GA_CUH
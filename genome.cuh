@@ -0,0 +1,126 @@
+/**
+ * Genome Layout Module - Free slots only, fixed slots precomputed
+ *
+ * A genome stores OKLCH triples for the free slots only. Fixed slots (black,
+ * br.white, cube corners, fixed semantic colors, ...) carry no genes: their
+ * sRGB, APCA luminance with its exponent powers, and Oklab are converted once
+ * on the host from the exact fixed RGB and copied into the slot array before
+ * the genes are decoded. This avoids the per-individual RGB -> OKLCH -> RGB
+ * round trip, its precision loss, and the genome memory for constant slots.
+ *
+ * Layout:
+ *   gene_slots[g]  slot of gene g (genome[g * 3 .. g * 3 + 2] = L, C, H)
+ *   slot_genes[s]  gene of slot s, -1 if fixed
+ *   fixed[i]       { slot, precomputed SlotColor }
+ */
+
+#ifndef GENOME_CUH
+#define GENOME_CUH
+
+#include <vector>
+
+#include "fitness.cuh"
+
+namespace genome {
+
+// Capacity of the precomputed fixed-slot table (device constant memory)
+constexpr int MAX_FIXED = 64;
+
+struct FixedSlot {
+    int16_t slot;
+    fitness::SlotColor color;
+};
+
+/**
+ * Number of genes (free slots) of a slot table; usable on constexpr tables.
+ */
+constexpr int gene_count(const OklchSlotConstraint* slots, int n_slots) {
+    int n = 0;
+    for (int i = 0; i < n_slots; i++) {
+        if (!slots[i].fixed) n++;
+    }
+    return n;
+}
+
+/**
+ * Fill a slot array from a genome: fixed slots are copied, genes converted.
+ */
+COLOR_FUNC inline void decode(const double* genome, const int16_t* gene_slots, int n_genes,
+                              const FixedSlot* fixed, int n_fixed, fitness::SlotColor* s) {
+    for (int i = 0; i < n_fixed; i++) {
+        s[fixed[i].slot] = fixed[i].color;
+    }
+    for (int g = 0; g < n_genes; g++) {
+        s[gene_slots[g]] = fitness::slot_from_oklch(genome[g * 3 + 0], genome[g * 3 + 1], genome[g * 3 + 2]);
+    }
+}
+
+// =============================================================================
+// Host-side layout
+// =============================================================================
+
+struct Layout {
+    int n_slots;
+    std::vector<int16_t> gene_slots;
+    std::vector<int16_t> slot_genes;
+    std::vector<FixedSlot> fixed;
+
+    int genes() const { return (int)gene_slots.size(); }
+};
+
+inline Layout build_layout(const OklchSlotConstraint* slots, int n_slots) {
+    Layout layout;
+    layout.n_slots = n_slots;
+    layout.slot_genes.assign(n_slots, -1);
+    for (int i = 0; i < n_slots; i++) {
+        const OklchSlotConstraint& c = slots[i];
+        if (c.fixed) {
+            layout.fixed.push_back({(int16_t)i, fitness::slot_from_srgb(c.fixed_r, c.fixed_g, c.fixed_b)});
+        } else {
+            layout.slot_genes[i] = (int16_t)layout.gene_slots.size();
+            layout.gene_slots.push_back((int16_t)i);
+        }
+    }
+    return layout;
+}
+
+inline void decode(const Layout& layout, const double* genome, fitness::SlotColor* s) {
+    decode(genome, layout.gene_slots.data(), layout.genes(),
+           layout.fixed.data(), (int)layout.fixed.size(), s);
+}
+
+/**
+ * Full per-slot OKLCH palette (fixed slots from their exact RGB).
+ */
+inline std::vector<double> expand_oklch(const Layout& layout, const double* genome) {
+    std::vector<double> oklch(layout.n_slots * 3);
+    for (const FixedSlot& f : layout.fixed) {
+        oklch[f.slot * 3 + 0] = f.color.L;
+        oklch[f.slot * 3 + 1] = f.color.C;
+        oklch[f.slot * 3 + 2] = f.color.H;
+    }
+    for (int g = 0; g < layout.genes(); g++) {
+        for (int j = 0; j < 3; j++) oklch[layout.gene_slots[g] * 3 + j] = genome[g * 3 + j];
+    }
+    return oklch;
+}
+
+/**
+ * sRGB palette (0-255) of a genome; fixed slots keep their exact RGB.
+ */
+inline void to_rgb(const Layout& layout, const double* genome, double* rgb) {
+    for (const FixedSlot& f : layout.fixed) {
+        rgb[f.slot * 3 + 0] = f.color.r;
+        rgb[f.slot * 3 + 1] = f.color.g;
+        rgb[f.slot * 3 + 2] = f.color.b;
+    }
+    for (int g = 0; g < layout.genes(); g++) {
+        int s = layout.gene_slots[g];
+        color::oklch_to_srgb(genome[g * 3 + 0], genome[g * 3 + 1], genome[g * 3 + 2],
+                             &rgb[s * 3 + 0], &rgb[s * 3 + 1], &rgb[s * 3 + 2]);
+    }
+}
+
+} // namespace genome
+
+#endif // GENOME_CUH
@@ -18,6 +18,16 @@
  *
  * Build: cmake .. && cmake --build .
  * Run:   ./hexa-color-solver -g 5000 -p 200000
+ *        ./hexa-color-solver -g 5000 -p 200000 --hierarchical   (coarse lattice seeding)
+ *        ./hexa-color-solver -g 5000 -p 200000 --robust         (worst case over display models)
+ *        ./hexa-color-solver -g 5000 -p 200000 --cvd            (color vision deficiency rules)
+ *        ./hexa-color-solver -g 5000 --xterm256                 (full 256-color palette)
+ *        ./hexa-color-solver -g 5000 --semantic palettes/editor.spec  (named editor colors)
+ *        ./hexa-color-solver -g 5000 -p 200000 --dual           (dark + light variants)
+ *        ./hexa-color-solver -g 5000 --snapshot run.snap        (population samples every 100 gens)
+ *        ./hexa-color-solver -g 5000 --seed 7 --cache ~/.cache/hexa  (reuse completed solves)
+ *        ./hexa-color-solver -g 5000 --max-memory 4G            (largest population that fits)
+ *        ./hexa-color-solver -g 5000 --usage mc.usage           (weight pairs by captured usage)
  */
 
 #include <cuda_runtime.h>
@@ -30,109 +40,67 @@
 #include <cerrno>
 #include <climits>
 #include <algorithm>
+#include <numeric>
 #include <vector>
 #include <random>
 #include <sys/stat.h>
 
 #include "color.cuh"
+#include "fitness.cuh"
+#include "genome.cuh"
+#include "ga.cuh"
+#include "hierarchical.hpp"
+#include "decompose.hpp"
+#include "xterm.cuh"
+#include "semantic.cuh"
+#include "dual.cuh"
+#include "rules.cuh"
+#include "quantize.hpp"
+#include "snapshot.hpp"
+#include "solve_cache.hpp"
 #include "output.hpp"
+#include "memory_plan.hpp"
+#include "margins.hpp"
+#include "usage.hpp"
 
 // =============================================================================
-// Color indices
+// Host settings
 // =============================================================================
-enum ColorIndex {
-    BLACK = 0, RED, GREEN, YELLOW, BLUE, MAGENTA, CYAN, WHITE,
-    BR_BLACK, BR_RED, BR_GREEN, BR_YELLOW, BR_BLUE, BR_MAGENTA, BR_CYAN, BR_WHITE
-};
-
-// =============================================================================
-// OKLCH Constraint System
-// =============================================================================
-
-// Slot constraint in OKLCH space
-struct OklchSlotConstraint {
-    double target_hue;      // Target hue in degrees (0-360)
-    double hue_tolerance;   // Allowed hue deviation (+/- degrees)
-    double min_L, max_L;    // Lightness range (0-1)
-    double min_C, max_C;    // Chroma range (0-~0.4)
-    bool fixed;            // Is this a fixed RGB color?
-    double fixed_r, fixed_g, fixed_b;  // Fixed RGB values (0-255)
-    int8_t base_slot;      // For bright colors: base slot index (-1 if none)
-    double max_hue_drift;   // Max hue deviation from base color (degrees, 0 = unlimited)
-};
-
-// APCA pair constraint
-struct ApcaPairConstraint {
-    int8_t fg_index;       // Foreground color index (0-15)
-    int8_t bg_index;       // Background color index (0-15)
-    double min_apca;       // Minimum APCA contrast (absolute value)
-    double target_apca;    // Target APCA for uniformity (0 = no target, just meet minimum)
-};
 
-// OKLCH Hue Reference Values (degrees):
-// Red:     ~29°
-// Yellow:  ~110°
-// Green:   ~142°
-// Cyan:    ~195°
-// Blue:    ~264°
-// Magenta: ~328°
-
-// Slot constraints with reasonable OKLCH defaults
-// Format: target_hue, hue_tolerance, min_L, max_L, min_C, max_C, fixed, fixed_r, fixed_g, fixed_b, base_slot, max_hue_drift
-const OklchSlotConstraint oklch_slot_constraints[16] = {
-    // Base colors (0-7)
-    {   0,   0, 0.00, 0.00, 0.00, 0.00, true,    0,   0,   0, -1,  0},  // 0: BLACK (fixed)
-    {  29,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 1: RED (L max for APCA≥60)
-    { 142,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 2: GREEN
-    { 110,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 3: YELLOW
-    { 264,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 4: BLUE (L max for APCA≥60)
-    { 328,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 5: MAGENTA (L max for APCA)
-    { 195,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 6: CYAN
-    {   0,   0, 0.75, 0.92, 0.00, 0.03, false,   0,   0,   0, -1,  0},  // 7: WHITE (L max for APCA≥85)
-
-    // Bright colors (8-15)
-    {   0,   0, 0.50, 0.60, 0.00, 0.03, false,   0,   0,   0, -1,  0},  // 8: BR_BLACK (L≥0.50 for APCA≥40 on black)
-    {  29,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  1, 20},  // 9: BR_RED (L max for APCA≥80)
-    { 142,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  2, 20},  // 10: BR_GREEN (base=GREEN)
-    { 110,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  3, 20},  // 11: BR_YELLOW (base=YELLOW)
-    { 264,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  4, 20},  // 12: BR_BLUE (L max for APCA≥80)
-    { 328,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  5, 20},  // 13: BR_MAGENTA (L max for APCA≥80)
-    { 195,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  6, 20},  // 14: BR_CYAN (base=CYAN)
-    {   0,   0, 1.00, 1.00, 0.00, 0.00, true,  255, 255, 255, -1,  0},  // 15: BR_WHITE (fixed)
-};
+// Host copy of the CVD settings (0 models = CVD rules disabled)
+color::cvd::Matrix cvd_models[color::cvd::DEFICIENCY_COUNT];
+int cvd_model_count = 0;
 
-// APCA pair constraints: {fg_index, bg_index, min_apca, target_apca}
-// target_apca > 0 enables uniformity optimization within groups
-const ApcaPairConstraint apca_pair_constraints[] = {
-    // Base colors on black - target 50 for uniformity (all should cluster around this value)
-    {RED,        BLACK, 60.0, 65.0},  // red on black
-    {YELLOW,     BLACK, 60.0, 65.0},  // yellow on black
-    {MAGENTA,    BLACK, 60.0, 65.0},  // magenta on black
-
-    {CYAN,       BLACK, 60.0, 60.0},  // cyan on black
-    {GREEN,      BLACK, 50.0, 50.0},  // green on black
-    {BLUE,       BLACK, 30.0, 30.0},  // blue on black
-    {WHITE,      BLACK, 85.0, 85.0},  // white on black
-
-    // Bright colors on black - target 80 for uniformity
-    {BR_RED,     BLACK, 85.0, 85.0},  // br.red on black
-    {BR_YELLOW,  BLACK, 85.0, 85.0},  // br.yellow on black
-    {BR_MAGENTA, BLACK, 85.0, 85.0},  // br.magenta on black
-
-    // might want to lower
-    {BR_GREEN,   BLACK, 85.0, 85.0},  // br.green on black
-    {BR_BLUE,    BLACK, 85.0, 85.0},  // br.blue on black
-    {BR_CYAN,    BLACK, 85.0, 85.0},  // br.cyan on black
-
-    {BR_BLACK,   BLACK, 40.0, 40.0},  // br.black on black (no uniformity target - standalone)
-};
+// Host copy of the usage pair weights (usage_enabled = 0: no --usage)
+double usage_weights[256];
+int usage_enabled = 0;
 
-constexpr int APCA_CONSTRAINT_COUNT = sizeof(apca_pair_constraints) / sizeof(apca_pair_constraints[0]);
+// Host copy of the robust settings (0 models = ideal display only)
+int robust_model_count = 0;
+double robust_quantile = 0.0;
 
 // Device constant memory for OKLCH constraints
-__constant__ OklchSlotConstraint d_oklch_slots[16];
+__constant__ OklchSlotConstraint d_oklch_slots[xterm::SLOTS];  // 16 used unless --xterm256
 __constant__ ApcaPairConstraint d_apca_pairs[64];  // Max 64 pairs
 __constant__ int d_apca_pair_count;
+__constant__ ApcaPairConstraint d_light_pairs[64];
+__constant__ int d_light_pair_count;
+__constant__ color::apca::DisplayModel d_display_models[fitness::MAX_DISPLAY_MODELS];
+__constant__ int d_display_model_count;
+__constant__ double d_robust_quantile;
+__constant__ CvdRule d_cvd_rules[32];
+__constant__ int d_cvd_rule_count;
+__constant__ color::cvd::Matrix d_cvd_models[color::cvd::DEFICIENCY_COUNT];
+__constant__ int d_cvd_model_count;
+__constant__ double d_usage_weights[256];
+__constant__ int d_usage_enabled;
+
+// Genome layout: genes hold free slots only; fixed slots are precomputed
+__constant__ int16_t d_gene_slots[xterm::SLOTS];
+__constant__ int16_t d_slot_genes[xterm::SLOTS];
+__constant__ int d_gene_count;
+__constant__ genome::FixedSlot d_fixed_slots[genome::MAX_FIXED];
+__constant__ int d_fixed_count;
 
 // =============================================================================
 // CUDA Kernels
@@ -145,238 +113,188 @@ __global__ void init_curand(curandState* states, unsigned long seed, int n) {
     }
 }
 
+// curand adapter for the shared GA operators (ga.cuh)
+struct CurandRng {
+    curandState* state;
+    __device__ double uniform() { return (double)curand_uniform(state); }
+    __device__ double normal() { return (double)curand_normal(state); }
+};
+
 /**
  * Initialize population in OKLCH space.
- * Generates random L, C, H values within slot constraints.
- * Clamps chroma to stay in sRGB gamut.
+ * Generates random L, C, H values within slot constraints for every gene
+ * (fixed slots have no genes). Clamps chroma to stay in sRGB gamut.
  */
 __global__ void init_population(double* palettes, curandState* states, int n_palettes) {
     int idx = blockIdx.x * blockDim.x + threadIdx.x;
     if (idx >= n_palettes) return;
 
     curandState localState = states[idx];
+    CurandRng rng = {&localState};
 
-    for (int slot = 0; slot < 16; slot++) {
-        OklchSlotConstraint c = d_oklch_slots[slot];
-        int base = idx * 16 * 3 + slot * 3;
-
-        if (c.fixed) {
-            // Fixed RGB color - convert to OKLCH for storage
-            double L, C, H;
-            color::rgb_to_oklch(c.fixed_r, c.fixed_g, c.fixed_b, &L, &C, &H);
-            palettes[base + 0] = L;
-            palettes[base + 1] = C;
-            palettes[base + 2] = H;
-        } else {
-            // Random OKLCH within constraints
-            double L = c.min_L + (double)curand_uniform(&localState) * (c.max_L - c.min_L);
-            double H = c.target_hue + ((double)curand_uniform(&localState) - 0.5) * 2.0 * c.hue_tolerance;
-            H = color::oklch::normalize_hue(H);
+    for (int gene = 0; gene < d_gene_count; gene++) {
+        size_t base = ((size_t)idx * d_gene_count + gene) * 3;
+        ga::random_gene(d_oklch_slots[d_gene_slots[gene]], rng, &palettes[base]);
+    }
 
-            // Determine chroma range, clamped to gamut
-            double max_C = color::oklch_max_chroma(L, H);
-            double C_min = fmin(c.min_C, max_C);
-            double C_max = fmin(c.max_C, max_C);
+    states[idx] = localState;
+}
 
-            double C = C_min + (double)curand_uniform(&localState) * (C_max - C_min);
+/**
+ * Decode genome idx into per-slot color data (fixed slots are copied).
+ */
+__device__ void decode_genome(const double* palettes, int idx, fitness::SlotColor* slots) {
+    genome::decode(palettes + (size_t)idx * d_gene_count * 3, d_gene_slots, d_gene_count,
+                   d_fixed_slots, d_fixed_count, slots);
+}
 
-            palettes[base + 0] = L;
-            palettes[base + 1] = C;
-            palettes[base + 2] = H;
-        }
+/**
+ * Score converted slots, across the display model batch when robust
+ * evaluation is enabled, plus the CVD rules and usage weights when enabled.
+ */
+__device__ double score_slots(const fitness::SlotColor* slots) {
+    double score;
+    if (d_display_model_count > 0) {
+        score = fitness::robust_palette_score(slots, d_oklch_slots, d_apca_pairs, d_apca_pair_count,
+                                              d_display_models, d_display_model_count, d_robust_quantile);
+    } else {
+        score = fitness::palette_score(slots, d_oklch_slots, d_apca_pairs, d_apca_pair_count);
     }
-
-    states[idx] = localState;
+    if (d_cvd_model_count > 0) {
+        score += fitness::cvd_terms(slots, d_cvd_rules, d_cvd_rule_count, d_cvd_models, d_cvd_model_count);
+    }
+    if (d_usage_enabled) {
+        score += fitness::usage_terms(slots, d_usage_weights);
+    }
+    return score;
 }
 
 /**
  * Evaluate fitness using APCA constraints and OKLCH perceptual metrics.
- * Palettes are in OKLCH space, converted to RGB for APCA evaluation.
+ * Genes are in OKLCH space; each free slot is converted to RGB, APCA
+ * luminance and Oklab once (fixed slots are precomputed), then scored by
+ * fitness::palette_score() (or the robust variant over the display model batch).
  */
-__global__ void evaluate_fitness(double* palettes, double* fitness, int n_palettes) {
+template <int N_SLOTS>
+__global__ void evaluate_fitness(double* palettes, double* fitness, int n_palettes,
+                                 const ApcaPairConstraint* ext_pairs, int ext_pair_count) {
     int idx = blockIdx.x * blockDim.x + threadIdx.x;
     if (idx >= n_palettes) return;
 
-    double score = 0.0;
-    int base = idx * 16 * 3;
-
-    // Convert OKLCH palette to RGB (cache for reuse)
-    double rgb[16][3];
-    for (int i = 0; i < 16; i++) {
-        double L = palettes[base + i * 3 + 0];
-        double C = palettes[base + i * 3 + 1];
-        double H = palettes[base + i * 3 + 2];
-        color::oklch_to_srgb(L, C, H, &rgb[i][0], &rgb[i][1], &rgb[i][2]);
-    }
-
-    // =========================================================================
-    // CONSTRAINT 1: APCA pair constraints (hard requirements + uniformity)
-    // =========================================================================
-    for (int i = 0; i < d_apca_pair_count; i++) {
-        ApcaPairConstraint p = d_apca_pairs[i];
-        int fg = p.fg_index;
-        int bg = p.bg_index;
-
-        double apca = color::apca::contrast_abs(
-            rgb[fg][0], rgb[fg][1], rgb[fg][2],
-            rgb[bg][0], rgb[bg][1], rgb[bg][2]
-        );
+    fitness::SlotColor slots[N_SLOTS];
+    decode_genome(palettes, idx, slots);
 
-        if (apca >= p.min_apca) {
-            // Constraint met - base reward
-            score += 100.0;
-
-            if (p.target_apca > 0.0) {
-                // Uniformity mode: asymmetric penalty (heavier below, lighter above)
-                if (apca < p.target_apca) {
-                    double shortfall = p.target_apca - apca;
-                    score -= shortfall * 3.0;  // Heavy penalty for below target
-                } else {
-                    double excess = apca - p.target_apca;
-                    score -= excess * 1.0;  // Light penalty for exceeding (uniformity)
-                }
-            } else {
-                // No target: reward exceeding minimum (old behavior)
-                score += (apca - p.min_apca) * 5.0;
-            }
-        } else {
-            // Constraint violated - heavy penalty proportional to shortfall
-            score -= (p.min_apca - apca) * 50.0;
-        }
+    double score = score_slots(slots);
+    if (N_SLOTS > 16) {
+        score += xterm::extended_terms(slots, ext_pairs, ext_pair_count);
     }
+    fitness[idx] = score;
+}
 
-    // =========================================================================
-    // CONSTRAINT 2: Hue drift for bright colors (must match base)
-    // =========================================================================
-    for (int slot = 8; slot <= 14; slot++) {
-        OklchSlotConstraint c = d_oklch_slots[slot];
-        if (c.base_slot < 0 || c.max_hue_drift <= 0.0) continue;
-
-        double H_bright = palettes[base + slot * 3 + 2];
-        double H_base = palettes[base + c.base_slot * 3 + 2];
-
-        double hdist = color::hue_distance(H_bright, H_base);
-        if (hdist <= c.max_hue_drift) {
-            score += 30.0;  // Bonus for matching hue
-        } else {
-            score -= (hdist - c.max_hue_drift) * 5.0;  // Penalty for drift
-        }
-    }
+/**
+ * Evaluate dual dark+light genomes (--dual). Light slot constraints live in
+ * d_oklch_slots[16..31].
+ */
+__global__ void evaluate_dual(double* palettes, double* fitness, int n_palettes) {
+    int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= n_palettes) return;
 
-    // =========================================================================
-    // CONSTRAINT 3: Gamut validity
-    // =========================================================================
-    for (int i = 0; i < 16; i++) {
-        double L = palettes[base + i * 3 + 0];
-        double C = palettes[base + i * 3 + 1];
-        double H = palettes[base + i * 3 + 2];
+    fitness::SlotColor slots[dual::SLOTS];
+    dual::convert(&palettes[(size_t)idx * d_gene_count * 3], d_slot_genes,
+                  d_fixed_slots, d_fixed_count, slots);
 
-        if (!color::oklch_in_gamut(L, C, H)) {
-            score -= 500.0;  // Heavy penalty for out-of-gamut
-        }
-    }
+    fitness[idx] = dual::dual_score(slots, d_oklch_slots, d_apca_pairs, d_apca_pair_count,
+                                    d_oklch_slots + dual::LIGHT_BASE, d_light_pairs, d_light_pair_count);
+}
 
-    // =========================================================================
-    // BONUS 1: Hue spacing for base colors (1-6)
-    // Reward evenly spaced hues on the color wheel
-    // =========================================================================
-    {
-        double hues[6];
-        for (int i = 0; i < 6; i++) {
-            hues[i] = palettes[base + (i + 1) * 3 + 2];
-        }
+/**
+ * Evaluate semantic palettes (--semantic). The layout covers the n_used
+ * spec slots; contrast edges come in CSR form grouped by background.
+ */
+template <int N_SLOTS>
+__global__ void evaluate_semantic(double* palettes, double* fitness, int n_palettes, int n_used,
+                                  const int* edge_offsets, const ApcaPairConstraint* edges) {
+    int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= n_palettes) return;
 
-        double min_hue_dist = 360.0;
-        for (int i = 0; i < 6; i++) {
-            for (int j = i + 1; j < 6; j++) {
-                double hdist = color::hue_distance(hues[i], hues[j]);
-                if (hdist < min_hue_dist) {
-                    min_hue_dist = hdist;
-                }
-            }
-        }
+    fitness::SlotColor slots[N_SLOTS];
+    decode_genome(palettes, idx, slots);
 
-        // Ideal minimum spacing for 6 colors is 60° but we accept 40°
-        if (min_hue_dist >= 40.0) {
-            score += min_hue_dist * 2.0;
-        } else {
-            score -= (40.0 - min_hue_dist) * 5.0;
-        }
-    }
-
-    // =========================================================================
-    // BONUS 2: Chroma (prefer more saturated colors)
-    // =========================================================================
-    for (int i = 1; i <= 6; i++) {  // Base colors only
-        double C = palettes[base + i * 3 + 1];
-        score += C * 50.0;  // Small bonus for saturation
-    }
+    fitness[idx] = semantic::semantic_score(slots, n_used, edge_offsets, edges);
+}
 
-    // =========================================================================
-    // BONUS 3: Perceptual distance (Oklab) between base colors
-    // =========================================================================
-    {
-        double min_dist = 1000.0;
-        for (int i = 1; i <= 7; i++) {
-            for (int j = i + 1; j <= 7; j++) {
-                double dist = color::oklab_distance(
-                    rgb[i][0], rgb[i][1], rgb[i][2],
-                    rgb[j][0], rgb[j][1], rgb[j][2]
-                );
-                if (dist < min_dist) {
-                    min_dist = dist;
-                }
-            }
-        }
+/**
+ * Initialize population from the coarse lattice pass (hierarchical mode).
+ * Each free slot starts in one of its top lattice cells, biased toward the
+ * best-ranked ones, and is jittered within the cell so the GA starts from
+ * continuous values. Lattice rows are per slot; fixed slots have no genes.
+ */
+__global__ void init_population_from_lattice(
+    double* palettes, curandState* states, int n_palettes,
+    const double* lattice, const double* cell_size, int top_k
+) {
+    int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= n_palettes) return;
 
-        // Reward good separation (0.15 is noticeable difference)
-        if (min_dist >= 0.15) {
-            score += min_dist * 100.0;
-        } else {
-            score -= (0.15 - min_dist) * 300.0;
-        }
-    }
+    curandState localState = states[idx];
 
-    // =========================================================================
-    // BONUS 4: All other APCA pairs (soft bonus for general readability)
-    // =========================================================================
-    // Small bonus for any pair with good APCA (not covered by constraints)
-    for (int bg = 0; bg < 8; bg++) {
-        for (int fg = 0; fg < 16; fg++) {
-            if (fg == bg) continue;
-            double apca = color::apca::contrast_abs(
-                rgb[fg][0], rgb[fg][1], rgb[fg][2],
-                rgb[bg][0], rgb[bg][1], rgb[bg][2]
-            );
-            if (apca >= 40.0) {
-                score += 1.0;  // Small bonus for readable pairs
-            }
-        }
+    for (int gene = 0; gene < d_gene_count; gene++) {
+        int slot = d_gene_slots[gene];
+        OklchSlotConstraint c = d_oklch_slots[slot];
+        size_t base = ((size_t)idx * d_gene_count + gene) * 3;
+
+        // Quadratic rank bias: half the population draws from the top quarter
+        double u = (double)curand_uniform(&localState);
+        int k = (int)(u * u * top_k);
+        if (k >= top_k) k = top_k - 1;
+        const double* cell = lattice + (slot * top_k + k) * 3;
+        const double* step = cell_size + slot * 3;
+
+        double L = cell[0] + ((double)curand_uniform(&localState) - 0.5) * step[0];
+        double C = cell[1] + ((double)curand_uniform(&localState) - 0.5) * step[1];
+        double H = cell[2] + ((double)curand_uniform(&localState) - 0.5) * step[2];
+        H = color::oklch::normalize_hue(H);
+
+        if (L < c.min_L) L = c.min_L;
+        if (L > c.max_L) L = c.max_L;
+
+        // Clamp chroma to constraint range and gamut
+        double max_C = color::oklch_max_chroma(L, H);
+        if (C < c.min_C) C = c.min_C;
+        if (C > c.max_C) C = c.max_C;
+        if (C > max_C) C = max_C;
+
+        palettes[base + 0] = L;
+        palettes[base + 1] = C;
+        palettes[base + 2] = H;
     }
 
-    fitness[idx] = score;
+    states[idx] = localState;
 }
 
 /**
  * Crossover and mutation in OKLCH space.
- * Uses circular interpolation for hue.
+ * crossover selects the operator (ga::Crossover); hues are interpolated
+ * circularly. step_scale multiplies the mutation step (1.0 = normal; hierarchical mode
+ * shrinks it stage by stage).
  */
 __global__ void crossover_and_mutate(
     double* old_pop, double* new_pop, double* fitness,
     int* elite_indices, int elite_count,
-    curandState* states, double mutation_rate, int n_palettes
+    curandState* states, int crossover, double mutation_rate, double step_scale, int n_palettes
 ) {
     int idx = blockIdx.x * blockDim.x + threadIdx.x;
     if (idx >= n_palettes) return;
 
     curandState localState = states[idx];
-    int new_base = idx * 16 * 3;
+    int stride = d_gene_count * 3;
+    size_t new_base = (size_t)idx * stride;
 
     // Elite: copy directly
     if (idx < elite_count) {
         int old_idx = elite_indices[idx];
-        int old_base = old_idx * 16 * 3;
-        for (int i = 0; i < 48; i++) {
+        size_t old_base = (size_t)old_idx * stride;
+        for (int i = 0; i < stride; i++) {
             new_pop[new_base + i] = old_pop[old_base + i];
         }
         states[idx] = localState;
@@ -384,106 +302,210 @@ __global__ void crossover_and_mutate(
     }
 
     // Tournament selection for parents
-    int p1_idx = elite_indices[(int)((double)curand_uniform(&localState) * elite_count)];
-    int p2_idx = elite_indices[(int)((double)curand_uniform(&localState) * elite_count)];
+    CurandRng rng = {&localState};
+    int p1_idx = elite_indices[ga::pick(elite_count, rng)];
+    int p2_idx = elite_indices[ga::pick(elite_count, rng)];
 
-    int p1_base = p1_idx * 16 * 3;
-    int p2_base = p2_idx * 16 * 3;
+    // Crossover and mutate each gene (free slot)
+    ga::breed(&old_pop[(size_t)p1_idx * stride], &old_pop[(size_t)p2_idx * stride], &new_pop[new_base],
+              d_gene_slots, d_gene_count, d_oklch_slots, crossover, mutation_rate, step_scale, rng);
 
-    // Crossover and mutate each color slot
-    for (int slot = 0; slot < 16; slot++) {
-        OklchSlotConstraint c = d_oklch_slots[slot];
-        int offset = slot * 3;
+    states[idx] = localState;
+}
 
-        if (c.fixed) {
-            // Fixed color - convert from RGB
-            double L, C, H;
-            color::rgb_to_oklch(c.fixed_r, c.fixed_g, c.fixed_b, &L, &C, &H);
-            new_pop[new_base + offset + 0] = L;
-            new_pop[new_base + offset + 1] = C;
-            new_pop[new_base + offset + 2] = H;
-        } else {
-            // Crossover: blend or select
-            double L1 = old_pop[p1_base + offset + 0];
-            double C1 = old_pop[p1_base + offset + 1];
-            double H1 = old_pop[p1_base + offset + 2];
-            double L2 = old_pop[p2_base + offset + 0];
-            double C2 = old_pop[p2_base + offset + 1];
-            double H2 = old_pop[p2_base + offset + 2];
-
-            double t = (double)curand_uniform(&localState);
-            double L = L1 + t * (L2 - L1);
-            double C = C1 + t * (C2 - C1);
-            double H = color::oklch::lerp_hue(H1, H2, t);
-
-            // Mutation
-            if ((double)curand_uniform(&localState) < mutation_rate) {
-                // Mutate L
-                double L_range = c.max_L - c.min_L;
-                L += (double)curand_normal(&localState) * L_range * 0.1;
-                if (L < c.min_L) L = c.min_L;
-                if (L > c.max_L) L = c.max_L;
-            }
+/**
+ * Block-coordinate refinement: parallel sub-solves over slot groups.
+ * Thread idx works on group idx / per_group. It copies the current best
+ * genome, perturbs only that group's slots (every coordinate, at the group's
+ * step scale) and scores the full palette. All groups are searched in the
+ * same launch; the host picks the best candidate per group.
+ */
+__global__ void refine_groups(
+    const double* best, double* candidates, double* fitness,
+    const int* group_offsets, const int* group_slots, const double* group_scale,
+    int n_groups, int per_group, curandState* states
+) {
+    int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= n_groups * per_group) return;
 
-            if ((double)curand_uniform(&localState) < mutation_rate) {
-                // Mutate H (circular)
-                H += (double)curand_normal(&localState) * c.hue_tolerance * 0.3;
-                H = color::oklch::normalize_hue(H);
-
-                // Clamp to constraint range
-                double target = c.target_hue;
-                double hdist = color::hue_distance(H, target);
-                if (hdist > c.hue_tolerance) {
-                    // Push back toward valid range
-                    double t_factor = c.hue_tolerance / hdist;
-                    H = color::oklch::lerp_hue(target, H, t_factor);
-                }
-            }
+    curandState localState = states[idx];
+    CurandRng rng = {&localState};
+    int g = idx / per_group;
+    int stride = d_gene_count * 3;
 
-            if ((double)curand_uniform(&localState) < mutation_rate) {
-                // Mutate C
-                double C_range = c.max_C - c.min_C;
-                C += (double)curand_normal(&localState) * C_range * 0.15;
+    double* cand = candidates + (size_t)idx * stride;
+    for (int i = 0; i < stride; i++) {
+        cand[i] = best[i];
+    }
 
-                // Clamp to constraint range and gamut
-                double max_C = color::oklch_max_chroma(L, H);
-                if (C < c.min_C) C = c.min_C;
-                if (C > c.max_C) C = c.max_C;
-                if (C > max_C) C = max_C;
-            }
+    for (int k = group_offsets[g]; k < group_offsets[g + 1]; k++) {
+        int slot = group_slots[k];
+        int gene = d_slot_genes[slot];
+        OklchSlotConstraint c = d_oklch_slots[slot];
+        ga::mutate_slot(&cand[gene * 3 + 0], &cand[gene * 3 + 1], &cand[gene * 3 + 2],
+                        c, 1.0, group_scale[g], rng);
+    }
 
-            // Ensure gamut validity
-            double max_C = color::oklch_max_chroma(L, H);
-            if (C > max_C) C = max_C;
+    fitness::SlotColor slots[16];
+    decode_genome(candidates, idx, slots);
+    fitness[idx] = score_slots(slots);
 
-            new_pop[new_base + offset + 0] = L;
-            new_pop[new_base + offset + 1] = C;
-            new_pop[new_base + offset + 2] = H;
-        }
+    states[idx] = localState;
+}
+
+/**
+ * Score converted ANSI slots on the host (same math as score_slots).
+ */
+double host_slots_fitness(const fitness::SlotColor* slots) {
+    double score;
+    if (robust_model_count > 0) {
+        score = fitness::robust_palette_score(slots, oklch_slot_constraints, apca_pair_constraints,
+                                              APCA_CONSTRAINT_COUNT, display_models,
+                                              robust_model_count, robust_quantile);
+    } else {
+        score = fitness::palette_score(slots, oklch_slot_constraints, apca_pair_constraints, APCA_CONSTRAINT_COUNT);
+    }
+    if (cvd_model_count > 0) {
+        score += fitness::cvd_terms(slots, cvd_rules, CVD_RULE_COUNT, cvd_models, cvd_model_count);
     }
+    if (usage_enabled) {
+        score += fitness::usage_terms(slots, usage_weights);
+    }
+    return score;
+}
 
-    states[idx] = localState;
+/**
+ * Score a single 16-slot genome on the host (same math as evaluate_fitness).
+ */
+double host_palette_fitness(const genome::Layout& layout, const double* genes) {
+    fitness::SlotColor slots[16];
+    genome::decode(layout, genes, slots);
+    return host_slots_fitness(slots);
+}
+
+/**
+ * Print each CVD rule's simulated Oklab distance / APCA per deficiency.
+ */
+void print_cvd_report(const double* rgb, const char** names) {
+    const char* deficiency_names[] = {"protan", "deutan", "tritan"};
+
+    printf("\nColor vision deficiency rules:\n");
+    printf("  %-24s %-8s %10s %10s\n", "Pair", "Type", "Distance", "APCA");
+    for (int i = 0; i < CVD_RULE_COUNT; i++) {
+        const CvdRule& rule = cvd_rules[i];
+        for (int d = 0; d < color::cvd::DEFICIENCY_COUNT; d++) {
+            if (!(rule.deficiency_mask & (1 << d))) continue;
+            double ar, ag, ab, br, bg, bb;
+            const double* a = &rgb[rule.a_index * 3];
+            const double* b = &rgb[rule.b_index * 3];
+            color::cvd::simulate_srgb(a[0], a[1], a[2], cvd_models[d], &ar, &ag, &ab);
+            color::cvd::simulate_srgb(b[0], b[1], b[2], cvd_models[d], &br, &bg, &bb);
+            double dist = color::oklab::distance(ar, ag, ab, br, bg, bb);
+            double apca = color::apca::contrast_abs(ar, ag, ab, br, bg, bb);
+            bool ok = dist >= rule.min_distance && apca >= rule.min_apca;
+
+            char label[32];
+            snprintf(label, sizeof(label), "%s / %s", names[rule.a_index], names[rule.b_index]);
+            printf("  %-24s %-8s %10.3f %10.1f  %s\n", label, deficiency_names[d], dist, apca,
+                   ok ? "\033[32m✓\033[0m" : "\033[31m✗\033[0m");
+        }
+    }
 }
 
 /**
- * Convert OKLCH palette to RGB (for output/display).
- * Single palette conversion on host side.
+ * Print the worst APCA contrast of each pair constraint across the display models.
  */
-void oklch_palette_to_rgb(double* oklch_palette, double* rgb_palette) {
+void print_robust_report(const double* rgb, const char** names) {
+    double Y[16][fitness::MAX_DISPLAY_MODELS];
     for (int i = 0; i < 16; i++) {
-        const OklchSlotConstraint& c = oklch_slot_constraints[i];
-        if (c.fixed) {
-            // Use exact fixed RGB values to avoid OKLCH round-trip precision loss
-            rgb_palette[i * 3 + 0] = c.fixed_r;
-            rgb_palette[i * 3 + 1] = c.fixed_g;
-            rgb_palette[i * 3 + 2] = c.fixed_b;
+        color::apca::luminance_batch(rgb[i * 3 + 0], rgb[i * 3 + 1], rgb[i * 3 + 2],
+                                     display_models, DISPLAY_MODEL_COUNT, Y[i]);
+    }
+
+    printf("\nWorst-case APCA across %d display models:\n", DISPLAY_MODEL_COUNT);
+    printf("  %-24s %8s %8s %8s\n", "Pair", "Min Lc", "Worst", "Ideal");
+    for (int i = 0; i < APCA_CONSTRAINT_COUNT; i++) {
+        const ApcaPairConstraint& p = apca_pair_constraints[i];
+        double worst = 1e9, ideal = 0.0;
+        for (int m = 0; m < DISPLAY_MODEL_COUNT; m++) {
+            double lc = fabs(color::apca::contrast_y(Y[p.fg_index][m], Y[p.bg_index][m]));
+            if (lc < worst) worst = lc;
+            if (display_models[m].gamma == 2.4 && display_models[m].black_lift == 0.0 &&
+                display_models[m].white_scale == 1.0) ideal = lc;
+        }
+        char label[32];
+        snprintf(label, sizeof(label), "%s on %s", names[p.fg_index], names[p.bg_index]);
+        printf("  %-24s %8.1f %s%8.1f\033[0m %8.1f\n", label, p.min_apca,
+               worst >= p.min_apca ? "\033[32m" : "\033[31m", worst, ideal);
+    }
+}
+
+/**
+ * Summarize the extended slots in 256-color mode: cube step evenness,
+ * grey ramp steps and the sparse contrast rules.
+ */
+void print_xterm_report(const double* rgb, const std::vector<ApcaPairConstraint>& pairs) {
+    std::vector<fitness::SlotColor> s(xterm::SLOTS);
+    for (int i = 0; i < xterm::SLOTS; i++) {
+        s[i] = fitness::slot_from_srgb(rgb[i * 3 + 0], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+    }
+
+    int met = 0;
+    double worst_shortfall = 0.0;
+    for (const ApcaPairConstraint& p : pairs) {
+        double apca = fitness::pair_contrast(p, s[p.fg_index].lum, s[p.bg_index].lum);
+        if (apca >= p.min_apca) {
+            met++;
         } else {
-            double L = oklch_palette[i * 3 + 0];
-            double C = oklch_palette[i * 3 + 1];
-            double H = oklch_palette[i * 3 + 2];
-            color::oklch_to_srgb(L, C, H, &rgb_palette[i * 3 + 0], &rgb_palette[i * 3 + 1], &rgb_palette[i * 3 + 2]);
+            worst_shortfall = fmax(worst_shortfall, p.min_apca - apca);
         }
     }
+
+    double min_dL = 1.0, max_dL = 0.0;
+    for (int i = xterm::GREY_BASE; i < xterm::GREY_BASE + xterm::GREY_STEPS - 1; i++) {
+        double dL = s[i + 1].lab.L - s[i].lab.L;
+        min_dL = fmin(min_dL, dL);
+        max_dL = fmax(max_dL, dL);
+    }
+
+    printf("\nExtended slots (16-255):\n");
+    printf("  Cube uniformity penalty: %.2f\n", xterm::cube_uniformity_score(s.data()));
+    printf("  Grey ramp ΔL: %.4f - %.4f (penalty %.2f)\n",
+           min_dL, max_dL, xterm::grey_ramp_score(s.data()));
+    printf("  Contrast rules met: %d/%zu", met, pairs.size());
+    if (met < (int)pairs.size()) {
+        printf(" (worst shortfall %.1f Lc)", worst_shortfall);
+    }
+    printf("\n");
+}
+
+/**
+ * Print the light variant's APCA rules (signed Lc) and the dark/light
+ * lightness of each shared-hue slot.
+ */
+void print_dual_report(const double* rgb, const char** names) {
+    const double* light = rgb + dual::LIGHT_BASE * 3;
+
+    printf("\nLight variant APCA (normal polarity, Lc > 0):\n");
+    for (int i = 0; i < LIGHT_APCA_CONSTRAINT_COUNT; i++) {
+        const ApcaPairConstraint& p = light_apca_pair_constraints[i];
+        const double* fg = &light[p.fg_index * 3];
+        const double* bg = &light[p.bg_index * 3];
+        double lc = color::apca::contrast(fg[0], fg[1], fg[2], bg[0], bg[1], bg[2]);
+        char label[32];
+        snprintf(label, sizeof(label), "%s on %s", names[p.fg_index], names[p.bg_index]);
+        printf("  %-24s Lc=%6.1f (min %.0f)  %s\n", label, lc, p.min_apca,
+               lc * p.polarity >= p.min_apca ? "\033[32m✓\033[0m" : "\033[31m✗\033[0m");
+    }
+
+    printf("\nShared hues (dark / light):\n");
+    for (int i = 0; i < 16; i++) {
+        if (!dual::hue_shared(i)) continue;
+        color::oklch::LCH d = color::oklch::from_srgb(rgb[i * 3 + 0], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        color::oklch::LCH l = color::oklch::from_srgb(light[i * 3 + 0], light[i * 3 + 1], light[i * 3 + 2]);
+        printf("  %-12s H=%5.1f° / %5.1f°  L=%.3f / %.3f  C=%.3f / %.3f\n",
+               names[i], d.H, l.H, d.L, l.L, d.C, l.C);
+    }
 }
 
 // =============================================================================
@@ -607,12 +629,272 @@ void print_color_demo(double* palette) {
     }
 }
 
+// =============================================================================
+// GA Driver
+// =============================================================================
+
+// Device buffers shared by a GA run
+struct GaBuffers {
+    double* d_pop1;
+    double* d_pop2;
+    double* d_fitness;
+    int* d_elite_indices;
+    curandState* d_states;
+};
+
+struct GaResult {
+    std::vector<double> best_palette;  // genome: OKLCH per gene, n_genes * 3
+    double best_fitness;
+    int best_generation;
+};
+
+/**
+ * Run the generation loop on the initialized population in buf.d_pop1
+ * (n_genes OKLCH triples per genome, layout already uploaded).
+ * evaluate(d_pop) launches the fitness kernel for that population into
+ * buf.d_fitness. The mutation step halves over `stages` equal stages
+ * (1 = constant step). The final population is left in buf.d_pop1.
+ * If snapshots is open, a strided population sample is staged for it on
+ * each due generation; decoding and writing happen on its own thread.
+ */
+template <typename Evaluate>
+GaResult evolve(GaBuffers& buf, int n_genes, const ga::Params& params, int generations,
+                int stages, snapshot::Writer* snapshots, Evaluate evaluate) {
+    int population_size = params.population;
+    int elite_count = ga::elite_count(params);
+    int blockSize = 256;
+    int numBlocks = (population_size + blockSize - 1) / blockSize;
+
+    // Host arrays for elite selection
+    std::vector<double> h_fitness(population_size);
+    std::vector<int> h_elite_indices(elite_count);
+
+    // Best-ever tracking (don't rely solely on elitism)
+    GaResult result;
+    result.best_fitness = -1e9;
+    result.best_palette.assign(n_genes * 3, 0.0);
+    result.best_generation = 0;
+
+    int stagnant_generations = 0;
+    double current_mutation = params.mutation_rate;
+
+    printf("Starting evolution...\n\n");
+
+    for (int gen = 0; gen < generations; gen++) {
+        // Evaluate fitness
+        evaluate(buf.d_pop1);
+        cudaDeviceSynchronize();
+
+        // Copy fitness to host
+        cudaMemcpy(h_fitness.data(), buf.d_fitness, population_size * sizeof(double), cudaMemcpyDeviceToHost);
+
+        // Find elite indices
+        std::vector<int> indices(population_size);
+        for (int i = 0; i < population_size; i++) indices[i] = i;
+
+        std::partial_sort(indices.begin(), indices.begin() + elite_count, indices.end(),
+            [&h_fitness](int a, int b) { return h_fitness[a] > h_fitness[b]; });
+
+        for (int i = 0; i < elite_count; i++) {
+            h_elite_indices[i] = indices[i];
+        }
+
+        double gen_best = h_fitness[indices[0]];
+
+        // Population snapshot: one strided copy into staging, written off-thread
+        if (snapshots && snapshots->due(gen)) {
+            snapshot::Staging* staged = snapshots->acquire();
+            size_t row_bytes = (size_t)n_genes * 3 * sizeof(double);
+            cudaMemcpy2D(staged->genomes.data(), row_bytes, buf.d_pop1, row_bytes * snapshots->step(),
+                         row_bytes, snapshots->rows(), cudaMemcpyDeviceToHost);
+            for (int i = 0; i < snapshots->rows(); i++) {
+                staged->fitness[i] = h_fitness[staged->ids[i]];
+            }
+            snapshots->submit(staged, gen);
+        }
+
+        // Track best-ever palette
+        if (gen_best > result.best_fitness) {
+            result.best_fitness = gen_best;
+            result.best_generation = gen;
+            // Save the best palette from device
+            int best_idx = indices[0];
+            cudaMemcpy(result.best_palette.data(), buf.d_pop1 + (size_t)best_idx * n_genes * 3,
+                       n_genes * 3 * sizeof(double), cudaMemcpyDeviceToHost);
+            stagnant_generations = 0;
+        } else {
+            stagnant_generations++;
+        }
+        current_mutation = ga::next_mutation(params, current_mutation, stagnant_generations);
+
+        // Progress output
+        if (gen % 500 == 0 || gen == generations - 1) {
+            printf("Gen %5d: best=%.2f, avg=%.2f, mutation=%.3f\n",
+                   gen, gen_best,
+                   std::accumulate(h_fitness.begin(), h_fitness.end(), 0.0) / population_size,
+                   current_mutation);
+        }
+
+        if (gen < generations - 1) {
+            // Copy elite indices to device
+            cudaMemcpy(buf.d_elite_indices, h_elite_indices.data(), elite_count * sizeof(int), cudaMemcpyHostToDevice);
+
+            // Crossover and mutation (finer steps per stage in hierarchical mode)
+            double step_scale = hierarchical::step_scale(gen, generations, stages);
+            crossover_and_mutate<<<numBlocks, blockSize>>>(
+                buf.d_pop1, buf.d_pop2, buf.d_fitness, buf.d_elite_indices, elite_count,
+                buf.d_states, params.crossover, current_mutation, step_scale, population_size
+            );
+            cudaDeviceSynchronize();
+
+            // Swap populations
+            std::swap(buf.d_pop1, buf.d_pop2);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * cudaMalloc that reports a failure instead of leaving *ptr unset.
+ */
+template <typename T>
+bool device_alloc(T** ptr, size_t bytes, const char* what) {
+    cudaError_t err = cudaMalloc(ptr, bytes);
+    if (err != cudaSuccess) {
+        printf("Error: cudaMalloc of %s (%.1f MiB) failed: %s\n", what, memory_plan::mib(bytes),
+               cudaGetErrorString(err));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Slot groups of the ANSI rule graph for --decompose (with the CVD rules'
+ * edges under --cvd).
+ */
+decompose::SlotGroups ansi_slot_groups(bool cvd) {
+    decompose::SlotGraph graph = decompose::build_slot_graph(
+        oklch_slot_constraints, 16, apca_pair_constraints, APCA_CONSTRAINT_COUNT);
+    if (cvd) {
+        decompose::add_cvd_edges(graph, cvd_rules, CVD_RULE_COUNT);
+    }
+    return decompose::find_groups(graph, oklch_slot_constraints);
+}
+
+/**
+ * Upload a genome layout and its precomputed fixed slots to the device.
+ * Returns false if the layout has more fixed slots than genome::MAX_FIXED.
+ */
+bool upload_layout(const genome::Layout& layout) {
+    int n_genes = layout.genes();
+    int n_fixed = (int)layout.fixed.size();
+    if (n_fixed > genome::MAX_FIXED) {
+        printf("Error: %d fixed slots (max %d)\n", n_fixed, genome::MAX_FIXED);
+        return false;
+    }
+    cudaMemcpyToSymbol(d_gene_slots, layout.gene_slots.data(), n_genes * sizeof(int16_t));
+    cudaMemcpyToSymbol(d_slot_genes, layout.slot_genes.data(), layout.n_slots * sizeof(int16_t));
+    cudaMemcpyToSymbol(d_gene_count, &n_genes, sizeof(int));
+    cudaMemcpyToSymbol(d_fixed_slots, layout.fixed.data(), n_fixed * sizeof(genome::FixedSlot));
+    cudaMemcpyToSymbol(d_fixed_count, &n_fixed, sizeof(int));
+    return true;
+}
+
+/**
+ * Solve a semantic palette with the GA engine and write it next to the theme.
+ * Reuses the fitness, elite and RNG buffers of the main run (same population).
+ */
+void solve_semantic(semantic::Spec& spec, const double* ansi_rgb, GaBuffers main_buf,
+                    const ga::Params& params, int generations,
+                    int polish_radius, int polish_restarts, const char* output_file) {
+    constexpr int N = semantic::MAX_SLOTS;
+    int population_size = params.population;
+    int n_used = (int)spec.names.size();
+
+    semantic::resolve_ansi(&spec, ansi_rgb);
+    semantic::EdgeGraph graph = semantic::build_edge_graph(spec);
+    genome::Layout layout = genome::build_layout(spec.slots.data(), n_used);
+
+    printf("\nSemantic palette: %d slots (%d free), %zu contrast edges\n",
+           n_used, layout.genes(), graph.edges.size());
+
+    cudaMemcpyToSymbol(d_oklch_slots, spec.slots.data(), n_used * sizeof(OklchSlotConstraint));
+    if (!upload_layout(layout)) return;
+
+    int* d_offsets = NULL;
+    ApcaPairConstraint* d_edges = NULL;
+    GaBuffers buf = main_buf;
+    buf.d_pop1 = buf.d_pop2 = NULL;
+    size_t palette_size = (size_t)population_size * layout.genes() * 3 * sizeof(double);
+    if (!device_alloc(&d_offsets, graph.offsets.size() * sizeof(int), "semantic edge offsets") ||
+        !device_alloc(&d_edges, (graph.edges.size() + 1) * sizeof(ApcaPairConstraint), "semantic edges") ||
+        !device_alloc(&buf.d_pop1, palette_size, "semantic population") ||
+        !device_alloc(&buf.d_pop2, palette_size, "semantic offspring")) {
+        cudaFree(buf.d_pop1);
+        cudaFree(d_edges);
+        cudaFree(d_offsets);
+        return;
+    }
+    cudaMemcpy(d_offsets, graph.offsets.data(), graph.offsets.size() * sizeof(int), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_edges, graph.edges.data(), graph.edges.size() * sizeof(ApcaPairConstraint), cudaMemcpyHostToDevice);
+
+    int blockSize = 256;
+    int numBlocks = (population_size + blockSize - 1) / blockSize;
+    init_population<<<numBlocks, blockSize>>>(buf.d_pop1, buf.d_states, population_size);
+    cudaDeviceSynchronize();
+
+    GaResult result = evolve(buf, layout.genes(), params, generations, 1, nullptr, [&](double* pop) {
+        evaluate_semantic<N><<<numBlocks, blockSize>>>(
+            pop, buf.d_fitness, population_size, n_used, d_offsets, d_edges);
+    });
+
+    std::vector<double> rgb(n_used * 3);
+    genome::to_rgb(layout, result.best_palette.data(), rgb.data());
+
+    quantize::Result quantized = quantize::polish(
+        rgb.data(), n_used, layout.gene_slots, polish_radius, polish_restarts,
+        [&](const fitness::SlotColor* s) {
+            return semantic::semantic_score(s, n_used, graph.offsets.data(), graph.edges.data());
+        });
+    rgb = quantized.rgb;
+
+    // Rule report
+    int met = 0;
+    for (const ApcaPairConstraint& r : spec.rules) {
+        const double* fg = &rgb[r.fg_index * 3];
+        const double* bg = &rgb[r.bg_index * 3];
+        double lc = color::apca::contrast_abs(fg[0], fg[1], fg[2], bg[0], bg[1], bg[2]);
+        if (lc >= r.min_apca) {
+            met++;
+        } else {
+            printf("  \033[31m✗\033[0m %s on %s: Lc %.1f < %.1f\n",
+                   spec.names[r.fg_index].c_str(), spec.names[r.bg_index].c_str(), lc, r.min_apca);
+        }
+    }
+    printf("  Rules met: %d/%zu (fitness=%.2f, 8-bit %.2f)\n", met, spec.rules.size(),
+           result.best_fitness, quantized.score);
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s.semantic", output_file);
+    if (semantic::write_palette_file(spec, rgb.data(), path)) {
+        printf("\n✓ Semantic palette written to: %s\n", path);
+    }
+
+    cudaFree(buf.d_pop1);
+    cudaFree(buf.d_pop2);
+    cudaFree(d_offsets);
+    cudaFree(d_edges);
+}
+
 // =============================================================================
 // Main
 // =============================================================================
 
 // Write theme to file
-void write_theme_file(double* palette, const char* filepath) {
+// bg_slot / fg_slot pick the theme background and foreground (dark: black on
+// white text; light: br.white background with black text)
+void write_theme_file(double* palette, int n_slots, int bg_slot, int fg_slot, const char* filepath) {
     FILE* f = fopen(filepath, "w");
     if (!f) {
         printf("Error: Could not open %s for writing: %s\n", filepath, strerror(errno));
@@ -621,39 +903,40 @@ void write_theme_file(double* palette, const char* filepath) {
 
     fprintf(f, "# OKLCH + APCA Optimized Terminal Theme\n");
     fprintf(f, "# Generated by Hexa Color Solver v3.0\n");
-    fprintf(f, "# APCA contrast: Lc>=40 on black, perceptually uniform hues\n");
+    fprintf(f, "# APCA contrast: Lc>=40 on %s, perceptually uniform hues\n",
+            bg_slot == BLACK ? "black" : "white");
     fprintf(f, "#\n\n");
 
-    // Palette
-    for (int i = 0; i < 16; i++) {
-        int r = (int)palette[i * 3 + 0];
-        int g = (int)palette[i * 3 + 1];
-        int b = (int)palette[i * 3 + 2];
+    // Palette (channels rounded to the nearest byte, not truncated)
+    for (int i = 0; i < n_slots; i++) {
+        int r = quantize::channel_byte(palette[i * 3 + 0]);
+        int g = quantize::channel_byte(palette[i * 3 + 1]);
+        int b = quantize::channel_byte(palette[i * 3 + 2]);
         fprintf(f, "palette = %d=#%02x%02x%02x\n", i, r, g, b);
     }
 
     // Background/foreground
-    int bg_r = (int)palette[BLACK * 3 + 0];
-    int bg_g = (int)palette[BLACK * 3 + 1];
-    int bg_b = (int)palette[BLACK * 3 + 2];
-    int fg_r = (int)palette[WHITE * 3 + 0];
-    int fg_g = (int)palette[WHITE * 3 + 1];
-    int fg_b = (int)palette[WHITE * 3 + 2];
+    int bg_r = quantize::channel_byte(palette[bg_slot * 3 + 0]);
+    int bg_g = quantize::channel_byte(palette[bg_slot * 3 + 1]);
+    int bg_b = quantize::channel_byte(palette[bg_slot * 3 + 2]);
+    int fg_r = quantize::channel_byte(palette[fg_slot * 3 + 0]);
+    int fg_g = quantize::channel_byte(palette[fg_slot * 3 + 1]);
+    int fg_b = quantize::channel_byte(palette[fg_slot * 3 + 2]);
 
     fprintf(f, "\nbackground = #%02x%02x%02x\n", bg_r, bg_g, bg_b);
     fprintf(f, "foreground = #%02x%02x%02x\n", fg_r, fg_g, fg_b);
 
     // Cursor (bright yellow)
-    int cursor_r = (int)palette[BR_YELLOW * 3 + 0];
-    int cursor_g = (int)palette[BR_YELLOW * 3 + 1];
-    int cursor_b = (int)palette[BR_YELLOW * 3 + 2];
+    int cursor_r = quantize::channel_byte(palette[BR_YELLOW * 3 + 0]);
+    int cursor_g = quantize::channel_byte(palette[BR_YELLOW * 3 + 1]);
+    int cursor_b = quantize::channel_byte(palette[BR_YELLOW * 3 + 2]);
     fprintf(f, "\ncursor-color = #%02x%02x%02x\n", cursor_r, cursor_g, cursor_b);
     fprintf(f, "cursor-text = #%02x%02x%02x\n", bg_r, bg_g, bg_b);
 
     // Selection (blue background)
-    int sel_r = (int)palette[BLUE * 3 + 0];
-    int sel_g = (int)palette[BLUE * 3 + 1];
-    int sel_b = (int)palette[BLUE * 3 + 2];
+    int sel_r = quantize::channel_byte(palette[BLUE * 3 + 0]);
+    int sel_g = quantize::channel_byte(palette[BLUE * 3 + 1]);
+    int sel_b = quantize::channel_byte(palette[BLUE * 3 + 2]);
     fprintf(f, "\nselection-background = #%02x%02x%02x\n", sel_r, sel_g, sel_b);
     fprintf(f, "selection-foreground = #ffffff\n");
 
@@ -672,31 +955,146 @@ void write_theme_file(double* palette, const char* filepath) {
 }
 
 int main(int argc, char** argv) {
-    int population_size = 200000;
+    ga::Params params = ga::default_params(200000);
     int generations = 5000;
-    double mutation_rate = 0.15;
-    double elite_ratio = 0.1;
+    bool hierarchical_mode = false;
+    int lattice_levels = 16;
+    int lattice_top_k = 64;
+    int refine_stages = 4;
+    bool decompose_mode = false;
+    int bcd_rounds = 200;
+    bool robust_mode = false;
+    bool cvd_mode = false;
+    double cvd_severity = 1.0;
+    bool xterm_mode = false;
+    bool dual_mode = false;
+    bool population_set = false;
+    int polish_radius = 2;
+    int polish_restarts = 8;
+    const char* snapshot_file = NULL;
+    int snapshot_every = 100;
+    int snapshot_rows = 1024;
+    unsigned long seed = (unsigned long)time(NULL);
+    bool seed_set = false;
+    size_t max_memory = 0;
+    const char* cache_dir = getenv("HEXA_CACHE");
+    const char* semantic_file = NULL;
+    const char* usage_file = NULL;
     const char* output_file = NULL;
     char default_output[256];
 
     // Parse args
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--population") == 0 || strcmp(argv[i], "-p") == 0) {
-            population_size = atoi(argv[++i]);
+            params.population = atoi(argv[++i]);
+            population_set = true;
         } else if (strcmp(argv[i], "--generations") == 0 || strcmp(argv[i], "-g") == 0) {
             generations = atoi(argv[++i]);
         } else if (strcmp(argv[i], "--mutation") == 0 || strcmp(argv[i], "-m") == 0) {
-            mutation_rate = atof(argv[++i]);
+            params.mutation_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--elite-ratio") == 0) {
+            params.elite_ratio = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--crossover") == 0) {
+            const char* name = argv[++i];
+            params.crossover = ga::crossover_from_name(name);
+            if (params.crossover < 0) {
+                printf("Error: unknown crossover '%s' (blend, uniform, blx, sbx, group)\n", name);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--params") == 0) {
+            // Tuned parameter set (hexa-autotune); later flags override it.
+            // Only a population written into the file by hand counts as set.
+            int population = params.population;
+            if (!ga::load_params(argv[++i], &params)) {
+                return 1;
+            }
+            population_set = population_set || params.population != population;
         } else if (strcmp(argv[i], "--output") == 0 || strcmp(argv[i], "-o") == 0) {
             output_file = argv[++i];
+        } else if (strcmp(argv[i], "--hierarchical") == 0) {
+            hierarchical_mode = true;
+        } else if (strcmp(argv[i], "--levels") == 0) {
+            lattice_levels = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--top-k") == 0) {
+            lattice_top_k = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stages") == 0) {
+            refine_stages = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--decompose") == 0) {
+            decompose_mode = true;
+        } else if (strcmp(argv[i], "--bcd-rounds") == 0) {
+            bcd_rounds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--robust") == 0) {
+            robust_mode = true;
+        } else if (strcmp(argv[i], "--robust-quantile") == 0) {
+            robust_mode = true;
+            robust_quantile = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--cvd") == 0) {
+            cvd_mode = true;
+        } else if (strcmp(argv[i], "--cvd-severity") == 0) {
+            cvd_mode = true;
+            cvd_severity = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--semantic") == 0) {
+            semantic_file = argv[++i];
+        } else if (strcmp(argv[i], "--usage") == 0) {
+            usage_file = argv[++i];
+        } else if (strcmp(argv[i], "--dual") == 0) {
+            dual_mode = true;
+        } else if (strcmp(argv[i], "--xterm256") == 0) {
+            xterm_mode = true;
+        } else if (strcmp(argv[i], "--polish") == 0) {
+            polish_radius = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--polish-restarts") == 0) {
+            polish_restarts = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = strtoul(argv[++i], NULL, 10);
+            seed_set = true;
+        } else if (strcmp(argv[i], "--cache") == 0) {
+            cache_dir = argv[++i];
+        } else if (strcmp(argv[i], "--snapshot") == 0) {
+            snapshot_file = argv[++i];
+        } else if (strcmp(argv[i], "--snapshot-every") == 0) {
+            snapshot_every = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--snapshot-rows") == 0) {
+            snapshot_rows = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-memory") == 0) {
+            const char* size = argv[++i];
+            if (!memory_plan::parse_size(size, &max_memory)) {
+                printf("Error: invalid --max-memory '%s' (bytes, or with a K, M or G suffix)\n", size);
+                return 1;
+            }
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             printf("Hexa Color Solver v3.0 - OKLCH + APCA Terminal Palette Optimizer\n\n");
             printf("Usage: %s [options]\n\n", argv[0]);
             printf("Options:\n");
             printf("  -p, --population N     Population size (default: 200000)\n");
+            printf("  --max-memory SIZE      Device plus host memory budget, e.g. 4G; picks the largest population that fits\n");
             printf("  -g, --generations N    Number of generations (default: 5000)\n");
             printf("  -m, --mutation F       Mutation rate (default: 0.15)\n");
+            printf("  --elite-ratio F        Fraction of the population kept as parents (default: 0.1)\n");
+            printf("  --crossover OP         blend, uniform, blx, sbx or group (default: blend)\n");
+            printf("  --params FILE          Load GA parameters written by hexa-autotune\n");
             printf("  -o, --output FILE      Output theme file (default: ./themes/theme-YYMMDD-HHMMSS)\n");
+            printf("  --hierarchical         Coarse OKLCH lattice pass, then staged GA refinement\n");
+            printf("  --levels N             Lattice levels per L/C/H axis (default: 16)\n");
+            printf("  --top-k N              Lattice cells kept per slot (default: 64)\n");
+            printf("  --stages N             Refinement stages, each halving the mutation step (default: 4)\n");
+            printf("  --decompose            Block-coordinate refinement over slot groups after the GA\n");
+            printf("  --bcd-rounds N         Block-coordinate rounds (default: 200)\n");
+            printf("  --robust               Score contrast under the worst of %d display/gamma models\n", DISPLAY_MODEL_COUNT);
+            printf("  --robust-quantile Q    Score contrast at quantile Q (0-1) across display models instead\n");
+            printf("  --cvd                  Keep key pairs distinguishable under protan/deutan/tritan simulation\n");
+            printf("  --cvd-severity S       CVD simulation severity 0-1 (default: 1.0)\n");
+            printf("  --usage FILE           Reward contrast by pair usage captured with hexa-usage-capture\n");
+            printf("  --semantic FILE        Also solve the named semantic palette in FILE (writes OUTPUT.semantic)\n");
+            printf("  --dual                 Co-optimize dark and light variants with shared hues (writes OUTPUT-light)\n");
+            printf("  --xterm256             Also solve the 6x6x6 cube and grey ramp (slots 16-255)\n");
+            printf("  --polish K             Search +-K per channel around the rounded #rrggbb palette (default: 2, 0 = round only)\n");
+            printf("  --polish-restarts N    Jittered restarts of the 8-bit polish (default: 8)\n");
+            printf("  --seed N               Random seed (default: current time)\n");
+            printf("  --cache DIR            Reuse completed solves and warm-start from other seeds (default: $HEXA_CACHE)\n");
+            printf("  --snapshot FILE        Write sampled populations to a columnar file for offline analysis\n");
+            printf("  --snapshot-every N     Generations between snapshots (default: 100)\n");
+            printf("  --snapshot-rows N      Individuals per snapshot, strided over the population (default: 1024)\n");
             printf("  -h, --help             Show this help\n");
             return 0;
         }
@@ -714,16 +1112,153 @@ int main(int argc, char** argv) {
     }
 
     // Validate parameters
-    if (population_size < 100) {
-        printf("Error: population size must be >= 100 (got %d)\n", population_size);
+    if (params.population < 100) {
+        printf("Error: population size must be >= 100 (got %d)\n", params.population);
+        return 1;
+    }
+    if (params.elite_ratio <= 0.0 || params.elite_ratio >= 1.0 || params.stagnation_limit < 0 ||
+        params.mutation_growth < 1.0 || params.max_mutation > 1.0) {
+        printf("Error: elite ratio must be in (0, 1), stagnation limit >= 0, mutation growth >= 1, max mutation <= 1\n");
         return 1;
     }
     if (generations < 1) {
         printf("Error: generations must be >= 1 (got %d)\n", generations);
         return 1;
     }
+    if (decompose_mode && bcd_rounds < 1) {
+        printf("Error: --bcd-rounds must be >= 1 (got %d)\n", bcd_rounds);
+        return 1;
+    }
+    if (hierarchical_mode && (lattice_levels < 2 || lattice_top_k < 1 || refine_stages < 1)) {
+        printf("Error: --levels must be >= 2, --top-k and --stages >= 1\n");
+        return 1;
+    }
 
-    int elite_count = (int)(population_size * elite_ratio);
+    if (polish_radius < 0 || polish_radius > 32 || polish_restarts < 0) {
+        printf("Error: --polish must be in [0, 32] and --polish-restarts >= 0\n");
+        return 1;
+    }
+
+    if (snapshot_every < 1 || snapshot_rows < 1) {
+        printf("Error: --snapshot-every and --snapshot-rows must be >= 1\n");
+        return 1;
+    }
+
+    if (robust_quantile < 0.0 || robust_quantile > 1.0) {
+        printf("Error: --robust-quantile must be in [0, 1] (got %.3f)\n", robust_quantile);
+        return 1;
+    }
+    if (robust_mode) {
+        robust_model_count = DISPLAY_MODEL_COUNT;
+    }
+    if (cvd_severity < 0.0 || cvd_severity > 1.0) {
+        printf("Error: --cvd-severity must be in [0, 1] (got %.3f)\n", cvd_severity);
+        return 1;
+    }
+    if (cvd_mode) {
+        for (int d = 0; d < color::cvd::DEFICIENCY_COUNT; d++) {
+            cvd_models[d] = color::cvd::machado_matrix((color::cvd::Deficiency)d, cvd_severity);
+        }
+        cvd_model_count = color::cvd::DEFICIENCY_COUNT;
+    }
+
+    if (xterm_mode && (hierarchical_mode || decompose_mode)) {
+        printf("Error: --hierarchical and --decompose support 16-slot palettes only\n");
+        return 1;
+    }
+
+    if (dual_mode && (xterm_mode || hierarchical_mode || decompose_mode || robust_mode || cvd_mode || usage_file)) {
+        printf("Error: --dual cannot be combined with --xterm256, --hierarchical, --decompose, --robust, --cvd or --usage\n");
+        return 1;
+    }
+
+    usage::Histogram usage_histogram;
+    int usage_pairs = 0;
+    if (usage_file) {
+        if (!usage::load(usage_file, &usage_histogram)) {
+            return 1;
+        }
+        usage_pairs = usage::pair_weights(usage_histogram, usage_weights);
+        if (usage_pairs == 0) {
+            printf("Error: %s has no cell usage between two distinct ANSI slots\n", usage_file);
+            return 1;
+        }
+        usage_enabled = 1;
+    }
+
+    // 256-color genomes are 16x larger; default to a smaller population
+    if (xterm_mode && !population_set) {
+        params.population = 20000;
+    }
+    int n_slots = xterm_mode ? xterm::SLOTS : (dual_mode ? dual::SLOTS : 16);
+
+    // Slot table: ANSI constraints, plus the extended slots in 256-color mode
+    // or the light variant in dual mode
+    std::vector<OklchSlotConstraint> slot_table(oklch_slot_constraints, oklch_slot_constraints + 16);
+    std::vector<ApcaPairConstraint> ext_pairs;
+    if (xterm_mode) {
+        slot_table.resize(xterm::SLOTS);
+        xterm::build_slot_constraints(slot_table.data());
+        ext_pairs = xterm::build_pair_constraints(slot_table.data());
+    }
+    if (dual_mode) {
+        slot_table.insert(slot_table.end(), light_slot_constraints, light_slot_constraints + 16);
+        dual::freeze_shared_hues(slot_table.data() + dual::LIGHT_BASE);
+    }
+
+    genome::Layout layout = genome::build_layout(slot_table.data(), n_slots);
+
+    semantic::Spec semantic_spec;
+    if (semantic_file && !semantic::load_spec(semantic_file, &semantic_spec)) {
+        return 1;
+    }
+
+    // Memory plan: with --max-memory and no explicit population, the largest
+    // population that fits; otherwise refuse a population that doesn't
+    memory_plan::Config memory_config;
+    memory_config.n_genes = layout.genes();
+    memory_config.elite_ratio = params.elite_ratio;
+    memory_config.rng_state_bytes = sizeof(curandState);
+    memory_config.ext_pair_bytes = ext_pairs.size() * sizeof(ApcaPairConstraint);
+    if (hierarchical_mode) {
+        memory_config.lattice_cells = 16 * lattice_top_k;
+        memory_config.lattice_slots = 16;
+    }
+    if (decompose_mode) {
+        decompose::SlotGroups groups = ansi_slot_groups(cvd_mode);
+        memory_config.decompose_groups = groups.count();
+        memory_config.decompose_slots = (int)groups.slots.size();
+    }
+    if (semantic_file) {
+        // Before resolve_ansi() every slot counts as free: an upper bound
+        memory_config.semantic_genes = (int)semantic_spec.names.size();
+        memory_config.semantic_table_bytes = (semantic_spec.names.size() + 1) * sizeof(int) +
+                                             (semantic_spec.rules.size() + 1) * sizeof(ApcaPairConstraint);
+    }
+    if (snapshot_file) {
+        memory_config.snapshot_rows = snapshot_rows;
+        memory_config.snapshot_slots = n_slots;
+        memory_config.snapshot_terms = dual_mode ? 3 : 4;
+    }
+    if (max_memory > 0) {
+        if (!population_set) {
+            params.population = memory_plan::max_population(memory_config, max_memory, 100);
+            if (params.population == 0) {
+                memory_plan::print_plan(memory_plan::plan(memory_config, 100));
+                printf("Error: even population 100 does not fit --max-memory %.1f MiB\n", memory_plan::mib(max_memory));
+                return 1;
+            }
+        } else if (!memory_plan::fits(memory_plan::plan(memory_config, params.population), max_memory)) {
+            memory_plan::print_plan(memory_plan::plan(memory_config, params.population));
+            printf("Error: population %d does not fit --max-memory %.1f MiB\n",
+                   params.population, memory_plan::mib(max_memory));
+            return 1;
+        }
+    }
+    memory_plan::Plan memory = memory_plan::plan(memory_config, params.population);
+
+    int population_size = params.population;
+    int elite_count = ga::elite_count(params);
 
     const char* names[] = {
         "black", "red", "green", "yellow", "blue", "magenta", "cyan", "white",
@@ -737,10 +1272,114 @@ int main(int argc, char** argv) {
     printf("Parameters:\n");
     printf("  Population: %d\n", population_size);
     printf("  Generations: %d\n", generations);
-    printf("  Mutation rate: %.2f (adaptive)\n", mutation_rate);
-    printf("  Elite ratio: %.2f\n", elite_ratio);
+    printf("  Mutation rate: %.2f (adaptive: x%.3f/gen after %d stagnant, max %.2f)\n",
+           params.mutation_rate, params.mutation_growth, params.stagnation_limit, params.max_mutation);
+    printf("  Elite ratio: %.2f\n", params.elite_ratio);
+    printf("  Crossover: %s\n", ga::crossover_names[params.crossover]);
+    if (hierarchical_mode) {
+        printf("  Hierarchical: %d levels, top %d cells/slot, %d stages\n",
+               lattice_levels, lattice_top_k, refine_stages);
+    }
+    if (robust_mode) {
+        if (robust_quantile > 0.0) {
+            printf("  Robust: %d display models, quantile %.2f\n", robust_model_count, robust_quantile);
+        } else {
+            printf("  Robust: %d display models, worst case\n", robust_model_count);
+        }
+    }
+    if (cvd_mode) {
+        printf("  CVD: %d rules, severity %.2f\n", CVD_RULE_COUNT, cvd_severity);
+    }
+    if (usage_file) {
+        printf("  Usage: %s (%d pairs, %.1fs captured)\n", usage_file, usage_pairs, usage_histogram.seconds);
+    }
+    if (semantic_file) {
+        printf("  Semantic: %s (%zu slots, %zu rules)\n", semantic_file,
+               semantic_spec.names.size(), semantic_spec.rules.size());
+    }
+    if (dual_mode) {
+        printf("  Dual: dark + light variants, chromatic hues shared\n");
+    }
+    if (xterm_mode) {
+        printf("  Slots: %d (cube + grey ramp, %zu sparse contrast rules)\n",
+               n_slots, ext_pairs.size());
+    }
+    if (snapshot_file) {
+        printf("  Snapshots: %s (%d rows every %d generations)\n", snapshot_file,
+               std::min(snapshot_rows, population_size), snapshot_every);
+    }
+    printf("  Genome: %d free slots (%zu fixed slots precomputed)\n",
+           layout.genes(), layout.fixed.size());
+    printf("  Memory: %.1f MiB device, %.1f MiB host", memory_plan::mib(memory.device_peak),
+           memory_plan::mib(memory.host_peak));
+    if (max_memory > 0) {
+        printf(" (budget %.1f MiB%s)", memory_plan::mib(max_memory), population_set ? "" : ", population planned");
+    }
+    printf("\n");
+    printf("  Seed: %lu%s\n", seed, seed_set ? "" : " (from time)");
     printf("  Output: %s\n\n", output_file);
 
+    // Solve cache key: everything that determines the result, plus the code
+    // version (rule tables and build stamp). Output paths and snapshots don't
+    // change the result and are left out.
+    solve_cache::Key cache_key;
+    if (cache_dir) {
+        cache_key.add("build", __DATE__ " " __TIME__);
+        cache_key.add_bytes("slot_constraints", oklch_slot_constraints, sizeof(oklch_slot_constraints));
+        cache_key.add_bytes("apca_pairs", apca_pair_constraints, sizeof(apca_pair_constraints));
+        cache_key.add_bytes("light_slot_constraints", light_slot_constraints, sizeof(light_slot_constraints));
+        cache_key.add_bytes("light_apca_pairs", light_apca_pair_constraints, sizeof(light_apca_pair_constraints));
+        cache_key.add_bytes("cvd_rules", cvd_rules, sizeof(cvd_rules));
+        cache_key.add_bytes("display_models", display_models, sizeof(display_models));
+        cache_key.add("population", params.population);
+        cache_key.add("mutation_rate", params.mutation_rate);
+        cache_key.add("elite_ratio", params.elite_ratio);
+        cache_key.add("stagnation_limit", params.stagnation_limit);
+        cache_key.add("mutation_growth", params.mutation_growth);
+        cache_key.add("max_mutation", params.max_mutation);
+        cache_key.add("crossover", ga::crossover_names[params.crossover]);
+        cache_key.add("generations", generations);
+        char mode[128];
+        snprintf(mode, sizeof(mode), "levels %d, top-k %d, stages %d", lattice_levels, lattice_top_k, refine_stages);
+        cache_key.add("hierarchical", hierarchical_mode ? mode : "off");
+        snprintf(mode, sizeof(mode), "%d rounds", bcd_rounds);
+        cache_key.add("decompose", decompose_mode ? mode : "off");
+        snprintf(mode, sizeof(mode), "quantile %.17g", robust_quantile);
+        cache_key.add("robust", robust_mode ? mode : "off");
+        snprintf(mode, sizeof(mode), "severity %.17g", cvd_severity);
+        cache_key.add("cvd", cvd_mode ? mode : "off");
+        cache_key.add("xterm", xterm_mode ? "on" : "off");
+        cache_key.add("dual", dual_mode ? "on" : "off");
+        if (usage_enabled) {
+            cache_key.add_bytes("usage", usage_weights, sizeof(usage_weights));
+        }
+        snprintf(mode, sizeof(mode), "radius %d, restarts %d", polish_radius, polish_restarts);
+        cache_key.add("polish", mode);
+        cache_key.add("lookup_table", lut::table() ? "on" : "off");
+        std::string spec_text;
+        if (semantic_file && solve_cache::read_file(semantic_file, &spec_text)) {
+            cache_key.add_bytes("semantic", spec_text.data(), spec_text.size());
+        }
+        cache_key.add("seed", std::to_string(seed), false);
+
+        solve_cache::Entry cached;
+        if (solve_cache::load(cache_dir, cache_key, &cached)) {
+            printf("Cache hit: %s/%s\n\n%s", cache_dir, cache_key.hash().c_str(), cached.summary.c_str());
+            for (const auto& f : cached.files) {
+                std::string path = std::string(output_file) + f.first;
+                FILE* out = fopen(path.c_str(), "wb");
+                if (!out || fwrite(f.second.data(), 1, f.second.size(), out) != f.second.size()) {
+                    printf("Error: Could not write %s\n", path.c_str());
+                    if (out) fclose(out);
+                    return 1;
+                }
+                fclose(out);
+                printf("✓ Written from cache: %s\n", path.c_str());
+            }
+            return 0;
+        }
+    }
+
     printf("Color Space: OKLCH (perceptually uniform)\n");
     printf("Contrast Metric: APCA (WCAG 3.0)\n\n");
 
@@ -782,122 +1421,389 @@ int main(int argc, char** argv) {
     cudaGetDeviceProperties(&prop, 0);
     printf("Using GPU: %s\n\n", prop.name);
 
+    size_t free_memory, total_memory;
+    cudaMemGetInfo(&free_memory, &total_memory);
+    if (memory.device_peak > free_memory) {
+        memory_plan::print_plan(memory);
+        printf("Error: the solve needs %.1f MiB of device memory, %.1f MiB free of %.1f MiB\n",
+               memory_plan::mib(memory.device_peak), memory_plan::mib(free_memory), memory_plan::mib(total_memory));
+        return 1;
+    }
+
     // Copy constraints to device
-    cudaMemcpyToSymbol(d_oklch_slots, oklch_slot_constraints, sizeof(oklch_slot_constraints));
+    cudaMemcpyToSymbol(d_oklch_slots, slot_table.data(), n_slots * sizeof(OklchSlotConstraint));
     cudaMemcpyToSymbol(d_apca_pairs, apca_pair_constraints, sizeof(apca_pair_constraints));
     int pair_count = APCA_CONSTRAINT_COUNT;
     cudaMemcpyToSymbol(d_apca_pair_count, &pair_count, sizeof(int));
+    cudaMemcpyToSymbol(d_display_models, display_models, sizeof(display_models));
+    cudaMemcpyToSymbol(d_display_model_count, &robust_model_count, sizeof(int));
+    cudaMemcpyToSymbol(d_robust_quantile, &robust_quantile, sizeof(double));
+    cudaMemcpyToSymbol(d_light_pairs, light_apca_pair_constraints, sizeof(light_apca_pair_constraints));
+    int light_pair_count = LIGHT_APCA_CONSTRAINT_COUNT;
+    cudaMemcpyToSymbol(d_light_pair_count, &light_pair_count, sizeof(int));
+    cudaMemcpyToSymbol(d_cvd_rules, cvd_rules, sizeof(cvd_rules));
+    int cvd_rule_count = CVD_RULE_COUNT;
+    cudaMemcpyToSymbol(d_cvd_rule_count, &cvd_rule_count, sizeof(int));
+    cudaMemcpyToSymbol(d_cvd_models, cvd_models, sizeof(cvd_models));
+    cudaMemcpyToSymbol(d_cvd_model_count, &cvd_model_count, sizeof(int));
+    cudaMemcpyToSymbol(d_usage_weights, usage_weights, sizeof(usage_weights));
+    cudaMemcpyToSymbol(d_usage_enabled, &usage_enabled, sizeof(int));
+    if (!upload_layout(layout)) {
+        return 1;
+    }
+    int n_genes = layout.genes();
 
     // Allocate memory
-    size_t palette_size = population_size * 16 * 3 * sizeof(double);
+    size_t palette_size = (size_t)population_size * n_genes * 3 * sizeof(double);
     double *d_pop1, *d_pop2, *d_fitness;
     curandState* d_states;
     int* d_elite_indices;
 
-    cudaMalloc(&d_pop1, palette_size);
-    cudaMalloc(&d_pop2, palette_size);
-    cudaMalloc(&d_fitness, population_size * sizeof(double));
-    cudaMalloc(&d_states, population_size * sizeof(curandState));
-    cudaMalloc(&d_elite_indices, elite_count * sizeof(int));
+    if (!device_alloc(&d_pop1, palette_size, "population") ||
+        !device_alloc(&d_pop2, palette_size, "offspring") ||
+        !device_alloc(&d_fitness, population_size * sizeof(double), "fitness") ||
+        !device_alloc(&d_states, population_size * sizeof(curandState), "rng states") ||
+        !device_alloc(&d_elite_indices, elite_count * sizeof(int), "elite indices")) {
+        memory_plan::print_plan(memory);
+        return 1;
+    }
+
+    ApcaPairConstraint* d_ext_pairs = NULL;
+    int ext_pair_count = (int)ext_pairs.size();
+    if (ext_pair_count > 0) {
+        if (!device_alloc(&d_ext_pairs, ext_pair_count * sizeof(ApcaPairConstraint), "xterm pairs")) {
+            return 1;
+        }
+        cudaMemcpy(d_ext_pairs, ext_pairs.data(), ext_pair_count * sizeof(ApcaPairConstraint), cudaMemcpyHostToDevice);
+    }
 
     // Initialize
     int blockSize = 256;
     int numBlocks = (population_size + blockSize - 1) / blockSize;
 
     printf("Initializing population...\n");
-    init_curand<<<numBlocks, blockSize>>>(d_states, time(NULL), population_size);
-    init_population<<<numBlocks, blockSize>>>(d_pop1, d_states, population_size);
-    cudaDeviceSynchronize();
-
-    // Host arrays for elite selection
-    std::vector<double> h_fitness(population_size);
-    std::vector<int> h_elite_indices(elite_count);
-
-    // Best-ever tracking (don't rely solely on elitism)
-    double best_ever_fitness = -1e9;
-    std::vector<double> best_ever_palette(16 * 3);
-    int best_ever_generation = 0;
+    init_curand<<<numBlocks, blockSize>>>(d_states, seed, population_size);
+    if (hierarchical_mode) {
+        // Coarse pass on the host, then seed the GA from the best cells
+        hierarchical::CoarseLattice lattice = hierarchical::search_coarse_lattice(
+            oklch_slot_constraints, 16, apca_pair_constraints, APCA_CONSTRAINT_COUNT,
+            lattice_levels, lattice_top_k);
+
+        printf("Coarse lattice (best slot-vs-fixed score per slot):\n");
+        for (int i = 0; i < 16; i++) {
+            if (oklch_slot_constraints[i].fixed) continue;
+            printf("  %-12s %6d cells  best=%8.2f\n",
+                   names[i], lattice.lattice_size[i], lattice.best_score[i]);
+        }
+        printf("\n");
 
-    int stagnant_generations = 0;
-    double current_mutation = mutation_rate;
+        double *d_lattice, *d_cell_size;
+        if (!device_alloc(&d_lattice, lattice.points.size() * sizeof(double), "lattice points") ||
+            !device_alloc(&d_cell_size, lattice.cell_size.size() * sizeof(double), "lattice cells")) {
+            return 1;
+        }
+        cudaMemcpy(d_lattice, lattice.points.data(), lattice.points.size() * sizeof(double), cudaMemcpyHostToDevice);
+        cudaMemcpy(d_cell_size, lattice.cell_size.data(), lattice.cell_size.size() * sizeof(double), cudaMemcpyHostToDevice);
 
-    printf("Starting evolution...\n\n");
+        init_population_from_lattice<<<numBlocks, blockSize>>>(
+            d_pop1, d_states, population_size, d_lattice, d_cell_size, lattice.top_k);
 
-    for (int gen = 0; gen < generations; gen++) {
-        // Evaluate fitness
-        evaluate_fitness<<<numBlocks, blockSize>>>(d_pop1, d_fitness, population_size);
         cudaDeviceSynchronize();
+        cudaFree(d_lattice);
+        cudaFree(d_cell_size);
+    } else {
+        init_population<<<numBlocks, blockSize>>>(d_pop1, d_states, population_size);
+        cudaDeviceSynchronize();
+    }
 
-        // Copy fitness to host
-        cudaMemcpy(h_fitness.data(), d_fitness, population_size * sizeof(double), cudaMemcpyDeviceToHost);
-
-        // Find elite indices
-        std::vector<int> indices(population_size);
-        for (int i = 0; i < population_size; i++) indices[i] = i;
-
-        std::partial_sort(indices.begin(), indices.begin() + elite_count, indices.end(),
-            [&h_fitness](int a, int b) { return h_fitness[a] > h_fitness[b]; });
+    // Warm start: best genomes of cached solves with the same rules, other seeds
+    if (cache_dir) {
+        std::vector<std::vector<double>> warm = solve_cache::warm_starts(
+            cache_dir, cache_key, (size_t)n_genes * 3, std::min(16, elite_count));
+        for (size_t k = 0; k < warm.size(); k++) {
+            cudaMemcpy(d_pop1 + k * n_genes * 3, warm[k].data(), n_genes * 3 * sizeof(double),
+                       cudaMemcpyHostToDevice);
+        }
+        if (!warm.empty()) {
+            printf("Warm start: %zu genomes from cached solves with other seeds\n", warm.size());
+        }
+    }
 
-        for (int i = 0; i < elite_count; i++) {
-            h_elite_indices[i] = indices[i];
+    // Population snapshots: rows decode like the evaluation kernel of the mode,
+    // with the score split into its terms
+    snapshot::Writer snapshots;
+    if (snapshot_file) {
+        snapshot::Schema schema;
+        schema.n_slots = n_slots;
+        schema.genome_doubles = n_genes * 3;
+        if (dual_mode) {
+            schema.term_names = {"dark", "light", "coupling"};
+            schema.decode = [&](const double* g, fitness::SlotColor* s) {
+                dual::convert(g, layout.slot_genes.data(), layout.fixed.data(), (int)layout.fixed.size(), s);
+            };
+            schema.terms = [](const fitness::SlotColor* s, double* terms) {
+                terms[0] = fitness::palette_score(s, oklch_slot_constraints, apca_pair_constraints,
+                                                  APCA_CONSTRAINT_COUNT);
+                terms[1] = fitness::palette_score(s + dual::LIGHT_BASE, light_slot_constraints,
+                                                  light_apca_pair_constraints, LIGHT_APCA_CONSTRAINT_COUNT);
+                terms[2] = dual::coupling_terms(s);
+            };
+        } else {
+            schema.term_names = {"perceptual", "contrast", "cvd", "xterm"};
+            schema.decode = [&](const double* g, fitness::SlotColor* s) {
+                genome::decode(layout, g, s);
+            };
+            schema.terms = [&](const fitness::SlotColor* s, double* terms) {
+                terms[0] = fitness::perceptual_terms(s, oklch_slot_constraints);
+                terms[2] = cvd_model_count > 0
+                    ? fitness::cvd_terms(s, cvd_rules, CVD_RULE_COUNT, cvd_models, cvd_model_count)
+                    : 0.0;
+                terms[1] = host_slots_fitness(s) - terms[0] - terms[2];
+                terms[3] = xterm_mode ? xterm::extended_terms(s, ext_pairs.data(), (int)ext_pairs.size()) : 0.0;
+            };
+        }
+        if (!snapshots.open(snapshot_file, schema, population_size, snapshot_rows, snapshot_every)) {
+            return 1;
         }
+    }
 
-        double gen_best = h_fitness[indices[0]];
+    GaBuffers buf = {d_pop1, d_pop2, d_fitness, d_elite_indices, d_states};
+    int stages = hierarchical_mode ? refine_stages : 1;
+    GaResult result;
+    if (xterm_mode) {
+        result = evolve(buf, n_genes, params, generations, stages, &snapshots, [&](double* pop) {
+            evaluate_fitness<xterm::SLOTS><<<numBlocks, blockSize>>>(
+                pop, d_fitness, population_size, d_ext_pairs, ext_pair_count);
+        });
+    } else if (dual_mode) {
+        result = evolve(buf, n_genes, params, generations, stages, &snapshots, [&](double* pop) {
+            evaluate_dual<<<numBlocks, blockSize>>>(pop, d_fitness, population_size);
+        });
+        dual::tie_hues(layout.slot_genes.data(), result.best_palette.data());
+    } else {
+        result = evolve(buf, n_genes, params, generations, stages, &snapshots, [&](double* pop) {
+            evaluate_fitness<16><<<numBlocks, blockSize>>>(pop, d_fitness, population_size, NULL, 0);
+        });
+    }
+    d_pop1 = buf.d_pop1;
+    d_pop2 = buf.d_pop2;
 
-        // Track best-ever palette
-        if (gen_best > best_ever_fitness) {
-            best_ever_fitness = gen_best;
-            best_ever_generation = gen;
-            // Save the best palette from device
-            int best_idx = indices[0];
-            cudaMemcpy(best_ever_palette.data(), d_pop1 + best_idx * 16 * 3,
-                       16 * 3 * sizeof(double), cudaMemcpyDeviceToHost);
-            stagnant_generations = 0;
-            current_mutation = mutation_rate;
+    if (snapshot_file) {
+        snapshots.close();
+        if (snapshots.failed()) {
+            printf("Warning: Failed writing snapshots to %s\n", snapshot_file);
         } else {
-            stagnant_generations++;
-            if (stagnant_generations > 100) {
-                current_mutation = fmin(0.5, current_mutation * 1.01);
-            }
+            printf("Wrote %llu population snapshots (%d rows each) to %s\n",
+                   (unsigned long long)snapshots.blocks_written(), snapshots.rows(), snapshot_file);
         }
+    }
 
-        // Progress output
-        if (gen % 500 == 0 || gen == generations - 1) {
-            printf("Gen %5d: best=%.2f, avg=%.2f, mutation=%.3f\n",
-                   gen, gen_best,
-                   std::accumulate(h_fitness.begin(), h_fitness.end(), 0.0) / population_size,
-                   current_mutation);
-        }
+    std::vector<double> best_ever_palette = result.best_palette;
+    double best_ever_fitness = result.best_fitness;
+    int best_ever_generation = result.best_generation;
+    std::vector<double> h_fitness(population_size);
 
-        if (gen < generations - 1) {
-            // Copy elite indices to device
-            cudaMemcpy(d_elite_indices, h_elite_indices.data(), elite_count * sizeof(int), cudaMemcpyHostToDevice);
+    // Use best-ever palette (not just final generation)
+    printf("\nBest solution found at generation %d (fitness=%.2f)\n",
+           best_ever_generation, best_ever_fitness);
 
-            // Crossover and mutation
-            crossover_and_mutate<<<numBlocks, blockSize>>>(
-                d_pop1, d_pop2, d_fitness, d_elite_indices, elite_count,
-                d_states, current_mutation, population_size
-            );
+    // Block-coordinate refinement: each group is a small subproblem with the
+    // rest of the palette held at the current best
+    if (decompose_mode) {
+        decompose::SlotGroups groups = ansi_slot_groups(cvd_mode);
+        int n_groups = groups.count();
+        int per_group = population_size / n_groups;
+        int n_candidates = n_groups * per_group;
+
+        printf("\nSlot-decomposed refinement (%d groups, %d candidates/group/round):\n",
+               n_groups, per_group);
+        decompose::print_groups(groups, names);
+
+        int *d_group_offsets, *d_group_slots;
+        double *d_group_scale, *d_best;
+        if (!device_alloc(&d_group_offsets, groups.offsets.size() * sizeof(int), "group offsets") ||
+            !device_alloc(&d_group_slots, groups.slots.size() * sizeof(int), "group slots") ||
+            !device_alloc(&d_group_scale, n_groups * sizeof(double), "group scales") ||
+            !device_alloc(&d_best, ANSI_GENE_COUNT * 3 * sizeof(double), "group best")) {
+            return 1;
+        }
+        cudaMemcpy(d_group_offsets, groups.offsets.data(), groups.offsets.size() * sizeof(int), cudaMemcpyHostToDevice);
+        cudaMemcpy(d_group_slots, groups.slots.data(), groups.slots.size() * sizeof(int), cudaMemcpyHostToDevice);
+
+        std::vector<double> group_scale(n_groups, 0.5);
+        std::vector<double> candidate(ANSI_GENE_COUNT * 3);
+        double start_fitness = best_ever_fitness;
+        int rounds_run = 0;
+
+        for (int round = 0; round < bcd_rounds; round++) {
+            rounds_run = round + 1;
+            cudaMemcpy(d_best, best_ever_palette.data(), ANSI_GENE_COUNT * 3 * sizeof(double), cudaMemcpyHostToDevice);
+            cudaMemcpy(d_group_scale, group_scale.data(), n_groups * sizeof(double), cudaMemcpyHostToDevice);
+
+            int cand_blocks = (n_candidates + blockSize - 1) / blockSize;
+            refine_groups<<<cand_blocks, blockSize>>>(
+                d_best, d_pop2, d_fitness, d_group_offsets, d_group_slots, d_group_scale,
+                n_groups, per_group, d_states);
             cudaDeviceSynchronize();
+            cudaMemcpy(h_fitness.data(), d_fitness, n_candidates * sizeof(double), cudaMemcpyDeviceToHost);
+
+            // Best candidate of each sub-solve
+            std::vector<double> combined = best_ever_palette;
+            double best_single = best_ever_fitness;
+            std::vector<double> best_single_palette;
+            bool any_improved = false;
+
+            for (int g = 0; g < n_groups; g++) {
+                int winner = g * per_group;
+                for (int k = g * per_group; k < (g + 1) * per_group; k++) {
+                    if (h_fitness[k] > h_fitness[winner]) winner = k;
+                }
+                if (h_fitness[winner] <= best_ever_fitness) {
+                    group_scale[g] *= 0.5;
+                    continue;
+                }
 
-            // Swap populations
-            std::swap(d_pop1, d_pop2);
+                any_improved = true;
+                group_scale[g] = fmin(1.0, group_scale[g] * 1.5);
+                cudaMemcpy(candidate.data(), d_pop2 + (size_t)winner * ANSI_GENE_COUNT * 3,
+                           ANSI_GENE_COUNT * 3 * sizeof(double), cudaMemcpyDeviceToHost);
+                for (int k = groups.offsets[g]; k < groups.offsets[g + 1]; k++) {
+                    int gene = layout.slot_genes[groups.slots[k]];
+                    for (int j = 0; j < 3; j++) combined[gene * 3 + j] = candidate[gene * 3 + j];
+                }
+                if (h_fitness[winner] > best_single) {
+                    best_single = h_fitness[winner];
+                    best_single_palette = candidate;
+                }
+            }
+
+            if (!any_improved) {
+                if (*std::max_element(group_scale.begin(), group_scale.end()) < 1e-3) break;
+                continue;
+            }
+
+            // Jacobi step: apply every group's winner at once, unless the
+            // weak couplings make the combination worse than the best single move
+            double combined_fitness = host_palette_fitness(layout, combined.data());
+            if (combined_fitness >= best_single) {
+                best_ever_palette = combined;
+                best_ever_fitness = combined_fitness;
+            } else {
+                best_ever_palette = best_single_palette;
+                best_ever_fitness = best_single;
+            }
         }
+
+        printf("  Refined in %d rounds: fitness %.2f -> %.2f\n",
+               rounds_run, start_fitness, best_ever_fitness);
+
+        cudaFree(d_group_offsets);
+        cudaFree(d_group_slots);
+        cudaFree(d_group_scale);
+        cudaFree(d_best);
     }
 
-    // Use best-ever palette (not just final generation)
-    printf("\nBest solution found at generation %d (fitness=%.2f)\n",
-           best_ever_generation, best_ever_fitness);
+    // Convert the best genome to RGB, then polish it on the 8-bit lattice so
+    // the reported fitness is the fitness of the #rrggbb values written out
+    std::vector<double> rgb_palette(n_slots * 3);
+    genome::to_rgb(layout, best_ever_palette.data(), rgb_palette.data());
+
+    quantize::Result quantized = quantize::polish(
+        rgb_palette.data(), n_slots, layout.gene_slots, polish_radius, polish_restarts,
+        [&](const fitness::SlotColor* s) {
+            if (dual_mode) {
+                return dual::dual_score(s, oklch_slot_constraints, apca_pair_constraints,
+                                        APCA_CONSTRAINT_COUNT, light_slot_constraints,
+                                        light_apca_pair_constraints, LIGHT_APCA_CONSTRAINT_COUNT);
+            }
+            double score = host_slots_fitness(s);
+            if (xterm_mode) {
+                score += xterm::extended_terms(s, ext_pairs.data(), (int)ext_pairs.size());
+            }
+            return score;
+        });
+    rgb_palette = quantized.rgb;
 
-    // Convert OKLCH palette to RGB for display and output
-    std::vector<double> rgb_palette(16 * 3);
-    oklch_palette_to_rgb(best_ever_palette.data(), rgb_palette.data());
+    printf("\n8-bit polish (±%d, %d restarts%s): fitness %.2f (rounded %.2f, continuous %.2f)\n",
+           polish_radius, polish_restarts, lut::table() ? ", lookup table" : "",
+           quantized.score, quantized.rounded_score, best_ever_fitness);
 
     // Print results
     print_color_demo(rgb_palette.data());
+    if (robust_mode) {
+        print_robust_report(rgb_palette.data(), names);
+    }
+    if (cvd_mode) {
+        print_cvd_report(rgb_palette.data(), names);
+    }
+    if (xterm_mode) {
+        print_xterm_report(rgb_palette.data(), ext_pairs);
+    }
+
+    if (dual_mode) {
+        print_dual_report(rgb_palette.data(), names);
+    }
+
+    // Slack of every ANSI slot before a rule or APCA band flips (nominal
+    // rules; the light variant of --dual has its own tables and is skipped)
+    margins::Report margin_report;
+    margins::Analyzer margin_analyzer(rgb_palette.data(), oklch_slot_constraints, apca_pair_constraints,
+                                      APCA_CONSTRAINT_COUNT, names);
+    if (!dual_mode) {
+        margin_report = margin_analyzer.analyze();
+        margins::print_report(margin_analyzer, margin_report, names);
+    }
 
     // Write theme file (always, defaults to ./themes/theme-YYMMDD-HHMMSS)
-    write_theme_file(rgb_palette.data(), output_file);
+    if (dual_mode) {
+        char light_output[1024];
+        snprintf(light_output, sizeof(light_output), "%s-light", output_file);
+        write_theme_file(rgb_palette.data(), 16, BLACK, WHITE, output_file);
+        write_theme_file(rgb_palette.data() + dual::LIGHT_BASE * 3, 16, BR_WHITE, BLACK, light_output);
+    } else {
+        write_theme_file(rgb_palette.data(), n_slots, BLACK, WHITE, output_file);
+
+        char margins_output[1024];
+        snprintf(margins_output, sizeof(margins_output), "%s.margins.json", output_file);
+        if (margins::write_json(margin_analyzer, margin_report, names, margins_output)) {
+            printf("✓ Constraint margins written to: %s\n", margins_output);
+        } else {
+            printf("Warning: Could not write %s\n", margins_output);
+        }
+    }
+
+    // Semantic palette, solved after the theme so it can reference ANSI slots
+    if (semantic_file) {
+        solve_semantic(semantic_spec, rgb_palette.data(), {d_pop1, d_pop2, d_fitness, d_elite_indices, d_states},
+                       params, generations, polish_radius, polish_restarts, output_file);
+    }
+
+    // Store the completed solve: summary, best genome and every written file
+    if (cache_dir) {
+        solve_cache::Entry entry;
+        entry.fitness = quantized.score;
+        entry.genome = best_ever_palette;
+        char summary[256];
+        snprintf(summary, sizeof(summary),
+                 "Best solution found at generation %d (fitness=%.2f)\n8-bit fitness %.2f\n",
+                 best_ever_generation, best_ever_fitness, quantized.score);
+        entry.summary = summary;
+        std::vector<std::string> suffixes = {""};
+        if (dual_mode) suffixes.push_back("-light");
+        if (semantic_file) suffixes.push_back(".semantic");
+        if (!dual_mode) suffixes.push_back(".margins.json");
+        for (const std::string& suffix : suffixes) {
+            std::string contents;
+            if (solve_cache::read_file(output_file + suffix, &contents)) {
+                entry.files.push_back({suffix, contents});
+            }
+        }
+        if (solve_cache::store(cache_dir, cache_key, entry)) {
+            printf("Cached as %s/%s\n", cache_dir, cache_key.hash().c_str());
+        } else {
+            printf("Warning: Could not store the solve in %s\n", cache_dir);
+        }
+    }
 
     // Cleanup
     cudaFree(d_pop1);
@@ -905,6 +1811,7 @@ int main(int argc, char** argv) {
     cudaFree(d_fitness);
     cudaFree(d_states);
     cudaFree(d_elite_indices);
+    cudaFree(d_ext_pairs);
 
     return 0;
 }
@@ -0,0 +1,173 @@
+/**
+ * Hierarchical Search Module - Coarse OKLCH lattice pass for the GA
+ *
+ * Every free slot's OKLCH constraint box is quantized into a levels^3 lattice
+ * (L x C x H). Each lattice point is converted once, then scored against the
+ * fixed slots through an exhaustive slot-vs-fixed contrast table: the APCA
+ * pair constraints and readability pairs whose other side is fixed, plus the
+ * gamut and chroma terms. Those terms do not depend on any other free slot,
+ * so the best cells per slot are exact on that part of the fitness.
+ *
+ * The top cells per slot seed the continuous GA, which then refines them at
+ * progressively finer mutation scales (see step_scale()).
+ */
+
+#ifndef HIERARCHICAL_HPP
+#define HIERARCHICAL_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "fitness.cuh"
+
+namespace hierarchical {
+
+struct LatticePoint {
+    double L, C, H;
+    double score;
+};
+
+// Result of the coarse pass, flattened for upload to the device
+struct CoarseLattice {
+    int n_slots;
+    int top_k;
+    std::vector<double> points;      // [slot][k][3] OKLCH of the top cells, best first
+    std::vector<double> cell_size;   // [slot][3] lattice step in L, C, H
+    std::vector<double> best_score;  // [slot] score of the best cell
+    std::vector<int> lattice_size;   // [slot] number of cells scored
+};
+
+/**
+ * Score one slot on the terms that only involve itself and fixed slots.
+ * fixed_colors[j] is only read where slots[j].fixed is set.
+ */
+inline double slot_vs_fixed_score(int slot, const fitness::SlotColor& sc,
+                                  const fitness::SlotColor* fixed_colors,
+                                  const OklchSlotConstraint* slots, int n_slots,
+                                  const ApcaPairConstraint* pairs, int pair_count) {
+    // Slot-vs-fixed contrast table: APCA with this slot as fg and as bg
+    std::vector<double> as_fg(n_slots, 0.0), as_bg(n_slots, 0.0);
+    for (int j = 0; j < n_slots; j++) {
+        if (!slots[j].fixed) continue;
+        as_fg[j] = fabs(color::apca::contrast_prepared(sc.lum, fixed_colors[j].lum));
+        as_bg[j] = fabs(color::apca::contrast_prepared(fixed_colors[j].lum, sc.lum));
+    }
+
+    double score = fitness::gamut_score(sc.in_gamut);
+    if (fitness::has_chroma_bonus(slot)) {
+        score += fitness::chroma_score(sc.C);
+    }
+
+    for (int i = 0; i < pair_count; i++) {
+        const ApcaPairConstraint& p = pairs[i];
+        if (p.fg_index == slot && slots[p.bg_index].fixed) {
+            score += fitness::apca_pair_score(p, as_fg[p.bg_index]);
+        } else if (p.bg_index == slot && slots[p.fg_index].fixed) {
+            score += fitness::apca_pair_score(p, as_bg[p.fg_index]);
+        }
+    }
+
+    for (int j = 0; j < n_slots; j++) {
+        if (!slots[j].fixed) continue;
+        if (fitness::is_readability_pair(slot, j)) score += fitness::readability_score(as_fg[j]);
+        if (fitness::is_readability_pair(j, slot)) score += fitness::readability_score(as_bg[j]);
+    }
+
+    return score;
+}
+
+/**
+ * Run the coarse pass: enumerate each free slot's lattice, score every cell
+ * and keep the top_k cells per slot. Fixed slots get a single entry.
+ */
+inline CoarseLattice search_coarse_lattice(const OklchSlotConstraint* slots, int n_slots,
+                                           const ApcaPairConstraint* pairs, int pair_count,
+                                           int levels, int top_k) {
+    CoarseLattice result;
+    result.n_slots = n_slots;
+    result.top_k = top_k;
+    result.points.assign(n_slots * top_k * 3, 0.0);
+    result.cell_size.assign(n_slots * 3, 0.0);
+    result.best_score.assign(n_slots, 0.0);
+    result.lattice_size.assign(n_slots, 0);
+
+    // Fixed slot colors, converted once
+    std::vector<fitness::SlotColor> fixed_colors(n_slots);
+    for (int j = 0; j < n_slots; j++) {
+        const OklchSlotConstraint& c = slots[j];
+        if (c.fixed) {
+            fixed_colors[j] = fitness::slot_from_srgb(c.fixed_r, c.fixed_g, c.fixed_b);
+        }
+    }
+
+    for (int slot = 0; slot < n_slots; slot++) {
+        const OklchSlotConstraint& c = slots[slot];
+        std::vector<LatticePoint> cells;
+
+        if (c.fixed) {
+            const fitness::SlotColor& f = fixed_colors[slot];
+            cells.push_back({f.L, f.C, f.H, 0.0});
+        } else {
+            // Degenerate ranges collapse to a single level
+            double hue_span = 2.0 * c.hue_tolerance;
+            int nL = c.max_L > c.min_L ? levels : 1;
+            int nC = c.max_C > c.min_C ? levels : 1;
+            int nH = hue_span > 0.0 ? levels : 1;
+            double dL = (c.max_L - c.min_L) / nL;
+            double dC = (c.max_C - c.min_C) / nC;
+            double dH = hue_span / nH;
+            result.cell_size[slot * 3 + 0] = dL;
+            result.cell_size[slot * 3 + 1] = dC;
+            result.cell_size[slot * 3 + 2] = dH;
+
+            for (int i = 0; i < nL; i++) {
+                double L = c.min_L + (i + 0.5) * dL;
+                for (int k = 0; k < nH; k++) {
+                    double H = color::oklch::normalize_hue(
+                        c.target_hue - c.hue_tolerance + (k + 0.5) * dH);
+
+                    // Chroma cells are clamped to gamut, same as init_population
+                    double max_C = color::oklch_max_chroma(L, H);
+                    for (int j = 0; j < nC; j++) {
+                        double C = fmin(c.min_C + (j + 0.5) * dC, max_C);
+                        fitness::SlotColor sc = fitness::slot_from_oklch(L, C, H);
+                        double score = slot_vs_fixed_score(slot, sc, fixed_colors.data(),
+                                                           slots, n_slots, pairs, pair_count);
+                        cells.push_back({L, C, H, score});
+                    }
+                }
+            }
+        }
+
+        int keep = std::min((int)cells.size(), top_k);
+        std::partial_sort(cells.begin(), cells.begin() + keep, cells.end(),
+            [](const LatticePoint& a, const LatticePoint& b) { return a.score > b.score; });
+
+        // Pad short lists by repeating the ranking so every k is valid
+        for (int k = 0; k < top_k; k++) {
+            const LatticePoint& p = cells[k % keep];
+            int base = (slot * top_k + k) * 3;
+            result.points[base + 0] = p.L;
+            result.points[base + 1] = p.C;
+            result.points[base + 2] = p.H;
+        }
+        result.best_score[slot] = cells[0].score;
+        result.lattice_size[slot] = (int)cells.size();
+    }
+
+    return result;
+}
+
+/**
+ * Mutation scale for a GA stage. The first stage uses the normal GA step
+ * (one to two lattice cells at 16 levels); each following stage halves it.
+ */
+inline double step_scale(int generation, int generations, int stages) {
+    int stage = (int)((long long)generation * stages / generations);
+    return ldexp(1.0, -stage);
+}
+
+} // namespace hierarchical
+
+#endif // HIERARCHICAL_HPP
@@ -0,0 +1,358 @@
+/**
+ * Fitness Landscape Slice - 2-D grid of the full fitness around a palette
+ *
+ * Picks two variables of the 16-slot ANSI genome (slot and OKLCH axis, e.g.
+ * cyan.L and cyan.H), holds every other slot at the given theme (any format
+ * theme_formats.hpp reads) and evaluates fitness::palette_score() on a dense
+ * grid over the two. Useful for seeing how a rule shapes the landscape before
+ * tuning its weight.
+ *
+ * The unchanged slots are converted once. When the two variables belong to
+ * different slots, each grid column and each grid row is converted once too,
+ * so a grid point is only a score; on the same slot every point converts
+ * that one slot (with the hue basis cached per row or column). Square tiles
+ * are scored in parallel on the work-stealing pool (cpu::Pool).
+ *
+ * Output by extension: .ppm writes a heatmap (dark = low, bright = high,
+ * the theme's own point marked), anything else the raw matrix as
+ * little-endian float64, row-major, y rows by x columns:
+ *   numpy.fromfile(path).reshape(height, width)
+ *
+ * Build: g++ -std=c++17 -O2 landscape.cpp -o hexa-landscape -lpthread
+ * Run: ./hexa-landscape --x cyan.L --y cyan.H themes/theme-250101-120000 cyan.ppm
+ *      ./hexa-landscape --x red.C --y br.red.C --size 512 theme slice.f64
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "cpu_backend.hpp"
+#include "theme_formats.hpp"
+
+#define TILE 32
+
+static const char* slot_names[16] = {
+    "black", "red", "green", "yellow", "blue", "magenta", "cyan", "white",
+    "br.black", "br.red", "br.green", "br.yellow", "br.blue", "br.magenta", "br.cyan", "br.white"
+};
+
+enum Axis { AXIS_L, AXIS_C, AXIS_H };
+
+struct Variable {
+    int slot;
+    int axis;
+    double lo, hi;
+    bool range_set;
+
+    double value(int i, int n) const { return n > 1 ? lo + (hi - lo) * i / (n - 1) : lo; }
+};
+
+/**
+ * Parse "slot.axis" where slot is a name (cyan, br.cyan) or index 0-15 and
+ * axis is L, C or H.
+ */
+static bool parse_variable(const char* text, Variable* v) {
+    const char* dot = strrchr(text, '.');
+    if (!dot || dot[1] == '\0' || dot[2] != '\0') return false;
+    const char* axes = "LCH";
+    const char* axis = strchr(axes, toupper((unsigned char)dot[1]));
+    if (!axis) return false;
+    std::string slot(text, dot - text);
+    v->slot = -1;
+    for (int i = 0; i < 16; i++) {
+        if (slot == slot_names[i]) v->slot = i;
+    }
+    if (v->slot < 0) {
+        char* end;
+        long i = strtol(slot.c_str(), &end, 10);
+        if (slot.empty() || *end != '\0' || i < 0 || i > 15) return false;
+        v->slot = (int)i;
+    }
+    v->axis = (int)(axis - axes);
+    return true;
+}
+
+static bool parse_range(const char* text, Variable* v) {
+    if (sscanf(text, "%lf:%lf", &v->lo, &v->hi) != 2 || !(v->hi > v->lo)) return false;
+    v->range_set = true;
+    return true;
+}
+
+// Default range: the slot's constraint box on that axis
+static void default_range(Variable* v) {
+    const OklchSlotConstraint& c = oklch_slot_constraints[v->slot];
+    switch (v->axis) {
+        case AXIS_L: v->lo = 0.0; v->hi = 1.0; if (!c.fixed) { v->lo = c.min_L; v->hi = c.max_L; } break;
+        case AXIS_C: v->lo = 0.0; v->hi = 0.4; if (!c.fixed) { v->lo = c.min_C; v->hi = c.max_C; } break;
+        default:
+            v->lo = 0.0;
+            v->hi = 360.0;
+            if (!c.fixed && c.hue_tolerance > 0.0 && c.hue_tolerance < 180.0) {
+                v->lo = c.target_hue - c.hue_tolerance;
+                v->hi = c.target_hue + c.hue_tolerance;
+            }
+            break;
+    }
+}
+
+static double wrap_hue(double H) {
+    H = fmod(H, 360.0);
+    return H < 0.0 ? H + 360.0 : H;
+}
+
+// Slot `base` with one axis replaced
+static fitness::SlotColor with_axis(const fitness::SlotColor& base, int axis, double value) {
+    double lch[3] = {base.L, base.C, base.H};
+    lch[axis] = axis == AXIS_H ? wrap_hue(value) : value;
+    return fitness::slot_from_oklch(lch[0], lch[1], lch[2]);
+}
+
+struct Slice {
+    int width, height;
+    std::vector<double> values;  // [y][x]
+};
+
+/**
+ * Score the grid: x varies along a row, y down the columns.
+ */
+static Slice evaluate_slice(const fitness::SlotColor* base, const Variable& x, const Variable& y,
+                            int width, int height, cpu::Pool& pool) {
+    Slice slice = {width, height, std::vector<double>((size_t)width * height)};
+    auto score = [](const fitness::SlotColor* s) {
+        return fitness::palette_score(s, oklch_slot_constraints, apca_pair_constraints, APCA_CONSTRAINT_COUNT);
+    };
+
+    // Different slots: every column and row value converts once
+    std::vector<fitness::SlotColor> x_slots, y_slots;
+    bool same_slot = x.slot == y.slot;
+    if (!same_slot) {
+        x_slots.resize(width);
+        y_slots.resize(height);
+        pool.parallel_for(width, [&](int i) { x_slots[i] = with_axis(base[x.slot], x.axis, x.value(i, width)); });
+        pool.parallel_for(height, [&](int j) { y_slots[j] = with_axis(base[y.slot], y.axis, y.value(j, height)); });
+    }
+
+    int tiles_x = (width + TILE - 1) / TILE;
+    int tiles_y = (height + TILE - 1) / TILE;
+    pool.parallel_for(tiles_x * tiles_y, [&](int t) {
+        int x0 = (t % tiles_x) * TILE, y0 = (t / tiles_x) * TILE;
+        int x1 = std::min(width, x0 + TILE), y1 = std::min(height, y0 + TILE);
+        fitness::SlotColor s[16];
+        memcpy(s, base, sizeof(s));
+        for (int j = y0; j < y1; j++) {
+            double* row = &slice.values[(size_t)j * width];
+            if (!same_slot) {
+                s[y.slot] = y_slots[j];
+                for (int i = x0; i < x1; i++) {
+                    s[x.slot] = x_slots[i];
+                    row[i] = score(s);
+                }
+                continue;
+            }
+            double lch[3] = {base[x.slot].L, base[x.slot].C, base[x.slot].H};
+            lch[y.axis] = y.value(j, height);
+            for (int i = x0; i < x1; i++) {
+                lch[x.axis] = x.value(i, width);
+                double H = wrap_hue(lch[AXIS_H]);
+                s[x.slot] = fitness::slot_from_oklch(lch[AXIS_L], lch[AXIS_C], H);
+                row[i] = score(s);
+            }
+        }
+    });
+    return slice;
+}
+
+static bool write_matrix(const Slice& slice, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(slice.values.data(), sizeof(double), slice.values.size(), f) == slice.values.size();
+    return fclose(f) == 0 && ok;
+}
+
+/**
+ * Heatmap: an OKLCH ramp from dark blue (lowest) to light yellow (highest),
+ * the theme's own point (mark_x, mark_y) drawn as a small cross.
+ */
+static bool write_heatmap(const Slice& slice, const char* path, int mark_x, int mark_y) {
+    auto [lo_it, hi_it] = std::minmax_element(slice.values.begin(), slice.values.end());
+    double lo = *lo_it, span = std::max(1e-12, *hi_it - lo);
+
+    std::vector<uint8_t> ramp(256 * 3);
+    for (int k = 0; k < 256; k++) {
+        double t = k / 255.0;
+        double r, g, b;
+        color::oklch::to_srgb(0.25 + 0.7 * t, 0.12, wrap_hue(265.0 + 180.0 * t), &r, &g, &b);
+        ramp[k * 3 + 0] = (uint8_t)lround(r);
+        ramp[k * 3 + 1] = (uint8_t)lround(g);
+        ramp[k * 3 + 2] = (uint8_t)lround(b);
+    }
+
+    std::vector<uint8_t> pixels((size_t)slice.width * slice.height * 3);
+    for (int j = 0; j < slice.height; j++) {
+        // Row 0 of the image is the top: highest y
+        const double* row = &slice.values[(size_t)(slice.height - 1 - j) * slice.width];
+        for (int i = 0; i < slice.width; i++) {
+            int k = (int)lround((row[i] - lo) / span * 255.0);
+            memcpy(&pixels[((size_t)j * slice.width + i) * 3], &ramp[k * 3], 3);
+        }
+    }
+    if (mark_x >= 0 && mark_y >= 0) {
+        int py = slice.height - 1 - mark_y;
+        for (int d = -3; d <= 3; d++) {
+            int points[2][2] = {{mark_x + d, py}, {mark_x, py + d}};
+            for (auto& p : points) {
+                if (p[0] < 0 || p[0] >= slice.width || p[1] < 0 || p[1] >= slice.height) continue;
+                memset(&pixels[((size_t)p[1] * slice.width + p[0]) * 3], 255, 3);
+            }
+        }
+    }
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", slice.width, slice.height);
+    bool ok = fwrite(pixels.data(), 1, pixels.size(), f) == pixels.size();
+    return fclose(f) == 0 && ok;
+}
+
+// Grid index of value v on a variable's axis, -1 if outside
+static int grid_index(const Variable& v, double value, int n) {
+    if (v.axis == AXIS_H) {
+        // Hue ranges may extend past 0/360; pick the equivalent inside
+        for (double shift : {0.0, 360.0, -360.0}) {
+            if (value + shift >= v.lo && value + shift <= v.hi) {
+                value += shift;
+                break;
+            }
+        }
+    }
+    if (value < v.lo || value > v.hi) return -1;
+    return (int)lround((value - v.lo) / (v.hi - v.lo) * (n - 1));
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s --x SLOT.AXIS --y SLOT.AXIS [options] THEME OUTPUT\n", prog);
+    printf("\nSLOT is a name (cyan, br.cyan) or 0-15, AXIS is L, C or H.\n");
+    printf("OUTPUT ending in .ppm is a heatmap, anything else raw float64 [y][x].\n");
+    printf("\nOptions:\n");
+    printf("  --x-range LO:HI  Range of x (default: the slot's constraint box)\n");
+    printf("  --y-range LO:HI  Range of y (default: the slot's constraint box)\n");
+    printf("  --size N         Grid points per axis (default: 1024)\n");
+    printf("  --width N        Grid points along x\n");
+    printf("  --height N       Grid points along y\n");
+    printf("  --threads N      Worker threads (default: hardware threads)\n");
+}
+
+int main(int argc, char** argv) {
+    Variable x = {}, y = {};
+    bool x_set = false, y_set = false;
+    int width = 1024, height = 1024;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<const char*> paths;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--x") == 0 && i + 1 < argc) {
+            x_set = parse_variable(argv[++i], &x);
+            if (!x_set) {
+                printf("Error: invalid --x '%s' (expected SLOT.L, SLOT.C or SLOT.H)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--y") == 0 && i + 1 < argc) {
+            y_set = parse_variable(argv[++i], &y);
+            if (!y_set) {
+                printf("Error: invalid --y '%s' (expected SLOT.L, SLOT.C or SLOT.H)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--x-range") == 0 && i + 1 < argc) {
+            if (!parse_range(argv[++i], &x)) {
+                printf("Error: invalid --x-range '%s' (expected LO:HI with LO < HI)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--y-range") == 0 && i + 1 < argc) {
+            if (!parse_range(argv[++i], &y)) {
+                printf("Error: invalid --y-range '%s' (expected LO:HI with LO < HI)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            width = height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+            height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] != '-') {
+            paths.push_back(argv[i]);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!x_set || !y_set || paths.size() != 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (x.slot == y.slot && x.axis == y.axis) {
+        printf("Error: --x and --y must be different variables\n");
+        return 1;
+    }
+    if (width < 2 || height < 2 || threads < 1) {
+        printf("Error: grid must be at least 2x2 and --threads >= 1\n");
+        return 1;
+    }
+    if (!x.range_set) default_range(&x);
+    if (!y.range_set) default_range(&y);
+
+    theme_metrics::Palette palette;
+    if (!theme_formats::load_file(paths[0], &palette)) {
+        printf("Error: Could not read 16 ANSI colors from %s\n", paths[0]);
+        return 1;
+    }
+    fitness::SlotColor base[16];
+    for (int i = 0; i < 16; i++) {
+        base[i] = fitness::slot_from_srgb(palette.rgb[i][0], palette.rgb[i][1], palette.rgb[i][2]);
+    }
+
+    const char* axis_names = "LCH";
+    printf("Slice of %s: x = %s.%c [%g, %g], y = %s.%c [%g, %g], %dx%d points\n", paths[0],
+           slot_names[x.slot], axis_names[x.axis], x.lo, x.hi,
+           slot_names[y.slot], axis_names[y.axis], y.lo, y.hi, width, height);
+
+    cpu::Pool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+    Slice slice = evaluate_slice(base, x, y, width, height, pool);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double lch_x[3] = {base[x.slot].L, base[x.slot].C, base[x.slot].H};
+    double lch_y[3] = {base[y.slot].L, base[y.slot].C, base[y.slot].H};
+    int mark_x = grid_index(x, lch_x[x.axis], width);
+    int mark_y = grid_index(y, lch_y[y.axis], height);
+    auto [lo_it, hi_it] = std::minmax_element(slice.values.begin(), slice.values.end());
+    size_t best = hi_it - slice.values.begin();
+    printf("Evaluated %zu points in %.3fs on %d threads (%.1f M/s)\n", slice.values.size(), seconds,
+           pool.size(), slice.values.size() / seconds / 1e6);
+    printf("Fitness: min %.2f, max %.2f at x=%g y=%g", *lo_it, *hi_it,
+           x.value((int)(best % width), width), y.value((int)(best / width), height));
+    if (mark_x >= 0 && mark_y >= 0) {
+        printf(", theme %.2f", slice.values[(size_t)mark_y * width + mark_x]);
+    }
+    printf("\n");
+
+    const char* out = paths[1];
+    size_t len = strlen(out);
+    bool ppm = len > 4 && strcmp(out + len - 4, ".ppm") == 0;
+    if (!(ppm ? write_heatmap(slice, out, mark_x, mark_y) : write_matrix(slice, out))) {
+        printf("Error: Failed writing %s\n", out);
+        return 1;
+    }
+    printf("Wrote %s to %s\n", ppm ? "heatmap" : "float64 matrix", out);
+    return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * sRGB Lookup Table Generator
+ *
+ * Writes the full-cube table read by lut.hpp: APCA Y, WCAG luminance and
+ * Oklab L/a/b as floats for every 8-bit sRGB color. --check maps an existing
+ * table and compares every entry against the reference functions in color.cuh.
+ *
+ * Build: g++ -std=c++17 -O2 lut-gen.cpp -o lut-gen -lpthread
+ * Run: ./lut-gen srgb-lut.bin              (CHUNKED layout)
+ *      ./lut-gen --linear srgb-lut.bin     (LINEAR layout)
+ *      ./lut-gen --check srgb-lut.bin
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "lut.hpp"
+
+// Float storage of values in [0, 1] rounds by at most ~6e-8
+#define VALUE_EPSILON 1e-6
+// Lc from float Y against black and white
+#define CONTRAST_EPSILON 1e-4
+
+/**
+ * Run fn(r) for every red channel value, split across hardware threads.
+ */
+template <typename Fn>
+static void parallel_red(Fn fn) {
+    int n_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([=] {
+            for (int r = t; r < 256; r += n_threads) fn(r);
+        });
+    }
+    for (std::thread& th : threads) th.join();
+}
+
+static int generate(const char* path, int layout) {
+    std::vector<color::lut::Entry> entries(lut::ENTRY_COUNT);
+    parallel_red([&](int r) {
+        for (int g = 0; g < 256; g++) {
+            for (int b = 0; b < 256; b++) {
+                entries[color::lut::index(r, g, b, layout)] = lut::compute_entry(r, g, b);
+            }
+        }
+    });
+
+    lut::Header h = {};
+    memcpy(h.magic, lut::MAGIC, sizeof(h.magic));
+    h.layout = (uint32_t)layout;
+    h.entry_size = sizeof(color::lut::Entry);
+    h.count = lut::ENTRY_COUNT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        printf("Error: Could not open %s for writing\n", path);
+        return 1;
+    }
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+              fwrite(entries.data(), sizeof(color::lut::Entry), entries.size(), f) == entries.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        printf("Error: Failed writing %s\n", path);
+        return 1;
+    }
+
+    printf("Wrote %s: %llu entries, %s layout, %.1f MiB\n", path,
+           (unsigned long long)lut::ENTRY_COUNT,
+           layout == color::lut::CHUNKED ? "chunked" : "linear",
+           (sizeof(h) + entries.size() * sizeof(color::lut::Entry)) / (1024.0 * 1024.0));
+    return 0;
+}
+
+// Max abs error per field, one slot per red value so threads never share
+struct Errors {
+    double apca_y, wcag_y, L, a, b, contrast;
+};
+
+static int check(const char* path) {
+    lut::Table t;
+    if (!lut::map_file(path, &t)) {
+        printf("Error: %s is missing or not a valid table\n", path);
+        return 1;
+    }
+
+    std::vector<Errors> per_red(256, Errors{});
+    parallel_red([&](int r) {
+        Errors& e = per_red[r];
+        for (int g = 0; g < 256; g++) {
+            for (int b = 0; b < 256; b++) {
+                color::oklab::Lab ref = color::oklab::from_srgb(r, g, b);
+                color::oklab::Lab got = color::lut::oklab(t.entries, t.layout, r, g, b);
+                e.apca_y = fmax(e.apca_y, fabs(color::lut::apca_luminance(t.entries, t.layout, r, g, b) -
+                                               color::apca::luminance(r, g, b)));
+                e.wcag_y = fmax(e.wcag_y, fabs(color::lut::wcag_luminance(t.entries, t.layout, r, g, b) -
+                                               color::wcag2::luminance(r, g, b)));
+                e.L = fmax(e.L, fabs(got.L - ref.L));
+                e.a = fmax(e.a, fabs(got.a - ref.a));
+                e.b = fmax(e.b, fabs(got.b - ref.b));
+
+                // Contrast against black and white, both polarities
+                double lc[4] = {
+                    color::lut::apca_contrast(t.entries, t.layout, r, g, b, 0, 0, 0) -
+                        color::apca::contrast(r, g, b, 0, 0, 0),
+                    color::lut::apca_contrast(t.entries, t.layout, 0, 0, 0, r, g, b) -
+                        color::apca::contrast(0, 0, 0, r, g, b),
+                    color::lut::apca_contrast(t.entries, t.layout, r, g, b, 255, 255, 255) -
+                        color::apca::contrast(r, g, b, 255, 255, 255),
+                    color::lut::apca_contrast(t.entries, t.layout, 255, 255, 255, r, g, b) -
+                        color::apca::contrast(255, 255, 255, r, g, b),
+                };
+                for (double d : lc) e.contrast = fmax(e.contrast, fabs(d));
+            }
+        }
+    });
+
+    Errors max = {};
+    for (const Errors& e : per_red) {
+        max.apca_y = fmax(max.apca_y, e.apca_y);
+        max.wcag_y = fmax(max.wcag_y, e.wcag_y);
+        max.L = fmax(max.L, e.L);
+        max.a = fmax(max.a, e.a);
+        max.b = fmax(max.b, e.b);
+        max.contrast = fmax(max.contrast, e.contrast);
+    }
+
+    struct { const char* name; double err; double eps; } rows[] = {
+        {"APCA Y", max.apca_y, VALUE_EPSILON},
+        {"WCAG luminance", max.wcag_y, VALUE_EPSILON},
+        {"Oklab L", max.L, VALUE_EPSILON},
+        {"Oklab a", max.a, VALUE_EPSILON},
+        {"Oklab b", max.b, VALUE_EPSILON},
+        {"APCA Lc vs black/white", max.contrast, CONTRAST_EPSILON},
+    };
+
+    int failed = 0;
+    printf("Exhaustive check of %s (%s layout, %llu colors)\n", path,
+           t.layout == color::lut::CHUNKED ? "chunked" : "linear",
+           (unsigned long long)lut::ENTRY_COUNT);
+    for (const auto& row : rows) {
+        bool ok = row.err <= row.eps;
+        if (!ok) failed++;
+        printf("  %s %-24s max error %.3g (limit %.3g)\n", ok ? "✓" : "✗", row.name, row.err, row.eps);
+    }
+    munmap((void*)((const char*)t.entries - sizeof(lut::Header)), t.mapped_bytes);
+    return failed > 0 ? 1 : 0;
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [--linear] OUTPUT\n", prog);
+    printf("       %s --check FILE\n", prog);
+    printf("\nOptions:\n");
+    printf("  --linear        Write entries in (r, g, b) order instead of 16^3 chunks\n");
+    printf("  --check FILE    Compare every entry of FILE against the reference functions\n");
+}
+
+int main(int argc, char** argv) {
+    int layout = color::lut::CHUNKED;
+    const char* output = nullptr;
+    const char* check_path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--linear") == 0) {
+            layout = color::lut::LINEAR;
+        } else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) {
+            check_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] != '-' && !output) {
+            output = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (check_path) return check(check_path);
+    if (!output) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    return generate(output, layout);
+}
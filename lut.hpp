@@ -0,0 +1,112 @@
+/**
+ * sRGB Lookup Table Module - File format and lazy memory mapping
+ *
+ * The table file (written by lut-gen) is a fixed header followed by 2^24
+ * color::lut::Entry records in LINEAR or CHUNKED order. At 20 bytes per entry
+ * the file is 320 MiB, so it is mapped read-only on first use and pages are
+ * only faulted in for the colors actually looked up.
+ *
+ * The file is found via $HEXA_LUT, falling back to srgb-lut.bin in the
+ * working directory. A missing or malformed file is not an error: table()
+ * returns nullptr and callers use the reference functions instead.
+ */
+
+#ifndef LUT_HPP
+#define LUT_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "color.cuh"
+
+namespace lut {
+
+constexpr char MAGIC[8] = {'H', 'X', 'L', 'U', 'T', '0', '0', '1'};
+constexpr uint64_t ENTRY_COUNT = 1ull << 24;
+constexpr const char* DEFAULT_PATH = "srgb-lut.bin";
+
+struct Header {
+    char magic[8];
+    uint32_t layout;      // color::lut::Layout
+    uint32_t entry_size;  // sizeof(color::lut::Entry)
+    uint64_t count;       // ENTRY_COUNT
+};
+
+struct Table {
+    const color::lut::Entry* entries;
+    int layout;
+    size_t mapped_bytes;
+};
+
+/**
+ * Compute one entry with the reference functions.
+ */
+inline color::lut::Entry compute_entry(int r, int g, int b) {
+    color::lut::Entry e;
+    color::oklab::Lab lab = color::oklab::from_srgb(r, g, b);
+    e.apca_y = (float)color::apca::luminance(r, g, b);
+    e.wcag_y = (float)color::wcag2::luminance(r, g, b);
+    e.L = (float)lab.L;
+    e.a = (float)lab.a;
+    e.b = (float)lab.b;
+    return e;
+}
+
+/**
+ * Map a table file read-only. Returns false (and leaves *out untouched) if
+ * the file is missing or its header does not match this build.
+ */
+inline bool map_file(const char* path, Table* out) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    Header h;
+    size_t expected = sizeof(Header) + ENTRY_COUNT * sizeof(color::lut::Entry);
+    bool ok = fstat(fd, &st) == 0 && (size_t)st.st_size == expected &&
+              pread(fd, &h, sizeof(h), 0) == (ssize_t)sizeof(h) &&
+              memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+              h.entry_size == sizeof(color::lut::Entry) && h.count == ENTRY_COUNT &&
+              (h.layout == color::lut::LINEAR || h.layout == color::lut::CHUNKED);
+    if (!ok) {
+        close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+    // Lookups are scattered; don't read ahead whole neighbourhoods
+    madvise(p, expected, MADV_RANDOM);
+
+    out->entries = (const color::lut::Entry*)((const char*)p + sizeof(Header));
+    out->layout = (int)h.layout;
+    out->mapped_bytes = expected;
+    return true;
+}
+
+/**
+ * Process-wide table, mapped on the first call. nullptr if unavailable.
+ */
+inline const Table* table() {
+    static Table t = {};
+    static bool mapped = false;
+    static std::once_flag once;
+    std::call_once(once, [] {
+        const char* path = getenv("HEXA_LUT");
+        mapped = map_file(path ? path : DEFAULT_PATH, &t);
+    });
+    return mapped ? &t : nullptr;
+}
+
+} // namespace lut
+
+#endif // LUT_HPP
@@ -0,0 +1,379 @@
+/**
+ * Margins Module - How far each color of a palette can move before a rule flips
+ *
+ * A palette's rule outcome is summarized as a signature of discrete states:
+ *   - each APCA pair constraint: met (Lc >= min_apca), at or above its
+ *     target, and its APCA band (< 45, 45, 60, 75, 90)
+ *   - each readability pair (BONUS 4): Lc >= 40
+ *   - each slot: inside sRGB gamut, inside its OKLCH constraint box
+ *   - each bright slot: hue drift from its base within max_hue_drift
+ *   - hue spacing >= 40 degrees, Oklab separation >= 0.15 (BONUS 1, 3)
+ *
+ * For every slot, direction of L, C and H, and 8-bit R, G and B channel, the
+ * margin is the distance to the first move that changes the signature. The
+ * OKLCH margins scan the move range coarsely and bisect the first change;
+ * the channel margins are exact integer steps (1 = one rounding step from a
+ * flip). Probes reuse the palette's cached APCA matrix and only recompute the
+ * row and column of the moved slot. Directions run on all hardware threads.
+ */
+
+#ifndef MARGINS_HPP
+#define MARGINS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fitness.cuh"
+
+namespace margins {
+
+constexpr int SLOTS = 16;
+constexpr int SCAN_STEPS = 64;
+
+// OKLCH axes: largest move searched and bisection tolerance
+constexpr double AXIS_RANGE[3] = {1.0, 0.4, 180.0};
+constexpr double AXIS_TOLERANCE[3] = {1e-5, 1e-5, 1e-3};
+constexpr const char* AXIS_NAMES[6] = {"L", "C", "H", "R", "G", "B"};
+
+constexpr double APCA_BANDS[4] = {45.0, 60.0, 75.0, 90.0};
+constexpr double READABLE_APCA = 40.0;
+constexpr double MIN_HUE_SPACING = 40.0;
+constexpr double MIN_SEPARATION = 0.15;
+
+// One direction of one variable: distance to the first change and what changed
+struct Limit {
+    double distance;  // INFINITY if nothing changes within the move range
+    std::string cause;
+};
+
+struct SlotMargins {
+    // [variable][direction]: variables L, C, H, R, G, B; direction 0 = -, 1 = +
+    Limit limit[6][2];
+};
+
+struct Report {
+    std::vector<SlotMargins> slots;  // SLOTS entries, fixed slots left empty
+    std::vector<bool> free;
+    int tight_slot = -1, tight_channel = -1, tight_direction = -1;  // fewest 8-bit steps
+};
+
+class Analyzer {
+public:
+    Analyzer(const double* rgb, const OklchSlotConstraint* slots, const ApcaPairConstraint* pairs,
+             int pair_count, const char* const* names)
+        : rules_(slots), pairs_(pairs), pair_count_(pair_count), names_(names) {
+        for (int i = 0; i < SLOTS; i++) {
+            base_[i] = fitness::slot_from_srgb(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+            rgb_[i][0] = (int)lround(rgb[i * 3]);
+            rgb_[i][1] = (int)lround(rgb[i * 3 + 1]);
+            rgb_[i][2] = (int)lround(rgb[i * 3 + 2]);
+        }
+        for (int fg = 0; fg < SLOTS; fg++) {
+            for (int bg = 0; bg < SLOTS; bg++) {
+                lc_[fg][bg] = color::apca::contrast_prepared(base_[fg].lum, base_[bg].lum);
+            }
+        }
+    }
+
+    /**
+     * Signature of the palette with slot `moved` replaced by s; the other
+     * slots' contrasts come from the cached matrix.
+     */
+    std::vector<uint8_t> signature(int moved, const fitness::SlotColor& s) const {
+        auto slot = [&](int i) -> const fitness::SlotColor& { return i == moved ? s : base_[i]; };
+        auto lc = [&](int fg, int bg) {
+            if (fg != moved && bg != moved) return lc_[fg][bg];
+            return color::apca::contrast_prepared(slot(fg).lum, slot(bg).lum);
+        };
+
+        std::vector<uint8_t> sig;
+        sig.reserve(3 * pair_count_ + 8 * SLOTS + 2 * SLOTS + 9);
+        for (int i = 0; i < pair_count_; i++) {
+            const ApcaPairConstraint& p = pairs_[i];
+            double raw = lc(p.fg_index, p.bg_index);
+            double apca = p.polarity == POLARITY_ANY ? fabs(raw) : raw * p.polarity;
+            sig.push_back(apca >= p.min_apca);
+            sig.push_back(p.target_apca > 0.0 && apca >= p.target_apca);
+            sig.push_back(band(fabs(raw)));
+        }
+        for (int bg = 0; bg < 8; bg++) {
+            for (int fg = 0; fg < SLOTS; fg++) {
+                if (fitness::is_readability_pair(fg, bg)) sig.push_back(fabs(lc(fg, bg)) >= READABLE_APCA);
+            }
+        }
+        for (int i = 0; i < SLOTS; i++) {
+            sig.push_back(slot(i).in_gamut);
+            sig.push_back(in_box(i, slot(i)));
+        }
+        for (int i = 8; i <= 14; i++) {
+            const OklchSlotConstraint& c = rules_[i];
+            bool ok = c.base_slot < 0 || c.max_hue_drift <= 0.0 ||
+                      color::hue_distance(slot(i).H, slot(c.base_slot).H) <= c.max_hue_drift;
+            sig.push_back(ok);
+        }
+        double min_hue = 360.0, min_dist = 1000.0;
+        for (int i = RED; i <= WHITE; i++) {
+            for (int j = i + 1; j <= WHITE; j++) {
+                if (j <= CYAN) min_hue = fmin(min_hue, color::hue_distance(slot(i).H, slot(j).H));
+                min_dist = fmin(min_dist, fitness::slot_distance(slot(i), slot(j)));
+            }
+        }
+        sig.push_back(min_hue >= MIN_HUE_SPACING);
+        sig.push_back(min_dist >= MIN_SEPARATION);
+        return sig;
+    }
+
+    Report analyze() const {
+        Report report;
+        report.slots.resize(SLOTS);
+        report.free.resize(SLOTS);
+        std::vector<int> jobs;  // slot * 12 + variable * 2 + direction
+        for (int i = 0; i < SLOTS; i++) {
+            report.free[i] = !rules_[i].fixed;
+            if (!report.free[i]) continue;
+            for (int k = 0; k < 12; k++) jobs.push_back(i * 12 + k);
+        }
+
+        std::atomic<size_t> next(0);
+        auto worker = [&] {
+            for (size_t j = next++; j < jobs.size(); j = next++) {
+                int slot = jobs[j] / 12, variable = jobs[j] % 12 / 2, direction = jobs[j] % 2;
+                report.slots[slot].limit[variable][direction] = variable < 3
+                    ? axis_limit(slot, variable, direction ? 1.0 : -1.0)
+                    : channel_limit(slot, variable - 3, direction ? 1 : -1);
+            }
+        };
+        int n_threads = std::max(1, std::min((int)jobs.size(), (int)std::thread::hardware_concurrency()));
+        std::vector<std::thread> threads;
+        for (int t = 0; t < n_threads; t++) threads.emplace_back(worker);
+        for (std::thread& t : threads) t.join();
+
+        double fewest = INFINITY;
+        for (int i = 0; i < SLOTS; i++) {
+            if (!report.free[i]) continue;
+            for (int ch = 0; ch < 3; ch++) {
+                for (int d = 0; d < 2; d++) {
+                    if (report.slots[i].limit[3 + ch][d].distance < fewest) {
+                        fewest = report.slots[i].limit[3 + ch][d].distance;
+                        report.tight_slot = i;
+                        report.tight_channel = ch;
+                        report.tight_direction = d;
+                    }
+                }
+            }
+        }
+        return report;
+    }
+
+    const fitness::SlotColor& base(int i) const { return base_[i]; }
+    const int* rgb(int i) const { return rgb_[i]; }
+
+private:
+    static int band(double abs_lc) {
+        int b = 0;
+        while (b < 4 && abs_lc >= APCA_BANDS[b]) b++;
+        return b;
+    }
+
+    bool in_box(int i, const fitness::SlotColor& s) const {
+        const OklchSlotConstraint& c = rules_[i];
+        if (c.fixed) return true;
+        constexpr double EPS = 1e-9;
+        bool hue_ok = c.hue_tolerance >= 180.0 ||
+                      color::hue_distance(s.H, c.target_hue) <= c.hue_tolerance + EPS;
+        return s.L >= c.min_L - EPS && s.L <= c.max_L + EPS && s.C >= c.min_C - EPS &&
+               s.C <= c.max_C + EPS && hue_ok;
+    }
+
+    // Slot i with one OKLCH axis moved by t (L and C clamped at 0, hue wrapped)
+    fitness::SlotColor moved_axis(int i, int axis, double t) const {
+        double lch[3] = {base_[i].L, base_[i].C, base_[i].H};
+        lch[axis] += t;
+        if (axis == 2) lch[2] = fmod(fmod(lch[2], 360.0) + 360.0, 360.0);
+        return fitness::slot_from_oklch(lch[0], lch[1], lch[2]);
+    }
+
+    Limit axis_limit(int i, int axis, double direction) const {
+        // Reference: the slot re-derived from its own OKLCH, like every probe
+        std::vector<uint8_t> ref = signature(i, moved_axis(i, axis, 0.0));
+        double range = AXIS_RANGE[axis];
+        if (axis < 2) {
+            double v = axis == 0 ? base_[i].L : base_[i].C;
+            range = direction < 0 ? v : (axis == 0 ? 1.0 - v : AXIS_RANGE[1] - v);
+        }
+        if (range <= 0.0) return {INFINITY, ""};
+
+        // Coarse scan for the first changed step, then bisect it
+        double lo = 0.0, hi = -1.0;
+        for (int k = 1; k <= SCAN_STEPS; k++) {
+            double t = range * k / SCAN_STEPS;
+            if (signature(i, moved_axis(i, axis, direction * t)) != ref) {
+                hi = t;
+                break;
+            }
+            lo = t;
+        }
+        if (hi < 0.0) return {INFINITY, ""};
+        while (hi - lo > AXIS_TOLERANCE[axis]) {
+            double mid = 0.5 * (lo + hi);
+            if (signature(i, moved_axis(i, axis, direction * mid)) != ref) {
+                hi = mid;
+            } else {
+                lo = mid;
+            }
+        }
+        return {lo, describe(ref, signature(i, moved_axis(i, axis, direction * hi)))};
+    }
+
+    Limit channel_limit(int i, int channel, int direction) const {
+        std::vector<uint8_t> ref = signature(i, base_[i]);
+        int c[3] = {rgb_[i][0], rgb_[i][1], rgb_[i][2]};
+        for (int step = 1;; step++) {
+            int v = rgb_[i][channel] + direction * step;
+            if (v < 0 || v > 255) return {INFINITY, ""};
+            c[channel] = v;
+            std::vector<uint8_t> sig = signature(i, fitness::slot_from_srgb(c[0], c[1], c[2]));
+            if (sig != ref) return {(double)step, describe(ref, sig)};
+        }
+    }
+
+    // Name of the first signature entry that differs, in signature() order
+    std::string describe(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) const {
+        size_t k = std::mismatch(a.begin(), a.end(), b.begin()).first - a.begin();
+        char text[128];
+        if (k < (size_t)3 * pair_count_) {
+            const ApcaPairConstraint& p = pairs_[k / 3];
+            const char* what[3] = {"minimum", "target", "band"};
+            double value = k % 3 == 0 ? p.min_apca : k % 3 == 1 ? p.target_apca : 0.0;
+            if (k % 3 == 2) {
+                snprintf(text, sizeof(text), "%s on %s: APCA band", names_[p.fg_index], names_[p.bg_index]);
+            } else {
+                snprintf(text, sizeof(text), "%s on %s: APCA %s %.0f", names_[p.fg_index], names_[p.bg_index],
+                         what[k % 3], value);
+            }
+            return text;
+        }
+        k -= 3 * pair_count_;
+        for (int bg = 0; bg < 8; bg++) {
+            for (int fg = 0; fg < SLOTS; fg++) {
+                if (!fitness::is_readability_pair(fg, bg)) continue;
+                if (k-- == 0) {
+                    snprintf(text, sizeof(text), "%s on %s: readability %.0f", names_[fg], names_[bg],
+                             READABLE_APCA);
+                    return text;
+                }
+            }
+        }
+        if (k < 2 * SLOTS) {
+            snprintf(text, sizeof(text), "%s: %s", names_[k / 2], k % 2 == 0 ? "sRGB gamut" : "constraint box");
+            return text;
+        }
+        k -= 2 * SLOTS;
+        if (k < 7) {
+            snprintf(text, sizeof(text), "%s: hue drift", names_[8 + k]);
+            return text;
+        }
+        return k == 7 ? "hue spacing 40" : "separation 0.15";
+    }
+
+    const OklchSlotConstraint* rules_;
+    const ApcaPairConstraint* pairs_;
+    int pair_count_;
+    const char* const* names_;
+    fitness::SlotColor base_[SLOTS];
+    int rgb_[SLOTS][3];
+    double lc_[SLOTS][SLOTS];
+};
+
+/**
+ * Print one row per free slot: distance to the first change in each
+ * direction ("-" = none within range), and the tightest 8-bit channel.
+ */
+inline void print_report(const Analyzer& a, const Report& r, const char* const* names) {
+    printf("\nConstraint margins (distance to the first rule or APCA band change, - = none):\n");
+    printf("  %-12s %13s %13s %11s %7s %7s %7s\n", "Slot", "L -/+", "C -/+", "H -/+", "R -/+", "G -/+", "B -/+");
+    auto axis_text = [](const Limit* l, const char* format, char* out, size_t n) {
+        char v[2][16];
+        for (int d = 0; d < 2; d++) {
+            if (std::isinf(l[d].distance)) {
+                snprintf(v[d], sizeof(v[d]), "-");
+            } else {
+                snprintf(v[d], sizeof(v[d]), format, l[d].distance);
+            }
+        }
+        snprintf(out, n, "%s/%s", v[0], v[1]);
+    };
+    for (int i = 0; i < SLOTS; i++) {
+        if (!r.free[i]) continue;
+        char cols[6][32];
+        for (int v = 0; v < 6; v++) {
+            axis_text(r.slots[i].limit[v], v == 2 ? "%.1f" : v < 2 ? "%.4f" : "%.0f", cols[v], sizeof(cols[v]));
+        }
+        printf("  %-12s %13s %13s %11s %7s %7s %7s\n", names[i], cols[0], cols[1], cols[2], cols[3], cols[4],
+               cols[5]);
+    }
+    if (r.tight_slot >= 0) {
+        const Limit& l = r.slots[r.tight_slot].limit[3 + r.tight_channel][r.tight_direction];
+        const int* rgb = a.rgb(r.tight_slot);
+        printf("  Tightest: %s #%02x%02x%02x %s%s%.0f flips %s\n", names[r.tight_slot], rgb[0], rgb[1], rgb[2],
+               AXIS_NAMES[3 + r.tight_channel], r.tight_direction ? "+" : "-", l.distance, l.cause.c_str());
+    }
+}
+
+/**
+ * Write the margins as JSON: per free slot its color and, per variable, the
+ * [minus, plus] distances (null = none within range) and their causes.
+ */
+inline bool write_json(const Analyzer& a, const Report& r, const char* const* names, const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "{\n  \"slots\": [");
+    bool first = true;
+    for (int i = 0; i < SLOTS; i++) {
+        if (!r.free[i]) continue;
+        const fitness::SlotColor& s = a.base(i);
+        const int* rgb = a.rgb(i);
+        fprintf(f, "%s\n    {\"slot\": %d, \"name\": \"%s\", \"rgb\": \"#%02x%02x%02x\", "
+                   "\"oklch\": [%.6f, %.6f, %.3f],\n     \"margins\": {",
+                first ? "" : ",", i, names[i], rgb[0], rgb[1], rgb[2], s.L, s.C, s.H);
+        first = false;
+        for (int v = 0; v < 6; v++) {
+            const Limit* l = r.slots[i].limit[v];
+            fprintf(f, "%s\"%s\": [", v ? ", " : "", AXIS_NAMES[v]);
+            for (int d = 0; d < 2; d++) {
+                if (std::isinf(l[d].distance)) {
+                    fprintf(f, "%snull", d ? ", " : "");
+                } else {
+                    fprintf(f, "%s%.6g", d ? ", " : "", l[d].distance);
+                }
+            }
+            fprintf(f, "]");
+        }
+        fprintf(f, "},\n     \"causes\": {");
+        for (int v = 0; v < 6; v++) {
+            const Limit* l = r.slots[i].limit[v];
+            fprintf(f, "%s\"%s\": [\"%s\", \"%s\"]", v ? ", " : "", AXIS_NAMES[v], l[0].cause.c_str(),
+                    l[1].cause.c_str());
+        }
+        fprintf(f, "}}");
+    }
+    fprintf(f, "\n  ]");
+    if (r.tight_slot >= 0) {
+        const Limit& l = r.slots[r.tight_slot].limit[3 + r.tight_channel][r.tight_direction];
+        fprintf(f, ",\n  \"tightest\": {\"slot\": %d, \"channel\": \"%s\", \"direction\": %d, \"steps\": %.0f, "
+                   "\"cause\": \"%s\"}",
+                r.tight_slot, AXIS_NAMES[3 + r.tight_channel], r.tight_direction ? 1 : -1, l.distance,
+                l.cause.c_str());
+    }
+    fprintf(f, "\n}\n");
+    return fclose(f) == 0;
+}
+
+} // namespace margins
+
+#endif // MARGINS_HPP
@@ -0,0 +1,154 @@
+/**
+ * Constraint Margins Test Suite
+ *
+ * Places one slot of a hand-built palette a known distance from a rule and
+ * checks that margins::Analyzer reports that distance and names that rule:
+ * an APCA minimum crossed in 8-bit steps and along L, a readability pair,
+ * a constraint box edge and a bright slot's hue drift. The rules sit in
+ * different sections of the signature, so a cause only comes out right if
+ * describe() walks the entries in signature() order.
+ *
+ * Build: g++ -std=c++17 -O2 margins_test.cpp -o margins_test -lpthread
+ * Run: ./margins_test
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <string>
+
+#include "margins.hpp"
+
+#define STEPS 3  // 8-bit steps from the moved slot to its threshold
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+static void check(const char* name, bool ok) {
+    tests_run++;
+    if (!ok) tests_failed++;
+    printf("  %s %s\n", ok ? "✓" : "✗", name);
+}
+
+static const char* names[16] = {
+    "black", "red", "green", "yellow", "blue", "magenta", "cyan", "white",
+    "br.black", "br.red", "br.green", "br.yellow", "br.blue", "br.magenta", "br.cyan", "br.white"
+};
+
+// Every slot but green and br.green is black: the pairs among them never
+// change, and green's pairs with any of them flip together with green on black
+static double palette[16 * 3] = {
+    0, 0, 0,  0, 0, 0,  40, 150, 40,  0, 0, 0,  0, 0, 0,    0, 0, 0,  0, 0, 0,  0, 0, 0,
+    0, 0, 0,  0, 0, 0,  60, 110, 60,  0, 0, 0,  0, 0, 0,    0, 0, 0,  0, 0, 0,  0, 0, 0,
+};
+
+// Black fixed; every other slot free inside a box that covers all of OKLCH
+static void open_rules(OklchSlotConstraint* rules) {
+    for (int i = 0; i < 16; i++) rules[i] = {0.0, 180.0, 0.0, 1.0, 0.0, 0.4, i == BLACK, 0, 0, 0, -1, 0.0};
+}
+
+// |Lc| of green with G = v on black, or of black text on it
+static double lc_green(const double* rgb, double v, bool on_black) {
+    color::apca::Prepared fg = fitness::slot_from_srgb(rgb[0], v, rgb[2]).lum;
+    color::apca::Prepared bg = fitness::slot_from_srgb(0, 0, 0).lum;
+    return fabs(on_black ? color::apca::contrast_prepared(fg, bg) : color::apca::contrast_prepared(bg, fg));
+}
+
+static const margins::Limit& limit(const margins::Report& r, int slot, int variable, int direction) {
+    return r.slots[slot].limit[variable][direction];
+}
+
+void test_apca_minimum() {
+    printf("\nAPCA minimum (green on black):\n");
+    OklchSlotConstraint rules[16];
+    open_rules(rules);
+    const double* g = &palette[GREEN * 3];
+    // Threshold between STEPS - 1 and STEPS steps of G+
+    double min_apca = 0.5 * (lc_green(g, g[1] + STEPS - 1, true) + lc_green(g, g[1] + STEPS, true));
+    ApcaPairConstraint pairs[] = {{GREEN, BLACK, min_apca, 0.0, POLARITY_ANY}};
+    margins::Analyzer analyzer(palette, rules, pairs, 1, names);
+    margins::Report report = analyzer.analyze();
+
+    char cause[64];
+    snprintf(cause, sizeof(cause), "green on black: APCA minimum %.0f", min_apca);
+    const margins::Limit& step = limit(report, GREEN, 4, 1);
+    check("G+ flips after the known step count", step.distance == STEPS);
+    check("G+ cause is the pair minimum", step.cause == cause);
+    check("G+ is the tightest channel",
+          report.tight_slot == GREEN && report.tight_channel == 1 && report.tight_direction == 1);
+
+    // L+ margin: bisect the lightness at which the pair reaches min_apca
+    const fitness::SlotColor& base = analyzer.base(GREEN);
+    double lo = base.L, hi = 1.0;
+    fitness::SlotColor bg = fitness::slot_from_srgb(0, 0, 0);
+    while (hi - lo > 1e-7) {
+        double mid = 0.5 * (lo + hi);
+        fitness::SlotColor s = fitness::slot_from_oklch(mid, base.C, base.H);
+        if (fabs(color::apca::contrast_prepared(s.lum, bg.lum)) >= min_apca) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    const margins::Limit& axis = limit(report, GREEN, 0, 1);
+    check("L+ distance matches the bisected lightness", fabs(axis.distance - (lo - base.L)) < 2e-5);
+    check("L+ cause is the pair minimum", axis.cause == cause);
+}
+
+void test_readability() {
+    printf("\nReadability (black on green):\n");
+    OklchSlotConstraint rules[16];
+    open_rules(rules);
+    double moved[16 * 3];
+    std::copy(palette, palette + 16 * 3, moved);
+    // Darken green's G from 255 until STEPS steps of G- take black on it below
+    // Lc 40; green on black, with its lower Lc, is already below
+    double* g = &moved[GREEN * 3];
+    g[1] = 255;
+    while (lc_green(g, g[1] - (STEPS - 1), false) >= margins::READABLE_APCA) g[1]--;
+    g[1]++;
+    margins::Analyzer analyzer(moved, rules, nullptr, 0, names);
+    margins::Report report = analyzer.analyze();
+    const margins::Limit& step = limit(report, GREEN, 4, 0);
+    check("G- flips after the known step count", step.distance == STEPS);
+    check("G- cause is the first readability pair", step.cause == "black on green: readability 40");
+}
+
+void test_constraint_box() {
+    printf("\nConstraint box (green max_L):\n");
+    OklchSlotConstraint rules[16];
+    open_rules(rules);
+    margins::Analyzer probe(palette, rules, nullptr, 0, names);
+    rules[GREEN].max_L = probe.base(GREEN).L + 0.005;
+    margins::Analyzer analyzer(palette, rules, nullptr, 0, names);
+    margins::Report report = analyzer.analyze();
+    const margins::Limit& axis = limit(report, GREEN, 0, 1);
+    check("L+ distance reaches max_L", fabs(axis.distance - 0.005) < 2e-5);
+    check("L+ cause is the box", axis.cause == "green: constraint box");
+}
+
+void test_hue_drift() {
+    printf("\nHue drift (br.green from green):\n");
+    OklchSlotConstraint rules[16];
+    open_rules(rules);
+    rules[BR_GREEN].base_slot = GREEN;
+    rules[BR_GREEN].max_hue_drift = 10.0;
+    margins::Analyzer analyzer(palette, rules, nullptr, 0, names);
+    double drift = color::hue_distance(analyzer.base(BR_GREEN).H, analyzer.base(GREEN).H);
+    margins::Report report = analyzer.analyze();
+    // The signed hue difference decides which direction drifts away first
+    double away = fmod(analyzer.base(BR_GREEN).H - analyzer.base(GREEN).H + 540.0, 360.0) - 180.0;
+    const margins::Limit& axis = limit(report, BR_GREEN, 2, away >= 0.0 ? 1 : 0);
+    check("H distance reaches max_hue_drift", fabs(axis.distance - (10.0 - drift)) < 2e-3);
+    check("H cause is the drift", axis.cause == "br.green: hue drift");
+}
+
+int main() {
+    test_apca_minimum();
+    test_readability();
+    test_constraint_box();
+    test_hue_drift();
+
+    printf("\n%d tests, %d failed\n", tests_run, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,199 @@
+/**
+ * Memory Plan Module - Device and host footprint of a solve
+ *
+ * Lists every buffer a solve allocates for a given configuration and
+ * population, so the population can be chosen from a memory budget instead
+ * of by trial and OOM:
+ *
+ *   device, whole run:  two populations, fitness, RNG states, elite indices,
+ *                       xterm pair table
+ *   device, one phase:  hierarchical lattice, decompose groups, or the
+ *                       semantic populations (run after the main GA while its
+ *                       buffers are still allocated, never together)
+ *   host:               fitness copy and elite sort indices of the GA loop,
+ *                       snapshot staging (two double buffers) and block
+ *
+ * A budget covers device and host together: a plan fits when the device peak
+ * plus the host peak is within it.
+ *
+ * Device allocations are rounded up to the allocator's granularity. The
+ * footprint is exact up to the CUDA context itself, which cudaMemGetInfo()
+ * already leaves out of the free memory it reports.
+ */
+
+#ifndef MEMORY_PLAN_HPP
+#define MEMORY_PLAN_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+#include "snapshot.hpp"
+
+namespace memory_plan {
+
+// cudaMalloc rounds large allocations to 2 MiB pages and small ones to 512 B
+constexpr size_t SMALL_GRANULE = 512;
+constexpr size_t LARGE_GRANULE = 2u << 20;
+
+inline size_t device_bytes(size_t bytes) {
+    size_t granule = bytes > LARGE_GRANULE / 2 ? LARGE_GRANULE : SMALL_GRANULE;
+    return (bytes + granule - 1) / granule * granule;
+}
+
+// Phases whose device buffers are never alive at the same time
+enum Phase { WHOLE_RUN, LATTICE, DECOMPOSE, SEMANTIC, PHASE_COUNT };
+
+constexpr const char* phase_names[PHASE_COUNT] = {"whole run", "lattice", "decompose", "semantic"};
+
+struct Config {
+    int n_genes = 0;                 // free slots of the main genome
+    double elite_ratio = 0.1;
+    size_t rng_state_bytes = 48;     // sizeof(curandState)
+    size_t ext_pair_bytes = 0;       // xterm pair table
+    int lattice_cells = 0;           // hierarchical: n_slots * top_k (0 = off)
+    int lattice_slots = 0;
+    int decompose_groups = 0;        // decompose: slot groups (0 = off)
+    int decompose_slots = 0;         // decompose: slots over all groups
+    int semantic_genes = 0;          // semantic: free slots, upper bound (0 = off)
+    size_t semantic_table_bytes = 0; // semantic: edge offsets and edges
+    int snapshot_rows = 0;           // 0 = no snapshots
+    int snapshot_slots = 0;
+    int snapshot_terms = 0;
+};
+
+struct Item {
+    const char* name;
+    bool device;
+    Phase phase;
+    size_t bytes;
+};
+
+struct Plan {
+    int population = 0;
+    std::vector<Item> items;
+    size_t device_peak = 0;  // whole run plus the largest phase
+    size_t host_peak = 0;
+};
+
+inline Plan plan(const Config& c, int population) {
+    Plan p;
+    p.population = population;
+    size_t n = (size_t)population;
+    size_t genome = (size_t)c.n_genes * 3 * sizeof(double);
+    size_t elites = (size_t)std::max(1, (int)(population * c.elite_ratio));
+
+    auto device = [&](const char* name, Phase phase, size_t bytes) {
+        p.items.push_back({name, true, phase, device_bytes(bytes)});
+    };
+    auto host = [&](const char* name, size_t bytes) {
+        p.items.push_back({name, false, WHOLE_RUN, bytes});
+    };
+
+    device("population", WHOLE_RUN, n * genome);
+    device("offspring", WHOLE_RUN, n * genome);
+    device("fitness", WHOLE_RUN, n * sizeof(double));
+    device("rng states", WHOLE_RUN, n * c.rng_state_bytes);
+    device("elite indices", WHOLE_RUN, elites * sizeof(int));
+    if (c.ext_pair_bytes > 0) {
+        device("xterm pairs", WHOLE_RUN, c.ext_pair_bytes);
+    }
+    if (c.lattice_cells > 0) {
+        device("lattice points", LATTICE, (size_t)c.lattice_cells * 3 * sizeof(double));
+        device("lattice cells", LATTICE, (size_t)c.lattice_slots * 3 * sizeof(double));
+    }
+    if (c.decompose_groups > 0) {
+        // Candidates reuse the offspring buffer
+        device("group offsets", DECOMPOSE, (size_t)(c.decompose_groups + 1) * sizeof(int));
+        device("group slots", DECOMPOSE, (size_t)c.decompose_slots * sizeof(int));
+        device("group scales", DECOMPOSE, (size_t)c.decompose_groups * sizeof(double));
+        device("group best", DECOMPOSE, genome);
+    }
+    if (c.semantic_genes > 0) {
+        size_t semantic_genome = (size_t)c.semantic_genes * 3 * sizeof(double);
+        device("semantic population", SEMANTIC, n * semantic_genome);
+        device("semantic offspring", SEMANTIC, n * semantic_genome);
+        device("semantic edges", SEMANTIC, c.semantic_table_bytes);
+    }
+
+    host("fitness copy", n * sizeof(double) * 2);  // GA loop and report
+    host("elite sort", n * sizeof(int) + elites * sizeof(int));
+    if (c.snapshot_rows > 0) {
+        int rows = std::min(c.snapshot_rows, population);
+        host("snapshot staging", 2 * (size_t)rows * (genome + sizeof(double) + sizeof(int32_t)));
+        host("snapshot block", snapshot::block_layout(c.snapshot_slots, c.snapshot_terms, rows).bytes);
+    }
+
+    size_t phase_bytes[PHASE_COUNT] = {};
+    for (const Item& item : p.items) {
+        if (item.device) {
+            phase_bytes[item.phase] += item.bytes;
+        } else {
+            p.host_peak += item.bytes;
+        }
+    }
+    p.device_peak = phase_bytes[WHOLE_RUN] + *std::max_element(phase_bytes + 1, phase_bytes + PHASE_COUNT);
+    return p;
+}
+
+inline bool fits(const Plan& p, size_t budget) {
+    return p.device_peak + p.host_peak <= budget;
+}
+
+/**
+ * Largest population whose device and host peaks together fit the budget,
+ * or 0 if not even min_population does. The footprint grows with the
+ * population, so a binary search over it is exact.
+ */
+inline int max_population(const Config& c, size_t budget, int min_population) {
+    if (!fits(plan(c, min_population), budget)) return 0;
+    int lo = min_population, hi = 1 << 30;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (fits(plan(c, mid), budget)) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Parse a byte count with an optional K, M or G suffix (powers of 1024),
+ * e.g. "512M" or "1.5G". Returns false on malformed or zero sizes.
+ */
+inline bool parse_size(const char* text, size_t* out) {
+    char* end;
+    double value = strtod(text, &end);
+    double scale = 1.0;
+    switch (*end) {
+        case 'k': case 'K': scale = 1024.0; end++; break;
+        case 'm': case 'M': scale = 1024.0 * 1024.0; end++; break;
+        case 'g': case 'G': scale = 1024.0 * 1024.0 * 1024.0; end++; break;
+        default: break;
+    }
+    if (*end == 'B' || *end == 'b') end++;
+    if (end == text || *end != '\0' || !(value > 0.0)) return false;
+    *out = (size_t)(value * scale);
+    return true;
+}
+
+inline double mib(size_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+inline void print_plan(const Plan& p) {
+    printf("Memory plan for population %d:\n", p.population);
+    for (const Item& item : p.items) {
+        printf("  %-6s %-20s %-10s %10.1f MiB\n", item.device ? "device" : "host", item.name,
+               phase_names[item.phase], mib(item.bytes));
+    }
+    printf("  device peak %.1f MiB, host peak %.1f MiB\n", mib(p.device_peak), mib(p.host_peak));
+}
+
+} // namespace memory_plan
+
+#endif // MEMORY_PLAN_HPP
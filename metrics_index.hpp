@@ -0,0 +1,256 @@
+/**
+ * Metrics Index Module - Shared memory-mapped index of theme metrics
+ *
+ * One file, mapped MAP_SHARED by the writer (theme-watch) and any number of
+ * readers (theme-analyzer.py, dashboards). Fixed-size records, so readers
+ * index it directly without parsing:
+ *
+ *   Header  (64 bytes)       magic "HXMIDX01", capacity, record_size,
+ *                            count (records in use), generation
+ *   Record[capacity]         RECORD_SIZE bytes each, see Record
+ *
+ * Updates are atomic per record with a seqlock: the writer makes seq odd,
+ * writes the fields, then makes seq even again (release). A reader copies a
+ * record between two equal, even loads of seq and retries otherwise, so it
+ * never sees a half-written record. New records are filled before count is
+ * raised; generation increases after every batch, so a reader can poll one
+ * word to learn that something changed.
+ *
+ * The file is created at full size under a temporary name and linked into
+ * place, so a reader never maps a partial header. There is one writer.
+ */
+
+#ifndef METRICS_INDEX_HPP
+#define METRICS_INDEX_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "theme_metrics.hpp"
+
+namespace metrics_index {
+
+constexpr char MAGIC[8] = {'H', 'X', 'M', 'I', 'D', 'X', '0', '1'};
+constexpr int NAME_SIZE = 112;
+
+enum State : uint32_t { EMPTY = 0, VALID = 1, REMOVED = 2 };
+
+struct Header {
+    char magic[8];
+    uint32_t capacity;
+    uint32_t record_size;
+    uint32_t count;        // atomic: records [0, count) are initialized
+    uint32_t reserved0;
+    uint64_t generation;   // atomic: bumped after every batch of updates
+    uint8_t reserved[32];
+};
+
+struct Record {
+    uint32_t seq;          // atomic seqlock counter, odd while being written
+    uint32_t state;        // State
+    char name[NAME_SIZE];  // file name within the watched directory
+    int64_t mtime_ns;      // of the indexed file version
+    int64_t size;
+    double fitness;
+    double worst_margin;
+    double min_distance;
+    double min_hue_spacing;
+    int32_t rules_met;
+    int32_t rules_total;
+    int32_t worst_rule;
+    uint8_t rgb[48];       // 16 slots x (r, g, b)
+    uint8_t reserved[4];
+};
+
+constexpr size_t RECORD_SIZE = 232;
+static_assert(sizeof(Header) == 64, "index header layout");
+static_assert(sizeof(Record) == RECORD_SIZE, "index record layout");
+static_assert(offsetof(Record, fitness) == 136, "index record layout");
+
+inline size_t file_size(uint32_t capacity) {
+    return sizeof(Header) + (size_t)capacity * RECORD_SIZE;
+}
+
+/**
+ * Consistent copy of a record (seqlock read). Usable by any reader.
+ */
+inline Record read(const Record& r) {
+    Record copy;
+    for (;;) {
+        uint32_t s1 = __atomic_load_n(&r.seq, __ATOMIC_ACQUIRE);
+        if (s1 & 1) continue;
+        memcpy(&copy, &r, sizeof(Record));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&r.seq, __ATOMIC_RELAXED) == s1) return copy;
+    }
+}
+
+/**
+ * Writer side: owns the mapping and a name -> record map.
+ */
+class Index {
+public:
+    ~Index() { close(); }
+
+    /**
+     * Map the index at path, creating it with the given capacity if missing.
+     */
+    bool open(const char* path, uint32_t capacity) {
+        int fd = ::open(path, O_RDWR);
+        if (fd < 0 && !create(path, capacity)) {
+            printf("Error: Could not create index %s\n", path);
+            return false;
+        }
+        if (fd < 0) fd = ::open(path, O_RDWR);
+        if (fd < 0) return false;
+
+        struct stat st;
+        Header h;
+        bool ok = fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(Header) &&
+                  pread(fd, &h, sizeof(h), 0) == (ssize_t)sizeof(h) &&
+                  memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 && h.record_size == RECORD_SIZE &&
+                  (size_t)st.st_size == file_size(h.capacity);
+        if (!ok) {
+            ::close(fd);
+            printf("Error: %s is not a metrics index of this version\n", path);
+            return false;
+        }
+        void* p = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        base_ = (uint8_t*)p;
+        mapped_bytes_ = st.st_size;
+        for (uint32_t i = 0; i < header()->count; i++) {
+            const Record& r = records()[i];
+            if (r.state != EMPTY) slots_[r.name] = i;
+        }
+        return true;
+    }
+
+    void close() {
+        if (!base_) return;
+        msync(base_, mapped_bytes_, MS_ASYNC);
+        munmap(base_, mapped_bytes_);
+        base_ = nullptr;
+        slots_.clear();
+    }
+
+    Header* header() { return (Header*)base_; }
+    Record* records() { return (Record*)(base_ + sizeof(Header)); }
+    uint32_t count() { return header()->count; }
+
+    // Record of a file name, nullptr if never indexed
+    const Record* find(const std::string& name) {
+        auto it = slots_.find(name);
+        return it == slots_.end() ? nullptr : &records()[it->second];
+    }
+
+    /**
+     * Insert or update the record of name. False if the index is full or the
+     * name does not fit.
+     */
+    bool put(const std::string& name, int64_t mtime_ns, int64_t size,
+             const theme_metrics::Palette& p, const theme_metrics::Metrics& m) {
+        if (name.size() >= (size_t)NAME_SIZE) return false;
+        uint32_t slot;
+        bool fresh = false;
+        auto it = slots_.find(name);
+        if (it != slots_.end()) {
+            slot = it->second;
+        } else {
+            slot = header()->count;
+            if (slot >= header()->capacity) return false;
+            fresh = true;
+        }
+
+        Record r = {};
+        r.state = VALID;
+        strncpy(r.name, name.c_str(), NAME_SIZE - 1);
+        r.mtime_ns = mtime_ns;
+        r.size = size;
+        r.fitness = m.fitness;
+        r.worst_margin = m.worst_margin;
+        r.min_distance = m.min_distance;
+        r.min_hue_spacing = m.min_hue_spacing;
+        r.rules_met = m.rules_met;
+        r.rules_total = m.rules_total;
+        r.worst_rule = m.worst_rule;
+        memcpy(r.rgb, p.rgb, sizeof(r.rgb));
+        write(slot, r);
+
+        if (fresh) {
+            slots_[name] = slot;
+            __atomic_store_n(&header()->count, slot + 1, __ATOMIC_RELEASE);
+        }
+        return true;
+    }
+
+    void remove(const std::string& name) {
+        auto it = slots_.find(name);
+        if (it == slots_.end()) return;
+        Record r = read(records()[it->second]);
+        if (r.state == REMOVED) return;
+        r.state = REMOVED;
+        write(it->second, r);
+    }
+
+    // Names of all live records
+    template <typename Fn>
+    void for_each_valid(Fn fn) {
+        for (const auto& kv : slots_) {
+            if (records()[kv.second].state == VALID) fn(kv.first, records()[kv.second]);
+        }
+    }
+
+    uint64_t publish() {
+        return __atomic_add_fetch(&header()->generation, 1, __ATOMIC_RELEASE);
+    }
+
+private:
+    // Seqlock write; the seq field of r is ignored
+    void write(uint32_t slot, const Record& r) {
+        Record& dst = records()[slot];
+        uint32_t seq = __atomic_load_n(&dst.seq, __ATOMIC_RELAXED);
+        __atomic_store_n(&dst.seq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy((uint8_t*)&dst + sizeof(uint32_t), (const uint8_t*)&r + sizeof(uint32_t),
+               sizeof(Record) - sizeof(uint32_t));
+        __atomic_store_n(&dst.seq, seq + 2, __ATOMIC_RELEASE);
+    }
+
+    static bool create(const char* path, uint32_t capacity) {
+        std::string tmp = std::string(path) + ".tmp." + std::to_string(getpid());
+        int fd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        Header h = {};
+        memcpy(h.magic, MAGIC, sizeof(h.magic));
+        h.capacity = capacity;
+        h.record_size = RECORD_SIZE;
+        bool ok = ftruncate(fd, file_size(capacity)) == 0 &&
+                  pwrite(fd, &h, sizeof(h), 0) == (ssize_t)sizeof(h);
+        ::close(fd);
+        // link() fails if another writer created the index first; use theirs
+        ok = ok && (link(tmp.c_str(), path) == 0 || errno == EEXIST);
+        unlink(tmp.c_str());
+        return ok;
+    }
+
+    uint8_t* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    std::unordered_map<std::string, uint32_t> slots_;
+};
+
+} // namespace metrics_index
+
+#endif // METRICS_INDEX_HPP
@@ -0,0 +1,108 @@
+# Editor semantic palette for hexa-color-solver --semantic
+#
+#   slot <name> <hue> <tol> <min_L> <max_L> <min_C> <max_C>
+#   slot <name> fixed #rrggbb
+#   slot <name> ansi <0-15>
+#   rule <fg> <bg> <min_apca> [target_apca]
+
+# Backgrounds
+slot bg                ansi 0
+slot bg.cursorline     fixed #161616
+slot bg.selection      260  30  0.28 0.36  0.03 0.08
+slot bg.search         85   25  0.34 0.42  0.06 0.12
+slot bg.diff.add       145  25  0.22 0.30  0.03 0.08
+slot bg.diff.delete    25   25  0.22 0.30  0.03 0.08
+slot bg.diff.change    250  25  0.22 0.30  0.03 0.08
+
+# Text
+slot text              ansi 7
+slot text.muted        0    180 0.60 0.70  0.00 0.02
+slot comment           0    180 0.55 0.65  0.00 0.03
+
+# Syntax
+slot keyword           300  20  0.70 0.82  0.10 0.20
+slot keyword.control   320  20  0.70 0.82  0.10 0.20
+slot string            145  20  0.75 0.86  0.10 0.18
+slot string.escape     170  20  0.75 0.86  0.08 0.15
+slot regex             190  20  0.75 0.86  0.08 0.15
+slot number            55   20  0.74 0.84  0.10 0.18
+slot constant          40   20  0.72 0.84  0.10 0.18
+slot function          250  20  0.75 0.86  0.08 0.16
+slot function.builtin  230  20  0.75 0.86  0.06 0.14
+slot type              195  20  0.78 0.88  0.06 0.14
+slot type.builtin      210  20  0.76 0.86  0.06 0.14
+slot variable          0    180 0.84 0.92  0.00 0.02
+slot parameter         70   20  0.82 0.90  0.04 0.10
+slot property          220  25  0.80 0.88  0.03 0.08
+slot operator          0    180 0.72 0.80  0.00 0.03
+slot punctuation       0    180 0.66 0.74  0.00 0.02
+slot tag               15   20  0.70 0.82  0.10 0.18
+slot attribute         85   20  0.78 0.88  0.08 0.15
+slot link              240  20  0.72 0.84  0.10 0.18
+
+# Diagnostics
+slot error             25   12  0.64 0.74  0.15 0.22
+slot warning           75   12  0.78 0.86  0.12 0.18
+slot info              240  15  0.70 0.80  0.10 0.16
+slot hint              180  15  0.70 0.80  0.06 0.12
+
+# Diff foregrounds
+slot diff.add          145  15  0.72 0.84  0.12 0.20
+slot diff.delete       25   15  0.64 0.76  0.14 0.22
+slot diff.change       250  15  0.70 0.82  0.10 0.18
+
+# Body text on the main background
+rule text              bg            90
+rule variable          bg            80   90
+rule keyword           bg            60   70
+rule keyword.control   bg            60   70
+rule string            bg            60   70
+rule string.escape     bg            60   70
+rule regex             bg            60   70
+rule number            bg            60   70
+rule constant          bg            60   70
+rule function          bg            60   70
+rule function.builtin  bg            60   70
+rule type              bg            60   70
+rule type.builtin      bg            60   70
+rule parameter         bg            60   75
+rule property          bg            60   75
+rule tag               bg            60   70
+rule attribute         bg            60   70
+rule link              bg            60   70
+rule operator          bg            50   60
+rule punctuation       bg            45   55
+rule comment           bg            40   45
+rule text.muted        bg            45   50
+
+# Readable on the cursor line and selection
+rule text              bg.cursorline 85
+rule keyword           bg.cursorline 55
+rule string            bg.cursorline 55
+rule function          bg.cursorline 55
+rule comment           bg.cursorline 35
+rule text              bg.selection  60
+rule keyword           bg.selection  40
+rule string            bg.selection  40
+rule function          bg.selection  40
+rule comment           bg.selection  25
+rule text              bg.search     55
+
+# Diagnostics
+rule error             bg            55
+rule warning           bg            60
+rule info              bg            55
+rule hint              bg            50
+rule error             bg.cursorline 50
+rule warning           bg.cursorline 55
+
+# Diffs: foreground on its own background, and text on each background
+rule diff.add          bg            55
+rule diff.delete       bg            55
+rule diff.change       bg            55
+rule diff.add          bg.diff.add   45
+rule diff.delete       bg.diff.delete 45
+rule diff.change       bg.diff.change 45
+rule text              bg.diff.add   70
+rule text              bg.diff.delete 70
+rule text              bg.diff.change 70
@@ -0,0 +1,432 @@
+/**
+ * Cross-Backend Parity Test Suite
+ *
+ * Feeds one seeded population through every evaluation path that runs on the
+ * host and compares it with the double-precision reference, i.e. the path
+ * the solver takes per individual (genome::decode, then palette_score and
+ * cvd_terms of fitness.cuh):
+ *
+ *   conversions  batched APCA luminance, lookup table entries and the Oklab
+ *                round trip against the per-color reference conversions
+ *   batch        contrast terms via luminance_batch (the --robust path) with
+ *                the ideal display model only
+ *   direct       contrast terms via contrast_y per pair instead of the
+ *                prepared exponent powers
+ *   lut          palette rounded to 8-bit sRGB, converted through the float
+ *                lookup table (quantize polish) vs. the same bytes in double
+ *   threads      the CPU backend with one and with several pool workers
+ *                (must agree bit for bit)
+ *   slot_cache   the CPU backend with and without the shared slot conversion
+ *                cache (must agree bit for bit, and the cache must be shared)
+ *   pipeline     pipelined generations with one and with several workers
+ *                (must agree bit for bit)
+ *   pipeline_lag pipelined generations that wait for the whole previous
+ *                generation against the barrier loop (must agree bit for bit)
+ *
+ * Each case reports the max difference of every fitness term and the elite
+ * ranking inversions: pairs whose reference order is decided by more than
+ * the case's total tolerance but flips under the variant. A case fails when
+ * a difference exceeds its threshold or any inversion is found.
+ *
+ * The lookup table is mapped like the solver does ($HEXA_LUT, srgb-lut.bin);
+ * without a file the entries are computed with lut::compute_entry, which
+ * yields the same float values lut-gen writes.
+ *
+ * Build: g++ -std=c++17 -O2 parity_test.cpp -o parity_test -lpthread
+ * Run: ./parity_test              (all cases)
+ *      ./parity_test lut          (one case)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "cpu_backend.hpp"
+#include "lut.hpp"
+#include "quantize.hpp"
+#include "rules.cuh"
+
+// Test configuration
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define POPULATION 4096
+#define SEED 0x5eedull
+
+void check_max(const char* test_name, double max_diff, double threshold) {
+    tests_run++;
+    if (max_diff <= threshold) {
+        tests_passed++;
+        printf("  ✓ %-28s max |diff| %.3e <= %.0e\n", test_name, max_diff, threshold);
+    } else {
+        tests_failed++;
+        printf("  ✗ %-28s max |diff| %.3e >  %.0e\n", test_name, max_diff, threshold);
+    }
+}
+
+void check_inversions(const char* test_name, int inversions, int elite, int membership) {
+    tests_run++;
+    if (inversions == 0) {
+        tests_passed++;
+        printf("  ✓ %s: no inversions (top %d, %d swapped at the boundary)\n",
+               test_name, elite, membership);
+    } else {
+        tests_failed++;
+        printf("  ✗ %s: %d inversions (top %d, %d swapped at the boundary)\n",
+               test_name, inversions, elite, membership);
+    }
+}
+
+// =============================================================================
+// Seeded population and reference terms
+// =============================================================================
+
+enum Term { PERCEPTUAL, CONTRAST, CVD, TOTAL, TERM_COUNT };
+static const char* term_names[TERM_COUNT] = {"perceptual", "contrast", "cvd", "total"};
+
+struct Terms {
+    double v[TERM_COUNT];
+};
+
+struct Population {
+    genome::Layout layout;
+    int n;
+    int stride;
+    std::vector<double> genomes;
+    std::vector<std::vector<fitness::SlotColor>> slots;  // decoded, reference path
+};
+
+static color::cvd::Matrix cvd_models[color::cvd::DEFICIENCY_COUNT];
+
+/**
+ * Random ANSI genomes drawn like the GA's initial population.
+ */
+Population seeded_population(int n, uint64_t seed) {
+    Population p;
+    p.layout = genome::build_layout(oklch_slot_constraints, 16);
+    p.n = n;
+    p.stride = p.layout.genes() * 3;
+    p.genomes.resize((size_t)n * p.stride);
+    p.slots.assign(n, std::vector<fitness::SlotColor>(16));
+    for (int i = 0; i < n; i++) {
+        cpu::HostRng rng = cpu::stream(seed, i);
+        double* g = &p.genomes[(size_t)i * p.stride];
+        for (int k = 0; k < p.layout.genes(); k++) {
+            ga::random_gene(oklch_slot_constraints[p.layout.gene_slots[k]], rng, &g[k * 3]);
+        }
+        genome::decode(p.layout, g, p.slots[i].data());
+    }
+    return p;
+}
+
+Terms with_total(Terms t) {
+    t.v[TOTAL] = t.v[PERCEPTUAL] + t.v[CONTRAST] + t.v[CVD];
+    return t;
+}
+
+double cvd_score(const fitness::SlotColor* s) {
+    return fitness::cvd_terms(s, cvd_rules, CVD_RULE_COUNT, cvd_models, color::cvd::DEFICIENCY_COUNT);
+}
+
+Terms reference_terms(const fitness::SlotColor* s) {
+    color::apca::Prepared lum[16];
+    for (int i = 0; i < 16; i++) lum[i] = s[i].lum;
+    Terms t;
+    t.v[PERCEPTUAL] = fitness::perceptual_terms(s, oklch_slot_constraints);
+    t.v[CONTRAST] = fitness::contrast_terms(lum, apca_pair_constraints, APCA_CONSTRAINT_COUNT);
+    t.v[CVD] = cvd_score(s);
+    return with_total(t);
+}
+
+/**
+ * Compare variant terms with reference terms: one max-difference check per
+ * term (thresholds[term] < 0 skips it) plus the elite ranking check.
+ */
+void compare(const char* name, const std::vector<Terms>& ref, const std::vector<Terms>& var,
+             const double* thresholds) {
+    int n = (int)ref.size();
+    for (int t = 0; t < TERM_COUNT; t++) {
+        if (thresholds[t] < 0.0) continue;
+        double max_diff = 0.0;
+        for (int i = 0; i < n; i++) {
+            max_diff = fmax(max_diff, fabs(var[i].v[t] - ref[i].v[t]));
+        }
+        char label[64];
+        snprintf(label, sizeof(label), "%s %s", name, term_names[t]);
+        check_max(label, max_diff, thresholds[t]);
+    }
+
+    // Pairs (elite i, any j) ordered by more than the tolerance that flip
+    int elite = ga::elite_count(ga::default_params(n));
+    double tolerance = 2.0 * thresholds[TOTAL];
+    std::vector<int> ref_order(n), var_order(n);
+    std::iota(ref_order.begin(), ref_order.end(), 0);
+    std::iota(var_order.begin(), var_order.end(), 0);
+    std::sort(ref_order.begin(), ref_order.end(),
+              [&](int a, int b) { return ref[a].v[TOTAL] > ref[b].v[TOTAL]; });
+    std::sort(var_order.begin(), var_order.end(),
+              [&](int a, int b) { return var[a].v[TOTAL] > var[b].v[TOTAL]; });
+
+    int inversions = 0;
+    for (int e = 0; e < elite; e++) {
+        int i = ref_order[e];
+        for (int j = 0; j < n; j++) {
+            if (ref[i].v[TOTAL] - ref[j].v[TOTAL] > tolerance && var[i].v[TOTAL] < var[j].v[TOTAL]) {
+                inversions++;
+            }
+        }
+    }
+    std::vector<bool> in_ref(n, false);
+    for (int e = 0; e < elite; e++) in_ref[ref_order[e]] = true;
+    int membership = 0;
+    for (int e = 0; e < elite; e++) {
+        if (!in_ref[var_order[e]]) membership++;
+    }
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s elite ranking", name);
+    check_inversions(label, inversions, elite, membership);
+}
+
+// =============================================================================
+// Cases
+// =============================================================================
+
+static const color::apca::DisplayModel ideal_display = {2.4, 0.0, 1.0};
+
+/**
+ * Entry of an 8-bit color as stored in the lookup table.
+ */
+color::lut::Entry table_entry(int r, int g, int b) {
+    const lut::Table* t = lut::table();
+    if (t) return t->entries[color::lut::index(r, g, b, t->layout)];
+    return lut::compute_entry(r, g, b);
+}
+
+void test_conversions(const Population& p) {
+    printf("\n== Color conversions (variants vs. double reference) ==\n");
+    printf("  lookup table: %s\n", lut::table() ? "mapped file" : "computed entries (no file)");
+
+    double batch_y = 0.0, lut_y = 0.0, lut_lab = 0.0, roundtrip = 0.0;
+    for (int i = 0; i < p.n; i++) {
+        const double* g = &p.genomes[(size_t)i * p.stride];
+        for (int k = 0; k < 16; k++) {
+            const fitness::SlotColor& s = p.slots[i][k];
+
+            double Y;
+            color::apca::luminance_batch(s.r, s.g, s.b, &ideal_display, 1, &Y);
+            batch_y = fmax(batch_y, fabs(Y - s.lum.Y));
+
+            int r = quantize::channel_byte(s.r);
+            int gr = quantize::channel_byte(s.g);
+            int b = quantize::channel_byte(s.b);
+            color::lut::Entry e = table_entry(r, gr, b);
+            color::oklab::Lab lab = color::oklab::from_srgb(r, gr, b);
+            lut_y = fmax(lut_y, fabs(e.apca_y - color::apca::luminance(r, gr, b)));
+            lut_lab = fmax(lut_lab, fmax(fabs(e.L - lab.L), fmax(fabs(e.a - lab.a), fabs(e.b - lab.b))));
+        }
+        // Genes whose sRGB needed no clamping survive OKLCH -> sRGB -> Oklab
+        for (int k = 0; k < p.layout.genes(); k++) {
+            const fitness::SlotColor& s = p.slots[i][p.layout.gene_slots[k]];
+            if (fmin(s.r, fmin(s.g, s.b)) <= 0.0 || fmax(s.r, fmax(s.g, s.b)) >= 255.0) continue;
+            double h = g[k * 3 + 2] * color::PI / 180.0;
+            double c = g[k * 3 + 1];
+            roundtrip = fmax(roundtrip, fmax(fabs(s.lab.L - g[k * 3 + 0]),
+                                             fmax(fabs(s.lab.a - c * cos(h)), fabs(s.lab.b - c * sin(h)))));
+        }
+    }
+    check_max("batched APCA Y", batch_y, 1e-12);
+    check_max("lookup table APCA Y", lut_y, 1e-7);
+    check_max("lookup table Oklab", lut_lab, 1e-7);
+    check_max("Oklab round trip", roundtrip, 1e-6);  // published matrices invert to ~1e-8
+}
+
+void test_batch(const Population& p, const std::vector<Terms>& ref) {
+    printf("\n== Batched luminance (robust path, ideal display) ==\n");
+    std::vector<Terms> var(p.n);
+    for (int i = 0; i < p.n; i++) {
+        const fitness::SlotColor* s = p.slots[i].data();
+        Terms t = ref[i];
+        double robust = fitness::robust_palette_score(s, oklch_slot_constraints, apca_pair_constraints,
+                                                      APCA_CONSTRAINT_COUNT, &ideal_display, 1, 0.0);
+        t.v[CONTRAST] = robust - t.v[PERCEPTUAL];
+        var[i] = with_total(t);
+    }
+    const double thresholds[TERM_COUNT] = {-1.0, 1e-6, -1.0, 1e-6};
+    compare("batch", ref, var, thresholds);
+}
+
+void test_direct(const Population& p, const std::vector<Terms>& ref) {
+    printf("\n== Per-pair APCA (contrast_y instead of prepared powers) ==\n");
+    std::vector<Terms> var(p.n);
+    for (int i = 0; i < p.n; i++) {
+        const fitness::SlotColor* s = p.slots[i].data();
+        double score = 0.0;
+        for (int k = 0; k < APCA_CONSTRAINT_COUNT; k++) {
+            const ApcaPairConstraint& c = apca_pair_constraints[k];
+            double lc = color::apca::contrast_y(s[c.fg_index].lum.Y, s[c.bg_index].lum.Y);
+            score += fitness::apca_pair_score(c, c.polarity == POLARITY_ANY ? fabs(lc) : lc * c.polarity);
+        }
+        for (int bg = 0; bg < 8; bg++) {
+            for (int fg = 0; fg < 16; fg++) {
+                if (!fitness::is_readability_pair(fg, bg)) continue;
+                score += fitness::readability_score(fabs(color::apca::contrast_y(s[fg].lum.Y, s[bg].lum.Y)));
+            }
+        }
+        Terms t = ref[i];
+        t.v[CONTRAST] = score;
+        var[i] = with_total(t);
+    }
+    const double thresholds[TERM_COUNT] = {-1.0, 1e-9, -1.0, 1e-9};
+    compare("direct", ref, var, thresholds);
+}
+
+void test_lut(const Population& p) {
+    printf("\n== Lookup table (float entries vs. double, same 8-bit sRGB) ==\n");
+    std::vector<Terms> ref(p.n), var(p.n);
+    fitness::SlotColor exact[16], table[16];
+    for (int i = 0; i < p.n; i++) {
+        for (int k = 0; k < 16; k++) {
+            const fitness::SlotColor& s = p.slots[i][k];
+            int r = quantize::channel_byte(s.r);
+            int g = quantize::channel_byte(s.g);
+            int b = quantize::channel_byte(s.b);
+            exact[k] = fitness::slot_from_srgb(r, g, b);
+            table[k] = quantize::slot_from_entry(table_entry(r, g, b), r, g, b);
+        }
+        ref[i] = reference_terms(exact);
+        var[i] = reference_terms(table);
+    }
+    const double thresholds[TERM_COUNT] = {1e-2, 1e-3, 1e-2, 2e-2};
+    compare("lut", ref, var, thresholds);
+}
+
+// The ANSI problem of the CPU backend, scored by the double reference
+cpu::Problem ansi_reference_problem() {
+    cpu::Problem problem = cpu::ansi_problem();
+    problem.score = [](const fitness::SlotColor* s) { return reference_terms(s).v[TOTAL]; };
+    return problem;
+}
+
+// Two CPU backend runs that must agree bit for bit
+void compare_results(const cpu::Result& a, const cpu::Result& b) {
+    double genome_diff = 0.0;
+    for (size_t i = 0; i < a.best_genome.size(); i++) {
+        genome_diff = fmax(genome_diff, fabs(a.best_genome[i] - b.best_genome[i]));
+    }
+    check_max("best fitness", fabs(a.best_fitness - b.best_fitness), 0.0);
+    check_max("best genome", genome_diff, 0.0);
+    check_max("best generation", fabs((double)(a.best_generation - b.best_generation)), 0.0);
+    check_max("generations run", fabs((double)(a.generations_run - b.generations_run)), 0.0);
+}
+
+void test_threads() {
+    printf("\n== CPU backend (1 vs. 4 pool workers) ==\n");
+    cpu::Problem problem = ansi_reference_problem();
+    ga::Params params = ga::default_params(1024);
+    cpu::Options options = {60, SEED, 1, 1e300, 0.0, false, false, 0, 0};
+    cpu::Result serial = cpu::solve(problem, params, options);
+    options.threads = 4;
+    compare_results(serial, cpu::solve(problem, params, options));
+    check_max("generations run (of 60)", fabs((double)(serial.generations_run - 60)), 0.0);
+}
+
+void test_slot_cache() {
+    printf("\n== CPU backend (slot cache off vs. on, 4 pool workers) ==\n");
+    cpu::Problem problem = ansi_reference_problem();
+    // Uniform crossover passes parent genes through, so most triples are shared
+    ga::Params params = ga::default_params(1024);
+    params.crossover = ga::CROSSOVER_UNIFORM;
+    cpu::Options options = {60, SEED, 4, 1e300, 0.0, false, false, 0, 0};
+    cpu::Result direct = cpu::solve(problem, params, options);
+    options.slot_cache = true;
+    cpu::Result cached = cpu::solve(problem, params, options);
+
+    compare_results(direct, cached);
+    // Fraction of lookups that needed their own conversion
+    check_max("conversions per lookup",
+              cached.slot_cache.lookups > 0
+                  ? (double)cached.slot_cache.conversions / cached.slot_cache.lookups : 1.0, 0.5);
+}
+
+void test_pipeline() {
+    printf("\n== CPU backend, pipelined generations (1 vs. 4 workers) ==\n");
+    cpu::Problem problem = ansi_reference_problem();
+    ga::Params params = ga::default_params(1024);
+    cpu::Options options = {60, SEED, 1, 1e300, 0.0, false, false, 16, 0};
+    cpu::Result serial = cpu::solve(problem, params, options);
+    options.threads = 4;
+    compare_results(serial, cpu::solve(problem, params, options));
+    check_max("generations run (of 60)", fabs((double)(serial.generations_run - 60)), 0.0);
+}
+
+void test_pipeline_lag() {
+    printf("\n== CPU backend, pipelined with the full lag vs. generation barriers ==\n");
+    cpu::Problem problem = ansi_reference_problem();
+    // A short stagnation limit makes the adaptive mutation rate move
+    ga::Params params = ga::default_params(1024);
+    params.stagnation_limit = 1;
+    params.mutation_growth = 1.2;
+    cpu::Options options = {60, SEED, 4, 1e300, 0.0, false, false, 0, 0};
+    cpu::Result barrier = cpu::solve(problem, params, options);
+    options.pipeline_chunks = 16;
+    options.pipeline_lag = 15;
+    compare_results(barrier, cpu::solve(problem, params, options));
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+static const char* case_names[] = {"conversions", "batch", "direct", "lut", "threads", "slot_cache", "pipeline", "pipeline_lag"};
+
+int main(int argc, char** argv) {
+    const char* only = argc > 1 ? argv[1] : nullptr;
+    if (only && std::none_of(std::begin(case_names), std::end(case_names),
+                             [&](const char* c) { return strcmp(c, only) == 0; })) {
+        printf("Error: unknown case '%s' (conversions, batch, direct, lut, threads, slot_cache, pipeline, pipeline_lag)\n", only);
+        return 1;
+    }
+    auto selected = [&](const char* c) { return !only || strcmp(c, only) == 0; };
+
+    printf("╔══════════════════════════════════════════════════════════════════╗\n");
+    printf("║              Cross-Backend Parity Test Suite                     ║\n");
+    printf("╚══════════════════════════════════════════════════════════════════╝\n");
+    printf("Population: %d seeded ANSI genomes (seed %#llx)\n", POPULATION, (unsigned long long)SEED);
+
+    for (int d = 0; d < color::cvd::DEFICIENCY_COUNT; d++) {
+        cvd_models[d] = color::cvd::machado_matrix((color::cvd::Deficiency)d, 1.0);
+    }
+    Population p = seeded_population(POPULATION, SEED);
+    std::vector<Terms> ref(p.n);
+    for (int i = 0; i < p.n; i++) {
+        ref[i] = reference_terms(p.slots[i].data());
+    }
+
+    if (selected("conversions")) test_conversions(p);
+    if (selected("batch")) test_batch(p, ref);
+    if (selected("direct")) test_direct(p, ref);
+    if (selected("lut")) test_lut(p);
+    if (selected("threads")) test_threads();
+    if (selected("slot_cache")) test_slot_cache();
+    if (selected("pipeline")) test_pipeline();
+    if (selected("pipeline_lag")) test_pipeline_lag();
+
+    // Summary
+    printf("\n══════════════════════════════════════════════════════════════════\n");
+    printf("Test Summary: %d tests, %d passed, %d failed\n", tests_run, tests_passed, tests_failed);
+    printf("══════════════════════════════════════════════════════════════════\n");
+
+    if (tests_failed > 0) {
+        printf("\n⚠ Some tests failed!\n");
+        return 1;
+    }
+
+    printf("\n✓ All tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,196 @@
+/**
+ * Quantization Module - Final polish on the 8-bit sRGB lattice
+ *
+ * The GA works in continuous OKLCH, but themes ship as #rrggbb. Rounding the
+ * winner can push a pair just below its min_apca, so this pass searches the
+ * integer neighbourhood of the rounded palette instead:
+ * - coordinate-wise: each free slot's R, G, B tries every offset in
+ *   [-radius, radius] with the rest of the palette held, best move kept,
+ *   until a full sweep finds no improvement
+ * - restarts: each restart jitters the rounded palette by up to +-radius per
+ *   channel and descends again; restarts run on all hardware threads
+ *
+ * Candidates are scored through the full-cube lookup table when it is mapped
+ * (see lut.hpp), otherwise through the reference conversions. The returned
+ * score is always recomputed with the reference conversions from the final
+ * integer palette, so it is exactly the score of what gets written.
+ */
+
+#ifndef QUANTIZE_HPP
+#define QUANTIZE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "fitness.cuh"
+#include "lut.hpp"
+
+namespace quantize {
+
+struct Result {
+    std::vector<double> rgb;  // integer-valued sRGB (0-255), n_slots * 3
+    double score;             // reference score of rgb
+    double rounded_score;     // reference score of the plain rounded palette
+    int restarts_improved;    // restarts that beat the unperturbed descent
+};
+
+/**
+ * 0-255 channel value nearest to v.
+ */
+inline int channel_byte(double v) {
+    long r = lround(v);
+    return (int)std::min(255L, std::max(0L, r));
+}
+
+/**
+ * Slot data for an integer sRGB color from its lookup table entry.
+ */
+inline fitness::SlotColor slot_from_entry(const color::lut::Entry& e, int r, int g, int b) {
+    fitness::SlotColor s;
+    s.r = r;
+    s.g = g;
+    s.b = b;
+    s.lum = color::apca::prepare(color::apca::soft_clamp(e.apca_y));
+    s.lab.L = e.L;
+    s.lab.a = e.a;
+    s.lab.b = e.b;
+    double H = atan2(s.lab.b, s.lab.a) * 180.0 / color::PI;
+    s.L = s.lab.L;
+    s.C = sqrt(s.lab.a * s.lab.a + s.lab.b * s.lab.b);
+    s.H = H < 0.0 ? H + 360.0 : H;
+    s.in_gamut = true;
+    return s;
+}
+
+/**
+ * Slot data for an integer sRGB color, from the lookup table when available.
+ */
+inline fitness::SlotColor slot_from_byte(const lut::Table* t, int r, int g, int b) {
+    if (!t) {
+        return fitness::slot_from_srgb(r, g, b);
+    }
+    return slot_from_entry(t->entries[color::lut::index(r, g, b, t->layout)], r, g, b);
+}
+
+/**
+ * Coordinate descent over the free slots' channels; rgb and slots are
+ * updated in place. Returns the final (table) score.
+ */
+template <typename Score>
+double descend(std::vector<int>& rgb, std::vector<fitness::SlotColor>& slots,
+               const std::vector<int16_t>& free_slots, int radius,
+               const lut::Table* t, Score score) {
+    double current = score(slots.data());
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (int slot : free_slots) {
+            int* c = &rgb[slot * 3];
+            for (int ch = 0; ch < 3; ch++) {
+                int start = c[ch];
+                int best_value = start;
+                for (int d = -radius; d <= radius; d++) {
+                    int v = start + d;
+                    if (d == 0 || v < 0 || v > 255) continue;
+                    c[ch] = v;
+                    slots[slot] = slot_from_byte(t, c[0], c[1], c[2]);
+                    double s = score(slots.data());
+                    if (s > current) {
+                        current = s;
+                        best_value = v;
+                    }
+                }
+                c[ch] = best_value;
+                slots[slot] = slot_from_byte(t, c[0], c[1], c[2]);
+                if (best_value != start) improved = true;
+            }
+        }
+    }
+    return current;
+}
+
+/**
+ * Polish a continuous sRGB palette onto the integer lattice.
+ * fixed slots (not in free_slots) are only rounded. score(slots) must be
+ * thread-safe; it is called concurrently from the restart threads.
+ */
+template <typename Score>
+Result polish(const double* rgb_in, int n_slots, const std::vector<int16_t>& free_slots,
+              int radius, int restarts, Score score) {
+    const lut::Table* t = lut::table();
+
+    std::vector<int> rounded(n_slots * 3);
+    for (int i = 0; i < n_slots * 3; i++) {
+        rounded[i] = channel_byte(rgb_in[i]);
+    }
+
+    auto reference_score = [&](const std::vector<int>& rgb) {
+        std::vector<fitness::SlotColor> slots(n_slots);
+        for (int i = 0; i < n_slots; i++) {
+            slots[i] = fitness::slot_from_srgb(rgb[i * 3 + 0], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        }
+        return score(slots.data());
+    };
+
+    // Run 0 descends from the rounded palette; the others from jittered copies
+    int runs = 1 + std::max(0, restarts);
+    std::vector<std::vector<int>> run_rgb(runs, rounded);
+    std::vector<double> run_score(runs, -1e300);
+
+    auto run = [&](int k) {
+        std::vector<int>& rgb = run_rgb[k];
+        if (k > 0) {
+            std::mt19937 rng(k);
+            std::uniform_int_distribution<int> jitter(-radius, radius);
+            for (int slot : free_slots) {
+                for (int ch = 0; ch < 3; ch++) {
+                    int v = rgb[slot * 3 + ch] + jitter(rng);
+                    rgb[slot * 3 + ch] = std::min(255, std::max(0, v));
+                }
+            }
+        }
+        std::vector<fitness::SlotColor> slots(n_slots);
+        for (int i = 0; i < n_slots; i++) {
+            slots[i] = slot_from_byte(t, rgb[i * 3 + 0], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        }
+        run_score[k] = descend(rgb, slots, free_slots, radius, t, score);
+    };
+
+    if (radius > 0) {
+        int n_threads = std::max(1, std::min(runs, (int)std::thread::hardware_concurrency()));
+        std::vector<std::thread> threads;
+        for (int th = 0; th < n_threads; th++) {
+            threads.emplace_back([&, th] {
+                for (int k = th; k < runs; k += n_threads) run(k);
+            });
+        }
+        for (std::thread& th : threads) th.join();
+    }
+
+    int best = 0;
+    int improved = 0;
+    for (int k = 1; k < runs; k++) {
+        if (run_score[k] > run_score[0]) improved++;
+        if (run_score[k] > run_score[best]) best = k;
+    }
+
+    Result result;
+    result.rgb.assign(run_rgb[best].begin(), run_rgb[best].end());
+    result.rounded_score = reference_score(rounded);
+    result.score = reference_score(run_rgb[best]);
+    result.restarts_improved = improved;
+
+    // Table rounding can (rarely) misrank near-ties; never ship worse than rounding
+    if (result.score < result.rounded_score) {
+        result.rgb.assign(rounded.begin(), rounded.end());
+        result.score = result.rounded_score;
+    }
+    return result;
+}
+
+} // namespace quantize
+
+#endif // QUANTIZE_HPP
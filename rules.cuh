@@ -0,0 +1,176 @@
+/**
+ * Rule Tables - Slot constraints and contrast rules of the built-in themes
+ *
+ * Shared by the GPU solver and the host-only tools (CPU backend, autotuner),
+ * so every backend scores against the same tables:
+ * - ANSI slot constraints and APCA pair rules (dark theme)
+ * - Light variant constraints and rules (--dual)
+ * - Color vision deficiency rules (--cvd)
+ * - Display models for robust evaluation (--robust)
+ */
+
+#ifndef RULES_CUH
+#define RULES_CUH
+
+#include "fitness.cuh"
+#include "genome.cuh"
+
+// OKLCH Hue Reference Values (degrees):
+// Red:     ~29°
+// Yellow:  ~110°
+// Green:   ~142°
+// Cyan:    ~195°
+// Blue:    ~264°
+// Magenta: ~328°
+
+// Slot constraints with reasonable OKLCH defaults
+// Format: target_hue, hue_tolerance, min_L, max_L, min_C, max_C, fixed, fixed_r, fixed_g, fixed_b, base_slot, max_hue_drift
+constexpr OklchSlotConstraint oklch_slot_constraints[16] = {
+    // Base colors (0-7)
+    {   0,   0, 0.00, 0.00, 0.00, 0.00, true,    0,   0,   0, -1,  0},  // 0: BLACK (fixed)
+    {  29,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 1: RED (L max for APCA≥60)
+    { 142,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 2: GREEN
+    { 110,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 3: YELLOW
+    { 264,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 4: BLUE (L max for APCA≥60)
+    { 328,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 5: MAGENTA (L max for APCA)
+    { 195,  25, 0.40, 0.90, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 6: CYAN
+    {   0,   0, 0.75, 0.92, 0.00, 0.03, false,   0,   0,   0, -1,  0},  // 7: WHITE (L max for APCA≥85)
+
+    // Bright colors (8-15)
+    {   0,   0, 0.50, 0.60, 0.00, 0.03, false,   0,   0,   0, -1,  0},  // 8: BR_BLACK (L≥0.50 for APCA≥40 on black)
+    {  29,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  1, 20},  // 9: BR_RED (L max for APCA≥80)
+    { 142,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  2, 20},  // 10: BR_GREEN (base=GREEN)
+    { 110,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  3, 20},  // 11: BR_YELLOW (base=YELLOW)
+    { 264,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  4, 20},  // 12: BR_BLUE (L max for APCA≥80)
+    { 328,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  5, 20},  // 13: BR_MAGENTA (L max for APCA≥80)
+    { 195,  25, 0.65, 0.98, 0.12, 0.30, false,   0,   0,   0,  6, 20},  // 14: BR_CYAN (base=CYAN)
+    {   0,   0, 1.00, 1.00, 0.00, 0.00, true,  255, 255, 255, -1,  0},  // 15: BR_WHITE (fixed)
+};
+
+// Fixed slots carry no genes (see genome.cuh)
+constexpr int ANSI_GENE_COUNT = genome::gene_count(oklch_slot_constraints, 16);
+
+// APCA pair constraints: {fg_index, bg_index, min_apca, target_apca, polarity}
+// target_apca > 0 enables uniformity optimization within groups
+const ApcaPairConstraint apca_pair_constraints[] = {
+    // Base colors on black - target 50 for uniformity (all should cluster around this value)
+    {RED,        BLACK, 60.0, 65.0, POLARITY_REVERSE},  // red on black
+    {YELLOW,     BLACK, 60.0, 65.0, POLARITY_REVERSE},  // yellow on black
+    {MAGENTA,    BLACK, 60.0, 65.0, POLARITY_REVERSE},  // magenta on black
+
+    {CYAN,       BLACK, 60.0, 60.0, POLARITY_REVERSE},  // cyan on black
+    {GREEN,      BLACK, 50.0, 50.0, POLARITY_REVERSE},  // green on black
+    {BLUE,       BLACK, 30.0, 30.0, POLARITY_REVERSE},  // blue on black
+    {WHITE,      BLACK, 85.0, 85.0, POLARITY_REVERSE},  // white on black
+
+    // Bright colors on black - target 80 for uniformity
+    {BR_RED,     BLACK, 85.0, 85.0, POLARITY_REVERSE},  // br.red on black
+    {BR_YELLOW,  BLACK, 85.0, 85.0, POLARITY_REVERSE},  // br.yellow on black
+    {BR_MAGENTA, BLACK, 85.0, 85.0, POLARITY_REVERSE},  // br.magenta on black
+
+    // might want to lower
+    {BR_GREEN,   BLACK, 85.0, 85.0, POLARITY_REVERSE},  // br.green on black
+    {BR_BLUE,    BLACK, 85.0, 85.0, POLARITY_REVERSE},  // br.blue on black
+    {BR_CYAN,    BLACK, 85.0, 85.0, POLARITY_REVERSE},  // br.cyan on black
+
+    {BR_BLACK,   BLACK, 40.0, 40.0, POLARITY_REVERSE},  // br.black on black (no uniformity target - standalone)
+};
+
+constexpr int APCA_CONSTRAINT_COUNT = sizeof(apca_pair_constraints) / sizeof(apca_pair_constraints[0]);
+
+// =============================================================================
+// Light variant (--dual)
+// =============================================================================
+
+// Light theme: background is br.white, text is black. Chromatic hues are
+// shared with the dark theme (see dual.cuh), so only L and C differ here.
+constexpr OklchSlotConstraint light_slot_constraints[16] = {
+    {   0,   0, 0.00, 0.00, 0.00, 0.00, true,    0,   0,   0, -1,  0},  // 0: BLACK (fixed, text)
+    {  29,  25, 0.35, 0.62, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 1: RED
+    { 142,  25, 0.35, 0.62, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 2: GREEN
+    { 110,  25, 0.35, 0.62, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 3: YELLOW (dark enough for white bg)
+    { 264,  25, 0.35, 0.62, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 4: BLUE
+    { 328,  25, 0.35, 0.62, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 5: MAGENTA
+    { 195,  25, 0.35, 0.62, 0.08, 0.30, false,   0,   0,   0, -1,  0},  // 6: CYAN
+    {   0,   0, 0.85, 0.94, 0.00, 0.03, false,   0,   0,   0, -1,  0},  // 7: WHITE (light grey, highlights)
+
+    {   0,   0, 0.45, 0.60, 0.00, 0.03, false,   0,   0,   0, -1,  0},  // 8: BR_BLACK (mid grey, comments)
+    {  29,  25, 0.45, 0.72, 0.12, 0.30, false,   0,   0,   0,  1, 20},  // 9: BR_RED
+    { 142,  25, 0.45, 0.72, 0.12, 0.30, false,   0,   0,   0,  2, 20},  // 10: BR_GREEN
+    { 110,  25, 0.45, 0.72, 0.12, 0.30, false,   0,   0,   0,  3, 20},  // 11: BR_YELLOW
+    { 264,  25, 0.45, 0.72, 0.12, 0.30, false,   0,   0,   0,  4, 20},  // 12: BR_BLUE
+    { 328,  25, 0.45, 0.72, 0.12, 0.30, false,   0,   0,   0,  5, 20},  // 13: BR_MAGENTA
+    { 195,  25, 0.45, 0.72, 0.12, 0.30, false,   0,   0,   0,  6, 20},  // 14: BR_CYAN
+    {   0,   0, 1.00, 1.00, 0.00, 0.00, true,  255, 255, 255, -1,  0},  // 15: BR_WHITE (fixed, background)
+};
+
+// Normal polarity: dark text on the light background
+const ApcaPairConstraint light_apca_pair_constraints[] = {
+    {RED,        BR_WHITE, 60.0, 65.0, POLARITY_NORMAL},  // red on white
+    {GREEN,      BR_WHITE, 60.0, 65.0, POLARITY_NORMAL},  // green on white
+    {YELLOW,     BR_WHITE, 55.0, 60.0, POLARITY_NORMAL},  // yellow on white
+    {BLUE,       BR_WHITE, 60.0, 65.0, POLARITY_NORMAL},  // blue on white
+    {MAGENTA,    BR_WHITE, 60.0, 65.0, POLARITY_NORMAL},  // magenta on white
+    {CYAN,       BR_WHITE, 55.0, 60.0, POLARITY_NORMAL},  // cyan on white
+
+    {BR_RED,     BR_WHITE, 45.0, 50.0, POLARITY_NORMAL},  // br.red on white
+    {BR_GREEN,   BR_WHITE, 45.0, 50.0, POLARITY_NORMAL},  // br.green on white
+    {BR_YELLOW,  BR_WHITE, 40.0, 45.0, POLARITY_NORMAL},  // br.yellow on white
+    {BR_BLUE,    BR_WHITE, 45.0, 50.0, POLARITY_NORMAL},  // br.blue on white
+    {BR_MAGENTA, BR_WHITE, 45.0, 50.0, POLARITY_NORMAL},  // br.magenta on white
+    {BR_CYAN,    BR_WHITE, 40.0, 45.0, POLARITY_NORMAL},  // br.cyan on white
+
+    {BR_BLACK,   BR_WHITE, 40.0, 40.0, POLARITY_NORMAL},  // br.black (comments) on white
+    {BLACK,      WHITE,    85.0, 0.0,  POLARITY_NORMAL},  // text on highlight
+};
+
+constexpr int LIGHT_APCA_CONSTRAINT_COUNT = sizeof(light_apca_pair_constraints) / sizeof(light_apca_pair_constraints[0]);
+
+// =============================================================================
+// Color vision deficiency rules (--cvd)
+// =============================================================================
+
+constexpr uint8_t CVD_PROTAN = 1 << color::cvd::PROTAN;
+constexpr uint8_t CVD_DEUTAN = 1 << color::cvd::DEUTAN;
+constexpr uint8_t CVD_TRITAN = 1 << color::cvd::TRITAN;
+constexpr uint8_t CVD_RED_GREEN = CVD_PROTAN | CVD_DEUTAN;
+
+// Format: {a, b, deficiencies, min Oklab distance, min APCA (a on b)}
+const CvdRule cvd_rules[] = {
+    // Red/green axis collapses for protan and deutan
+    {RED,       GREEN,      CVD_RED_GREEN, 0.10, 0.0},
+    {BR_RED,    BR_GREEN,   CVD_RED_GREEN, 0.10, 0.0},
+    {YELLOW,    GREEN,      CVD_RED_GREEN, 0.06, 0.0},
+
+    // Blue/magenta differ mostly in red, lost for protan; tritan shifts both
+    {BLUE,      MAGENTA,    CVD_PROTAN | CVD_TRITAN, 0.08, 0.0},
+    {BR_BLUE,   BR_MAGENTA, CVD_PROTAN | CVD_TRITAN, 0.08, 0.0},
+
+    // Blue/green axis collapses for tritan
+    {GREEN,     CYAN,       CVD_TRITAN, 0.06, 0.0},
+    {BLUE,      CYAN,       CVD_TRITAN, 0.08, 0.0},
+
+    // Red darkens for protans; keep it readable on black
+    {RED,       BLACK,      CVD_PROTAN, 0.0, 30.0},
+    {BR_RED,    BLACK,      CVD_PROTAN, 0.0, 40.0},
+};
+
+constexpr int CVD_RULE_COUNT = sizeof(cvd_rules) / sizeof(cvd_rules[0]);
+
+// =============================================================================
+// Display models for robust evaluation (--robust)
+// =============================================================================
+
+// Real displays differ in transfer curve, black level and peak white.
+// {gamma, black_lift, white_scale}; {2.4, 0.0, 1.0} is the ideal sRGB display.
+const color::apca::DisplayModel display_models[] = {
+    {2.0, 0.0, 1.0}, {2.2, 0.0, 1.0}, {2.4, 0.0, 1.0}, {2.6, 0.0, 1.0},
+    {2.0, 0.0, 0.85}, {2.2, 0.0, 0.85}, {2.4, 0.0, 0.85}, {2.6, 0.0, 0.85},
+    {2.0, 0.005, 1.0}, {2.2, 0.005, 1.0}, {2.4, 0.005, 1.0}, {2.6, 0.005, 1.0},
+    {2.0, 0.005, 0.85}, {2.2, 0.005, 0.85}, {2.4, 0.005, 0.85}, {2.6, 0.005, 0.85},
+};
+
+constexpr int DISPLAY_MODEL_COUNT = sizeof(display_models) / sizeof(display_models[0]);
+static_assert(DISPLAY_MODEL_COUNT <= fitness::MAX_DISPLAY_MODELS, "too many display models");
+
+#endif // RULES_CUH
@@ -0,0 +1,128 @@
+/**
+ * VT Screen Test Suite
+ *
+ * Feeds canned output streams through vt_screen::Screen and checks the
+ * glyph cells it counts per (fg, bg) pair: SGR colors, reverse video,
+ * blanks, erase, scrolling, wrapping and the alternate screen.
+ *
+ * Build: g++ -std=c++17 -O2 screen_test.cpp -o screen_test
+ * Run: ./screen_test
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+
+#include "vt_screen.hpp"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+static const int O = usage::OTHER;
+
+struct Count {
+    int fg, bg;
+    double cells;
+};
+
+/**
+ * Feed `stream` to a fresh width x height screen and compare counts() with
+ * `expected`; every pair not listed must be zero.
+ */
+static void check(const char* name, const char* stream, int width, int height,
+                  std::initializer_list<Count> expected, bool bold_bright = false) {
+    vt_screen::Screen screen(width, height, bold_bright);
+    screen.feed(stream, strlen(stream));
+    double want[usage::SLOTS + 1][usage::SLOTS + 1] = {};
+    for (const Count& c : expected) want[c.fg][c.bg] = c.cells;
+
+    bool ok = true;
+    for (int fg = 0; fg <= usage::SLOTS; fg++) {
+        for (int bg = 0; bg <= usage::SLOTS; bg++) {
+            double got = screen.counts()[fg][bg];
+            if (got != want[fg][bg]) {
+                if (ok) printf("  ✗ %s:", name);
+                printf(" [%d][%d] = %g (expected %g)", fg, bg, got, want[fg][bg]);
+                ok = false;
+            }
+        }
+    }
+    tests_run++;
+    if (ok) {
+        printf("  ✓ %s\n", name);
+    } else {
+        printf("\n");
+        tests_failed++;
+    }
+}
+
+void test_text() {
+    printf("\nText and blanks:\n");
+    check("default colors", "ab", 10, 3, {{7, 0, 2}});
+    check("spaces are blank", "a b  c", 10, 3, {{7, 0, 3}});
+    check("colored spaces are blank", "\033[41m   \033[0m", 10, 3, {});
+    check("space overwrites a glyph", "ab\r ", 10, 3, {{7, 0, 1}});
+    check("UTF-8 sequence is one cell", "\xc3\xa9\xe2\x94\x80", 10, 3, {{7, 0, 2}});
+    check("OSC title is skipped", "\033]0;title\007ab", 10, 3, {{7, 0, 2}});
+    check("DCS ended by ST is skipped", "\033Pq#0\033\\a", 10, 3, {{7, 0, 1}});
+    check("wrap onto the next line", "abcd", 3, 3, {{7, 0, 4}});
+}
+
+void test_sgr() {
+    printf("\nSGR colors:\n");
+    check("fg and bg", "\033[31;44mab\033[0mc", 10, 3, {{1, 4, 2}, {7, 0, 1}});
+    check("bright fg and bg", "\033[92;103mx", 10, 3, {{10, 11, 1}});
+    check("default fg and bg", "\033[31;44m\033[39;49mx", 10, 3, {{7, 0, 1}});
+    check("empty SGR resets", "\033[32m\033[mx", 10, 3, {{7, 0, 1}});
+    check("256-color slot", "\033[38;5;3;48;5;12mx", 10, 3, {{3, 12, 1}});
+    check("256-color cube is other", "\033[38;5;200mx", 10, 3, {{O, 0, 1}});
+    check("truecolor is other", "\033[48;2;1;2;3;31mx", 10, 3, {{1, O, 1}});
+    check("colon subparameters", "\033[38:5:4mx", 10, 3, {{4, 0, 1}});
+    check("bold stays normal", "\033[1;32mx", 10, 3, {{2, 0, 1}});
+    check("bold is bright with bold_bright", "\033[1;32mx\033[22my", 10, 3, {{10, 0, 1}, {2, 0, 1}}, true);
+}
+
+void test_reverse() {
+    printf("\nReverse video:\n");
+    check("swaps fg and bg", "\033[31;44;7mx", 10, 3, {{4, 1, 1}});
+    check("default colors swapped", "\033[7mx\033[27my", 10, 3, {{0, 7, 1}, {7, 0, 1}});
+    check("reverse spaces are blank", "\033[7m    ", 10, 3, {});
+}
+
+void test_erase_scroll() {
+    printf("\nErase and scroll:\n");
+    check("erase line", "abc\033[2K", 10, 3, {});
+    check("erase to end of line", "abcd\033[1;3H\033[K", 10, 3, {{7, 0, 2}});
+    check("erase to start of line", "abcd\033[1;2H\033[1K", 10, 3, {{7, 0, 2}});
+    check("erase display", "ab\r\ncd\033[2J", 10, 3, {});
+    check("erase below", "ab\r\ncd\033[1;2H\033[J", 10, 3, {{7, 0, 1}});
+    check("erase characters", "abcd\033[1;2H\033[2X", 10, 3, {{7, 0, 2}});
+    check("delete characters", "abcd\033[1;1H\033[3P", 10, 3, {{7, 0, 1}});
+    check("insert pushes off the edge", "abcd\033[1;1H\033[2@", 4, 3, {{7, 0, 2}});
+    check("line feed scrolls the top line out", "a\r\nb\r\nc\r\nd", 10, 3, {{7, 0, 3}});
+    check("scroll up", "a\r\nb\r\nc\033[2S", 10, 3, {{7, 0, 1}});
+    check("scroll region keeps lines outside", "a\r\nb\r\nc\033[2;3r\033[3;1H\n\n", 10, 3, {{7, 0, 1}});
+    check("delete lines", "a\r\nb\r\nc\033[1;1H\033[2M", 10, 3, {{7, 0, 1}});
+    check("reverse index scrolls down", "a\r\nb\r\nc\033[1;1H\033M", 10, 3, {{7, 0, 2}});
+    check("full reset", "\033[31mab\033c", 10, 3, {});
+}
+
+void test_alternate_screen() {
+    printf("\nAlternate screen:\n");
+    check("enter shows only the alternate screen", "ab\033[?1049h\033[34mxyz", 10, 3, {{4, 0, 3}});
+    check("leave restores the main screen", "ab\033[?1049hxyz\033[?1049l", 10, 3, {{7, 0, 2}});
+    check("re-entering starts blank", "\033[?1049hxyz\033[?1049l\033[?1049h", 10, 3, {});
+    check("cursor restored on leave", "ab\033[?1049h\033[3;5Hx\033[?1049lc", 10, 3, {{7, 0, 3}});
+    check("mode 47 keeps the cursor", "ab\033[?47h\033[?47lc", 10, 3, {{7, 0, 3}});
+}
+
+int main() {
+    test_text();
+    test_sgr();
+    test_reverse();
+    test_erase_scroll();
+    test_alternate_screen();
+
+    printf("\n%d tests, %d failed\n", tests_run, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,236 @@
+/**
+ * Semantic Palette Module - Named editor colors with sparse contrast rules
+ *
+ * A semantic palette is a list of named slots (keyword, string, diff.add, ...)
+ * each with an OKLCH box, a fixed color, or a reference to a solved ANSI slot,
+ * plus a sparse list of (fg, bg, min Lc, target Lc) contrast edges.
+ *
+ * Edges are stored in CSR form grouped by background, so scoring costs
+ * O(edges) and each background's prepared luminance is loaded once per row.
+ *
+ * Spec file format (one entry per line, '#' starts a comment unless it
+ * begins a color):
+ *   slot <name> <hue> <tol> <min_L> <max_L> <min_C> <max_C>
+ *   slot <name> fixed #rrggbb
+ *   slot <name> ansi <0-15>
+ *   rule <fg> <bg> <min_apca> [target_apca]
+ */
+
+#ifndef SEMANTIC_CUH
+#define SEMANTIC_CUH
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "fitness.cuh"
+
+namespace semantic {
+
+// Slot capacity of the evaluation kernel
+constexpr int MAX_SLOTS = 64;
+
+struct Spec {
+    std::vector<std::string> names;
+    std::vector<OklchSlotConstraint> slots;
+    std::vector<int> ansi_ref;               // ANSI slot the color comes from, -1 if none
+    std::vector<ApcaPairConstraint> rules;   // in file order
+};
+
+// Contrast edges in CSR form: edges of background bg are
+// edges[offsets[bg] .. offsets[bg+1])
+struct EdgeGraph {
+    std::vector<int> offsets;
+    std::vector<ApcaPairConstraint> edges;
+};
+
+// =============================================================================
+// Scoring
+// =============================================================================
+
+/**
+ * Score a semantic palette: gamut validity of every used slot plus every
+ * contrast edge (same reward/penalty as the ANSI pair constraints).
+ */
+COLOR_FUNC inline double semantic_score(const fitness::SlotColor* s, int n_slots,
+                                        const int* offsets, const ApcaPairConstraint* edges) {
+    double score = 0.0;
+    for (int i = 0; i < n_slots; i++) {
+        score += fitness::gamut_score(s[i].in_gamut);
+    }
+
+    for (int bg = 0; bg < n_slots; bg++) {
+        const color::apca::Prepared& bg_lum = s[bg].lum;
+        for (int e = offsets[bg]; e < offsets[bg + 1]; e++) {
+            double apca = fitness::pair_contrast(edges[e], s[edges[e].fg_index].lum, bg_lum);
+            score += fitness::apca_pair_score(edges[e], apca);
+        }
+    }
+    return score;
+}
+
+// =============================================================================
+// Host-side spec handling
+// =============================================================================
+
+inline int find_slot(const Spec& spec, const char* name) {
+    for (size_t i = 0; i < spec.names.size(); i++) {
+        if (spec.names[i] == name) return (int)i;
+    }
+    return -1;
+}
+
+/**
+ * Parse a spec file. Prints an error and returns false on malformed input.
+ */
+inline bool load_spec(const char* path, Spec* spec) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("Error: Could not open %s\n", path);
+        return false;
+    }
+
+    char line[512];
+    int line_no = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        line_no++;
+        // '#' starts a comment unless it begins a #rrggbb color
+        for (char* p = line; *p; p++) {
+            if (*p == '#' && !isxdigit((unsigned char)p[1])) {
+                *p = '\0';
+                break;
+            }
+        }
+
+        char kind[16], name[64], a[64];
+        int n = sscanf(line, "%15s %63s %63s", kind, name, a);
+        if (n <= 0) continue;
+
+        if (strcmp(kind, "slot") == 0 && n == 3) {
+            if (find_slot(*spec, name) >= 0) {
+                printf("Error: %s:%d: duplicate slot '%s'\n", path, line_no, name);
+                ok = false;
+                break;
+            }
+            if ((int)spec->names.size() >= MAX_SLOTS) {
+                printf("Error: %s:%d: more than %d slots\n", path, line_no, MAX_SLOTS);
+                ok = false;
+                break;
+            }
+
+            OklchSlotConstraint c = {};
+            c.base_slot = -1;
+            int ansi = -1;
+            unsigned int hex;
+            int idx;
+            if (strcmp(a, "fixed") == 0 && sscanf(line, "%*s %*s %*s #%x", &hex) == 1) {
+                c.fixed = true;
+                c.fixed_r = (hex >> 16) & 0xff;
+                c.fixed_g = (hex >> 8) & 0xff;
+                c.fixed_b = hex & 0xff;
+            } else if (strcmp(a, "ansi") == 0 && sscanf(line, "%*s %*s %*s %d", &idx) == 1 &&
+                       idx >= 0 && idx < 16) {
+                c.fixed = true;  // color filled in from the solved ANSI theme
+                ansi = idx;
+            } else if (sscanf(line, "%*s %*s %lf %lf %lf %lf %lf %lf",
+                              &c.target_hue, &c.hue_tolerance, &c.min_L, &c.max_L,
+                              &c.min_C, &c.max_C) != 6) {
+                printf("Error: %s:%d: expected '<hue> <tol> <min_L> <max_L> <min_C> <max_C>', "
+                       "'fixed #rrggbb' or 'ansi <0-15>'\n", path, line_no);
+                ok = false;
+                break;
+            }
+            spec->names.push_back(name);
+            spec->slots.push_back(c);
+            spec->ansi_ref.push_back(ansi);
+        } else if (strcmp(kind, "rule") == 0 && n == 3) {
+            double min_apca = 0.0, target_apca = 0.0;
+            if (sscanf(line, "%*s %*s %*s %lf %lf", &min_apca, &target_apca) < 1) {
+                printf("Error: %s:%d: expected 'rule <fg> <bg> <min> [target]'\n", path, line_no);
+                ok = false;
+                break;
+            }
+            int fg = find_slot(*spec, name);
+            int bg = find_slot(*spec, a);
+            if (fg < 0 || bg < 0) {
+                printf("Error: %s:%d: unknown slot '%s'\n", path, line_no, fg < 0 ? name : a);
+                ok = false;
+                break;
+            }
+            spec->rules.push_back({(int16_t)fg, (int16_t)bg, min_apca, target_apca, POLARITY_ANY});
+        } else {
+            printf("Error: %s:%d: expected 'slot' or 'rule'\n", path, line_no);
+            ok = false;
+        }
+    }
+    fclose(f);
+
+    if (ok && spec->names.empty()) {
+        printf("Error: %s: no slots defined\n", path);
+        ok = false;
+    }
+    return ok;
+}
+
+/**
+ * Fill ANSI-referenced slots from a solved 16-color sRGB palette.
+ */
+inline void resolve_ansi(Spec* spec, const double* ansi_rgb) {
+    for (size_t i = 0; i < spec->slots.size(); i++) {
+        int ref = spec->ansi_ref[i];
+        if (ref < 0) continue;
+        spec->slots[i].fixed_r = ansi_rgb[ref * 3 + 0];
+        spec->slots[i].fixed_g = ansi_rgb[ref * 3 + 1];
+        spec->slots[i].fixed_b = ansi_rgb[ref * 3 + 2];
+    }
+}
+
+/**
+ * Group the rules by background into CSR form. Rules between two fixed
+ * slots are constant and dropped.
+ */
+inline EdgeGraph build_edge_graph(const Spec& spec) {
+    int n = (int)spec.names.size();
+    EdgeGraph g;
+    g.offsets.assign(n + 1, 0);
+    for (const ApcaPairConstraint& r : spec.rules) {
+        if (spec.slots[r.fg_index].fixed && spec.slots[r.bg_index].fixed) continue;
+        g.offsets[r.bg_index + 1]++;
+    }
+    for (int i = 0; i < n; i++) {
+        g.offsets[i + 1] += g.offsets[i];
+    }
+
+    g.edges.resize(g.offsets[n]);
+    std::vector<int> fill(g.offsets.begin(), g.offsets.end() - 1);
+    for (const ApcaPairConstraint& r : spec.rules) {
+        if (spec.slots[r.fg_index].fixed && spec.slots[r.bg_index].fixed) continue;
+        g.edges[fill[r.bg_index]++] = r;
+    }
+    return g;
+}
+
+/**
+ * Write the solved semantic palette as "name = #rrggbb" lines.
+ */
+inline bool write_palette_file(const Spec& spec, const double* rgb, const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        printf("Error: Could not open %s for writing\n", path);
+        return false;
+    }
+    fprintf(f, "# Semantic palette generated by Hexa Color Solver v3.0\n");
+    fprintf(f, "#\n\n");
+    for (size_t i = 0; i < spec.names.size(); i++) {
+        fprintf(f, "%s = #%02x%02x%02x\n", spec.names[i].c_str(),
+                (int)lround(rgb[i * 3 + 0]), (int)lround(rgb[i * 3 + 1]), (int)lround(rgb[i * 3 + 2]));
+    }
+    return fclose(f) == 0;
+}
+
+} // namespace semantic
+
+#endif // SEMANTIC_CUH
@@ -0,0 +1,171 @@
+/**
+ * Slot Cache Module - Per-generation conversion cache shared by a population
+ *
+ * After a few generations many individuals carry identical slot triples:
+ * elites are copied verbatim, crossover passes parent genes through, and
+ * clamped values land on the same bounds. Each distinct (L, C, H) triple is
+ * converted to its SlotColor (sRGB, APCA luminance, Oklab) once; individuals
+ * then read the shared entry by index. Entries live for two generations, so
+ * the elite copies (and genes inherited unchanged from them) hit the
+ * conversions of the generation they came from. Unlike whole-palette
+ * memoization this also pays off when palettes differ in a single slot.
+ *
+ * The table is a lock-free open-addressing hash, filled concurrently by the
+ * evaluating threads. Keys are the exact bit patterns of the triple, so a
+ * hit returns exactly what the conversion would have, and results do not
+ * change with the cache on or off. A thread that misses converts the triple
+ * first and then publishes the entry with one compare-and-swap, so readers
+ * never see a half-written entry.
+ *
+ * Each index slot packs the generation's epoch, a fingerprint of the key's
+ * hash and the entry index into one word, so probing past other keys never
+ * touches their entries, and starting a generation is O(1) instead of
+ * clearing the table. Entries alternate between two halves of the entry
+ * array, so the previous generation's stay intact while the current one is
+ * filled.
+ */
+
+#ifndef SLOT_CACHE_HPP
+#define SLOT_CACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "fitness.cuh"
+
+namespace slot_cache {
+
+struct Key {
+    uint64_t bits[3];  // L, C, H
+
+    static Key of(const double* triple) {
+        Key k;
+        memcpy(k.bits, triple, sizeof(k.bits));
+        return k;
+    }
+    bool operator==(const Key& o) const {
+        return bits[0] == o.bits[0] && bits[1] == o.bits[1] && bits[2] == o.bits[2];
+    }
+};
+
+inline uint64_t hash(const Key& k) {
+    uint64_t h = k.bits[0] * 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 29) ^ k.bits[1]) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 32) ^ k.bits[2]) * 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+}
+
+struct Stats {
+    uint64_t lookups = 0;      // slot triples looked up
+    uint64_t conversions = 0;  // triples converted (misses, including lost races)
+};
+
+class Table {
+public:
+    // Index slot: epoch (20 bits) | fingerprint (20 bits) | entry index (24 bits)
+    static constexpr int EPOCH_SHIFT = 44;
+    static constexpr int FINGERPRINT_SHIFT = 24;
+    static constexpr uint32_t EPOCH_MASK = (1u << 20) - 1;
+    static constexpr uint64_t FINGERPRINT_MASK = ((1ull << 20) - 1) << FINGERPRINT_SHIFT;
+    static constexpr uint64_t INDEX_MASK = (1ull << FINGERPRINT_SHIFT) - 1;
+
+    // Largest max_entries whose two halves fit the 24-bit entry index
+    static constexpr size_t MAX_ENTRIES = (INDEX_MASK + 1) / 2;
+
+    /**
+     * Size for up to `max_entries` distinct triples per generation (the
+     * population times its genes covers the worst case, at most
+     * MAX_ENTRIES). The index has at least twice as many slots as two
+     * generations of entries, so probe sequences stay short.
+     */
+    explicit Table(size_t max_entries) : max_entries_(max_entries), entries_(2 * max_entries) {
+        size_t n = 16;
+        while (n < 4 * max_entries) n *= 2;
+        mask_ = n - 1;
+        slots_.reset(new std::atomic<uint64_t>[n]);
+        clear_slots();
+    }
+
+    /**
+     * Start a generation: entries older than the one just finished become
+     * stale. `lookups` is the number of lookup() calls the finished
+     * generation made (counted by the caller, not on the shared hot path).
+     * Returns the conversions it needed. Must not run concurrently with
+     * lookup().
+     */
+    uint64_t next_generation(uint64_t lookups) {
+        uint64_t conversions = next_.exchange(0, std::memory_order_relaxed);
+        stats_.lookups += lookups;
+        stats_.conversions += conversions;
+        epoch_ = (epoch_ + 1) & EPOCH_MASK;
+        if (epoch_ == 0) {
+            // Wrapped: tags from 2^20 generations ago would look current
+            clear_slots();
+            epoch_ = 2;
+        }
+        return conversions;
+    }
+
+    /**
+     * SlotColor of an (L, C, H) triple, converted at most once per
+     * generation (twice only if two threads miss the same triple at the same
+     * time) and reused from the previous generation when it had it. Safe to
+     * call from any number of threads. At most one entry is taken per call,
+     * so a generation of at most max_entries lookups fits.
+     */
+    const fitness::SlotColor& lookup(const double* triple) {
+        Key key = Key::of(triple);
+        uint64_t h = hash(key);
+        uint64_t tag = (uint64_t)epoch_ << EPOCH_SHIFT | (h >> 44) << FINGERPRINT_SHIFT;
+        size_t at = h & mask_;
+        uint32_t own = UINT32_MAX;  // entry converted by this call, not yet published
+        for (;;) {
+            uint64_t s = slots_[at].load(std::memory_order_acquire);
+            uint32_t age = (epoch_ - (uint32_t)(s >> EPOCH_SHIFT)) & EPOCH_MASK;
+            if (age > 1) {
+                if (own == UINT32_MAX) {
+                    own = (uint32_t)((epoch_ & 1) * max_entries_) + next_.fetch_add(1, std::memory_order_relaxed);
+                    entries_[own].key = key;
+                    entries_[own].color = fitness::slot_from_oklch(triple[0], triple[1], triple[2]);
+                }
+                if (slots_[at].compare_exchange_strong(s, tag | own, std::memory_order_acq_rel)) {
+                    return entries_[own].color;
+                }
+                continue;  // another thread took the slot first: re-read it
+            }
+            if (((s ^ tag) & FINGERPRINT_MASK) == 0) {
+                const Entry& e = entries_[s & INDEX_MASK];
+                if (e.key == key) return e.color;
+            }
+            at = (at + 1) & mask_;
+        }
+    }
+
+    // Totals over completed generations
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Entry {
+        Key key;
+        fitness::SlotColor color;
+    };
+
+    void clear_slots() {
+        for (size_t i = 0; i <= mask_; i++) slots_[i].store(0, std::memory_order_relaxed);
+    }
+
+    size_t max_entries_;
+    std::vector<Entry> entries_;  // two halves, by epoch parity
+    std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+    size_t mask_ = 0;
+    uint32_t epoch_ = 2;  // zeroed slots belong to no live generation
+    std::atomic<uint32_t> next_{0};
+    Stats stats_;
+};
+
+} // namespace slot_cache
+
+#endif // SLOT_CACHE_HPP
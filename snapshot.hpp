@@ -0,0 +1,375 @@
+/**
+ * Population Snapshot Module - Columnar export for offline analysis
+ *
+ * Every N generations the solver copies a strided sample of the population
+ * (genomes + fitness) into a staging buffer and hands it to a background
+ * thread; the generation loop itself only does that copy. Two staging
+ * buffers alternate, so one is filled while the other is decoded and written.
+ * If the writer falls two snapshots behind, acquire() waits for it rather
+ * than dropping data.
+ *
+ * File layout (append-only, native endianness):
+ *   FileHeader
+ *   Block 0, Block 1, ...   every block is exactly header.block_bytes
+ *
+ * A block holds one snapshot of `rows` individuals, stored column by column
+ * (see BlockLayout), each column 8-byte aligned:
+ *   BlockHeader         generation, rows
+ *   id       int32[rows]              population index of the individual
+ *   fitness  double[rows]
+ *   L, C, H  float[n_slots][rows]     OKLCH per slot (fixed slots included)
+ *   R, G, B  uint8[n_slots][rows]     sRGB per slot
+ *   terms    double[n_terms][rows]    per-term scores, names in the header
+ *
+ * Because blocks have a fixed size, readers mmap the file and index block k
+ * at sizeof(FileHeader) + k * block_bytes; a trailing partial block (from an
+ * interrupted run) is ignored.
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fitness.cuh"
+
+namespace snapshot {
+
+constexpr char MAGIC[8] = {'H', 'X', 'S', 'N', 'A', 'P', '0', '1'};
+constexpr int MAX_TERMS = 8;
+constexpr int TERM_NAME_SIZE = 16;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t n_slots;
+    uint32_t n_terms;
+    uint32_t rows;          // individuals per block
+    uint32_t population;
+    uint64_t block_bytes;
+    char term_names[MAX_TERMS][TERM_NAME_SIZE];
+};
+
+struct BlockHeader {
+    int32_t generation;
+    uint32_t rows;
+    uint64_t reserved;
+};
+
+// Byte offsets of each column from the start of a block
+struct BlockLayout {
+    size_t id, fitness, L, C, H, R, G, B, terms, bytes;
+};
+
+inline size_t align8(size_t n) { return (n + 7) & ~(size_t)7; }
+
+inline BlockLayout block_layout(int n_slots, int n_terms, int rows) {
+    BlockLayout b;
+    size_t at = sizeof(BlockHeader);
+    auto column = [&](size_t bytes) {
+        size_t offset = at;
+        at = align8(at + bytes);
+        return offset;
+    };
+    b.id = column(rows * sizeof(int32_t));
+    b.fitness = column(rows * sizeof(double));
+    b.L = column((size_t)n_slots * rows * sizeof(float));
+    b.C = column((size_t)n_slots * rows * sizeof(float));
+    b.H = column((size_t)n_slots * rows * sizeof(float));
+    b.R = column((size_t)n_slots * rows);
+    b.G = column((size_t)n_slots * rows);
+    b.B = column((size_t)n_slots * rows);
+    b.terms = column((size_t)n_terms * rows * sizeof(double));
+    b.bytes = at;
+    return b;
+}
+
+/**
+ * What a row means: how to decode a genome into slots and which score terms
+ * to record. Both functions run on the writer thread.
+ */
+struct Schema {
+    int n_slots;
+    int genome_doubles;  // doubles per genome (genes * 3)
+    std::vector<std::string> term_names;
+    std::function<void(const double* genome, fitness::SlotColor* s)> decode;
+    std::function<void(const fitness::SlotColor* s, double* terms)> terms;
+};
+
+// Raw sample filled by the generation loop
+struct Staging {
+    int generation;
+    std::vector<double> genomes;   // rows * genome_doubles
+    std::vector<double> fitness;   // rows
+    std::vector<int32_t> ids;      // rows
+};
+
+class Writer {
+public:
+    ~Writer() { close(); }
+
+    /**
+     * Create the file and start the writer thread. A snapshot is due every
+     * `every` generations; rows is clamped to the population and the sample
+     * is every (population / rows)-th individual.
+     */
+    bool open(const char* path, const Schema& schema, int population, int rows, int every) {
+        if ((int)schema.term_names.size() > MAX_TERMS) {
+            printf("Error: %zu snapshot terms (max %d)\n", schema.term_names.size(), MAX_TERMS);
+            return false;
+        }
+        schema_ = schema;
+        every_ = every;
+        rows_ = rows < population ? rows : population;
+        step_ = population / rows_;
+        layout_ = block_layout(schema.n_slots, (int)schema.term_names.size(), rows_);
+
+        file_ = fopen(path, "wb");
+        if (!file_) {
+            printf("Error: Could not open %s for writing\n", path);
+            return false;
+        }
+        FileHeader h = {};
+        memcpy(h.magic, MAGIC, sizeof(h.magic));
+        h.n_slots = schema.n_slots;
+        h.n_terms = (uint32_t)schema.term_names.size();
+        h.rows = rows_;
+        h.population = population;
+        h.block_bytes = layout_.bytes;
+        for (size_t t = 0; t < schema.term_names.size(); t++) {
+            strncpy(h.term_names[t], schema.term_names[t].c_str(), TERM_NAME_SIZE - 1);
+        }
+        if (fwrite(&h, sizeof(h), 1, file_) != 1) {
+            printf("Error: Failed writing %s\n", path);
+            fclose(file_);
+            file_ = nullptr;
+            return false;
+        }
+
+        for (Staging& s : staging_) {
+            s.genomes.resize((size_t)rows_ * schema.genome_doubles);
+            s.fitness.resize(rows_);
+            s.ids.resize(rows_);
+            for (int i = 0; i < rows_; i++) s.ids[i] = i * step_;
+        }
+        free_ = {&staging_[0], &staging_[1]};
+        stop_ = false;
+        thread_ = std::thread([this] { run(); });
+        return true;
+    }
+
+    bool is_open() const { return file_ != nullptr; }
+    bool due(int generation) const { return file_ && generation % every_ == 0; }
+    int rows() const { return rows_; }
+    int step() const { return step_; }  // population stride between sampled rows
+    uint64_t blocks_written() const { return blocks_written_; }
+    bool failed() const { return failed_; }
+
+    /**
+     * Next free staging buffer; waits while both are queued or being written.
+     * Sample row i is population index i * step().
+     */
+    Staging* acquire() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !free_.empty(); });
+        Staging* s = free_.front();
+        free_.pop_front();
+        return s;
+    }
+
+    void submit(Staging* s, int generation) {
+        s->generation = generation;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queued_.push_back(s);
+        }
+        cv_.notify_all();
+    }
+
+    /**
+     * Write the queued snapshots, stop the thread and close the file.
+     */
+    void close() {
+        if (!file_) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+        if (fclose(file_) != 0) failed_ = true;
+        file_ = nullptr;
+    }
+
+private:
+    void run() {
+        std::vector<uint8_t> block(layout_.bytes);
+        for (;;) {
+            Staging* s;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !queued_.empty(); });
+                if (queued_.empty()) return;
+                s = queued_.front();
+                queued_.pop_front();
+            }
+            fill_block(*s, block.data());
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                free_.push_back(s);
+            }
+            cv_.notify_all();
+            if (!failed_ && fwrite(block.data(), block.size(), 1, file_) != 1) {
+                failed_ = true;
+            }
+            blocks_written_++;
+        }
+    }
+
+    void fill_block(const Staging& s, uint8_t* block) {
+        int n_slots = schema_.n_slots;
+        int n_terms = (int)schema_.term_names.size();
+        memset(block, 0, layout_.bytes);
+
+        BlockHeader* h = (BlockHeader*)block;
+        h->generation = s.generation;
+        h->rows = rows_;
+        memcpy(block + layout_.id, s.ids.data(), rows_ * sizeof(int32_t));
+        memcpy(block + layout_.fitness, s.fitness.data(), rows_ * sizeof(double));
+
+        float* L = (float*)(block + layout_.L);
+        float* C = (float*)(block + layout_.C);
+        float* H = (float*)(block + layout_.H);
+        uint8_t* R = block + layout_.R;
+        uint8_t* G = block + layout_.G;
+        uint8_t* B = block + layout_.B;
+        double* terms = (double*)(block + layout_.terms);
+
+        std::vector<fitness::SlotColor> slots(n_slots);
+        double row_terms[MAX_TERMS];
+        auto byte = [](double v) { return (uint8_t)fmin(255.0, fmax(0.0, round(v))); };
+        for (int i = 0; i < rows_; i++) {
+            schema_.decode(&s.genomes[(size_t)i * schema_.genome_doubles], slots.data());
+            for (int k = 0; k < n_slots; k++) {
+                size_t at = (size_t)k * rows_ + i;
+                L[at] = (float)slots[k].L;
+                C[at] = (float)slots[k].C;
+                H[at] = (float)slots[k].H;
+                R[at] = byte(slots[k].r);
+                G[at] = byte(slots[k].g);
+                B[at] = byte(slots[k].b);
+            }
+            if (n_terms > 0) {
+                schema_.terms(slots.data(), row_terms);
+                for (int t = 0; t < n_terms; t++) terms[(size_t)t * rows_ + i] = row_terms[t];
+            }
+        }
+    }
+
+    Schema schema_;
+    BlockLayout layout_ = {};
+    int every_ = 1;
+    int rows_ = 0;
+    int step_ = 1;
+    FILE* file_ = nullptr;
+
+    Staging staging_[2];
+    std::deque<Staging*> free_, queued_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    bool stop_ = false;
+    bool failed_ = false;
+    uint64_t blocks_written_ = 0;
+};
+
+// =============================================================================
+// Reading
+// =============================================================================
+
+struct File {
+    const uint8_t* base;
+    size_t mapped_bytes;
+    const FileHeader* header;
+    BlockLayout layout;
+    uint64_t block_count;
+
+    const uint8_t* block(uint64_t k) const {
+        return base + sizeof(FileHeader) + k * header->block_bytes;
+    }
+    const BlockHeader& block_header(uint64_t k) const { return *(const BlockHeader*)block(k); }
+    const int32_t* id(uint64_t k) const { return (const int32_t*)(block(k) + layout.id); }
+    const double* fitness(uint64_t k) const { return (const double*)(block(k) + layout.fitness); }
+    // channel 0-2 = L, C, H of one slot
+    const float* lch(uint64_t k, int channel, int slot) const {
+        size_t offsets[3] = {layout.L, layout.C, layout.H};
+        return (const float*)(block(k) + offsets[channel]) + (size_t)slot * header->rows;
+    }
+    // channel 0-2 = R, G, B of one slot
+    const uint8_t* rgb(uint64_t k, int channel, int slot) const {
+        size_t offsets[3] = {layout.R, layout.G, layout.B};
+        return block(k) + offsets[channel] + (size_t)slot * header->rows;
+    }
+    const double* term(uint64_t k, int t) const {
+        return (const double*)(block(k) + layout.terms) + (size_t)t * header->rows;
+    }
+};
+
+/**
+ * Map a snapshot file read-only. Returns false if it is missing, not a
+ * snapshot file, or its block size does not match the header.
+ */
+inline bool map_file(const char* path, File* out) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(FileHeader)) {
+        close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+
+    File f;
+    f.base = (const uint8_t*)p;
+    f.mapped_bytes = st.st_size;
+    f.header = (const FileHeader*)p;
+    bool ok = memcmp(f.header->magic, MAGIC, sizeof(MAGIC)) == 0 &&
+              f.header->n_terms <= (uint32_t)MAX_TERMS && f.header->rows > 0;
+    if (ok) {
+        f.layout = block_layout(f.header->n_slots, f.header->n_terms, f.header->rows);
+        ok = f.layout.bytes == f.header->block_bytes;
+    }
+    if (!ok) {
+        munmap(p, st.st_size);
+        return false;
+    }
+    f.block_count = (st.st_size - sizeof(FileHeader)) / f.header->block_bytes;
+    *out = f;
+    return true;
+}
+
+inline void unmap(File* f) {
+    munmap((void*)f->base, f->mapped_bytes);
+    f->base = nullptr;
+}
+
+} // namespace snapshot
+
+#endif // SNAPSHOT_HPP
@@ -0,0 +1,158 @@
+/**
+ * Population Snapshot Test Suite
+ *
+ * Writes snapshots of a seeded ANSI population through snapshot::Writer,
+ * maps the file back with snapshot::map_file and compares every column
+ * (generation, ids, fitness, L/C/H, RGB, terms) with the values the writer
+ * was given. A trailing partial block, as left by an interrupted run, must
+ * be ignored, and a file that is not a snapshot must be rejected.
+ *
+ * Build: g++ -std=c++17 -O2 snapshot_test.cpp -o snapshot_test -lpthread
+ * Run: ./snapshot_test /tmp/test.snapshot
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "cpu_backend.hpp"
+#include "snapshot.hpp"
+
+#define POPULATION 100
+#define ROWS 10
+#define EVERY 5
+#define GENERATIONS 12
+#define SEED 0x5eedull
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+static void check(const char* name, bool ok) {
+    tests_run++;
+    if (!ok) tests_failed++;
+    printf("  %s %s\n", ok ? "✓" : "✗", name);
+}
+
+// Population of generation g: random genes from a per-generation stream
+static std::vector<double> population_at(const genome::Layout& layout, int g) {
+    int stride = layout.genes() * 3;
+    std::vector<double> genomes((size_t)POPULATION * stride);
+    for (int i = 0; i < POPULATION; i++) {
+        cpu::HostRng rng = cpu::stream(SEED + g, i);
+        for (int k = 0; k < layout.genes(); k++) {
+            ga::random_gene(oklch_slot_constraints[layout.gene_slots[k]], rng, &genomes[(size_t)i * stride + k * 3]);
+        }
+    }
+    return genomes;
+}
+
+static double score(const fitness::SlotColor* s) {
+    return fitness::palette_score(s, oklch_slot_constraints, apca_pair_constraints, APCA_CONSTRAINT_COUNT);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        printf("Usage: %s <snapshot file to write>\n", argv[0]);
+        return 2;
+    }
+    const char* path = argv[1];
+    genome::Layout layout = genome::build_layout(oklch_slot_constraints, 16);
+    int stride = layout.genes() * 3;
+
+    snapshot::Schema schema;
+    schema.n_slots = 16;
+    schema.genome_doubles = stride;
+    schema.term_names = {"total", "red_L"};
+    schema.decode = [&](const double* genes, fitness::SlotColor* s) { genome::decode(layout, genes, s); };
+    schema.terms = [](const fitness::SlotColor* s, double* terms) {
+        terms[0] = score(s);
+        terms[1] = s[RED].L;
+    };
+
+    printf("\nWriting %d snapshots of %d rows:\n", GENERATIONS / EVERY + 1, ROWS);
+    snapshot::Writer writer;
+    check("writer opens", writer.open(path, schema, POPULATION, ROWS, EVERY));
+    if (!writer.is_open()) return 1;
+    std::vector<int> written;
+    for (int g = 0; g < GENERATIONS; g++) {
+        if (!writer.due(g)) continue;
+        std::vector<double> genomes = population_at(layout, g);
+        snapshot::Staging* s = writer.acquire();
+        for (int i = 0; i < ROWS; i++) {
+            const double* genes = &genomes[(size_t)s->ids[i] * stride];
+            std::copy(genes, genes + stride, &s->genomes[(size_t)i * stride]);
+            fitness::SlotColor slots[16];
+            genome::decode(layout, genes, slots);
+            s->fitness[i] = score(slots);
+        }
+        writer.submit(s, g);
+        written.push_back(g);
+    }
+    writer.close();
+    check("no write errors", !writer.failed());
+    check("blocks written", writer.blocks_written() == written.size());
+
+    // An interrupted run leaves part of a block behind
+    FILE* f = fopen(path, "ab");
+    if (f) {
+        const char partial[100] = {};
+        fwrite(partial, sizeof(partial), 1, f);
+        fclose(f);
+    }
+
+    printf("\nReading back:\n");
+    snapshot::File file;
+    if (!snapshot::map_file(path, &file)) {
+        check("map_file accepts the snapshot", false);
+        return 1;
+    }
+    const snapshot::FileHeader& h = *file.header;
+    check("header", h.n_slots == 16 && h.n_terms == 2 && h.rows == ROWS && h.population == POPULATION &&
+                    strcmp(h.term_names[0], "total") == 0 && strcmp(h.term_names[1], "red_L") == 0);
+    check("partial block ignored", file.block_count == written.size());
+
+    for (uint64_t k = 0; k < file.block_count && k < written.size(); k++) {
+        int g = written[k];
+        std::vector<double> genomes = population_at(layout, g);
+        bool gen_ok = file.block_header(k).generation == g && file.block_header(k).rows == ROWS;
+        bool ids_ok = true, fitness_ok = true, lch_ok = true, rgb_ok = true, terms_ok = true;
+        for (int i = 0; i < ROWS; i++) {
+            int id = file.id(k)[i];
+            ids_ok = ids_ok && id == i * (POPULATION / ROWS);
+            fitness::SlotColor slots[16];
+            genome::decode(layout, &genomes[(size_t)id * stride], slots);
+            double total = score(slots);
+            fitness_ok = fitness_ok && file.fitness(k)[i] == total;
+            for (int s = 0; s < 16; s++) {
+                const double lch[3] = {slots[s].L, slots[s].C, slots[s].H};
+                const double rgb[3] = {slots[s].r, slots[s].g, slots[s].b};
+                for (int c = 0; c < 3; c++) {
+                    lch_ok = lch_ok && file.lch(k, c, s)[i] == (float)lch[c];
+                    rgb_ok = rgb_ok && file.rgb(k, c, s)[i] == (uint8_t)fmin(255.0, fmax(0.0, round(rgb[c])));
+                }
+            }
+            terms_ok = terms_ok && file.term(k, 0)[i] == total && file.term(k, 1)[i] == slots[RED].L;
+        }
+        std::string name = "block " + std::to_string(k) + " (generation " + std::to_string(g) + ")";
+        check((name + ": generation and rows").c_str(), gen_ok);
+        check((name + ": ids").c_str(), ids_ok);
+        check((name + ": fitness").c_str(), fitness_ok);
+        check((name + ": L, C, H").c_str(), lch_ok);
+        check((name + ": R, G, B").c_str(), rgb_ok);
+        check((name + ": terms").c_str(), terms_ok);
+    }
+    snapshot::unmap(&file);
+
+    // Not a snapshot: the same bytes without the magic
+    f = fopen(path, "r+b");
+    if (f) {
+        fwrite("XXXXXXXX", 8, 1, f);
+        fclose(f);
+    }
+    check("map_file rejects a foreign file", !snapshot::map_file(path, &file));
+    remove(path);
+
+    printf("\n%d tests, %d failed\n", tests_run, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
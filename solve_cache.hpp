@@ -0,0 +1,257 @@
+/**
+ * Solve Cache Module - Content-addressed store of completed solves
+ *
+ * A solve is keyed by a canonical text of everything that determines its
+ * result: GA parameters, modes, seed, the semantic spec contents and the code
+ * version (rule tables plus build stamp). The key's hash names the entry:
+ *   DIR/<hh>/<hash>.entry       config text, fitness, best genome, output files
+ *   DIR/family/<family hash>    entry hashes sharing everything but the seed
+ *
+ * A hit replays the stored output files without touching the GPU. On a miss,
+ * the best genomes of the same family (same rules, other seeds) are returned
+ * as warm starts for the initial population.
+ *
+ * Entries are written to a temporary file and renamed into place, so a
+ * concurrent reader sees either nothing or a complete entry. The stored
+ * config text is compared on load, so a hash collision is a miss.
+ */
+
+#ifndef SOLVE_CACHE_HPP
+#define SOLVE_CACHE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace solve_cache {
+
+constexpr const char* MAGIC = "HXCACHE1";
+
+inline uint64_t fnv1a(const void* data, size_t n, uint64_t h = 0xcbf29ce484222325ull) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+inline std::string hex(uint64_t h) {
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)h);
+    return buf;
+}
+
+/**
+ * Canonical "name=value" lines of a solve configuration. Fields added with
+ * family = false (the seed) are left out of the family key.
+ */
+class Key {
+public:
+    void add(const char* name, const std::string& value, bool family = true) {
+        std::string line = std::string(name) + "=" + value + "\n";
+        config_ += line;
+        if (family) family_ += line;
+    }
+    void add(const char* name, double value, bool family = true) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.17g", value);
+        add(name, std::string(buf), family);
+    }
+    // Raw bytes (tables, file contents), recorded by hash and size
+    void add_bytes(const char* name, const void* data, size_t n) {
+        add(name, hex(fnv1a(data, n)) + ":" + std::to_string(n));
+    }
+
+    const std::string& config() const { return config_; }
+    std::string hash() const { return hex(fnv1a(config_.data(), config_.size())); }
+    std::string family_hash() const { return hex(fnv1a(family_.data(), family_.size())); }
+
+private:
+    std::string config_, family_;
+};
+
+struct Entry {
+    std::string config;
+    double fitness;
+    std::vector<double> genome;                               // best genome (warm start)
+    std::vector<std::pair<std::string, std::string>> files;  // output suffix, contents
+    std::string summary;                                      // printed on a hit
+};
+
+inline std::string entry_path(const std::string& dir, const std::string& hash) {
+    return dir + "/" + hash.substr(0, 2) + "/" + hash + ".entry";
+}
+
+inline bool read_file(const std::string& path, std::string* out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    out->clear();
+    char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out->append(buf, n);
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+// Length-prefixed blob: "<tag> <len>\n<bytes>\n"
+inline void put_blob(std::string& out, const char* tag, const std::string& data) {
+    out += std::string(tag) + " " + std::to_string(data.size()) + "\n" + data + "\n";
+}
+
+inline bool get_blob(const std::string& in, size_t* at, std::string* tag, std::string* data) {
+    size_t nl = in.find('\n', *at);
+    if (nl == std::string::npos) return false;
+    char name[64];
+    unsigned long long len;
+    if (sscanf(in.c_str() + *at, "%63s %llu", name, &len) != 2) return false;
+    if (nl + 1 + len + 1 > in.size()) return false;
+    *tag = name;
+    *data = in.substr(nl + 1, len);
+    *at = nl + 1 + len + 1;
+    return true;
+}
+
+inline std::string serialize(const Entry& e) {
+    std::string out = std::string(MAGIC) + "\n";
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.17g", e.fitness);
+    put_blob(out, "config", e.config);
+    put_blob(out, "fitness", buf);
+    std::string genome;
+    for (double v : e.genome) {
+        snprintf(buf, sizeof(buf), "%.17g ", v);
+        genome += buf;
+    }
+    put_blob(out, "genome", genome);
+    for (const auto& f : e.files) {
+        put_blob(out, "file", f.first);
+        put_blob(out, "contents", f.second);
+    }
+    put_blob(out, "summary", e.summary);
+    return out;
+}
+
+inline bool parse(const std::string& in, Entry* e) {
+    size_t at = strlen(MAGIC) + 1;
+    if (in.compare(0, at, std::string(MAGIC) + "\n") != 0) return false;
+    *e = Entry();
+    std::string tag, data, file_name;
+    while (at < in.size()) {
+        if (!get_blob(in, &at, &tag, &data)) return false;
+        if (tag == "config") {
+            e->config = data;
+        } else if (tag == "fitness") {
+            e->fitness = atof(data.c_str());
+        } else if (tag == "genome") {
+            const char* p = data.c_str();
+            char* end;
+            for (double v = strtod(p, &end); end != p; v = strtod(p, &end)) {
+                e->genome.push_back(v);
+                p = end;
+            }
+        } else if (tag == "file") {
+            file_name = data;
+        } else if (tag == "contents") {
+            e->files.push_back({file_name, data});
+        } else if (tag == "summary") {
+            e->summary = data;
+        }
+    }
+    return true;
+}
+
+/**
+ * Look up a key. True only for a complete entry whose config matches.
+ */
+inline bool load(const std::string& dir, const Key& key, Entry* out) {
+    std::string text;
+    Entry e;
+    if (!read_file(entry_path(dir, key.hash()), &text) || !parse(text, &e)) return false;
+    if (e.config != key.config()) return false;
+    *out = e;
+    return true;
+}
+
+/**
+ * Store an entry (atomically, via rename) and add it to its family.
+ */
+inline bool store(const std::string& dir, const Key& key, Entry e) {
+    std::string hash = key.hash();
+    std::string shard = dir + "/" + hash.substr(0, 2);
+    mkdir(dir.c_str(), 0755);
+    mkdir(shard.c_str(), 0755);
+    mkdir((dir + "/family").c_str(), 0755);
+
+    e.config = key.config();
+    std::string data = serialize(e);
+    std::string path = entry_path(dir, hash);
+    std::string tmp = path + ".tmp." + std::to_string(getpid());
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        unlink(tmp.c_str());
+        return false;
+    }
+
+    // One short O_APPEND write per line, so concurrent solves don't interleave
+    std::string line = hash + "\n";
+    int fd = open((dir + "/family/" + key.family_hash()).c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return false;
+    ok = write(fd, line.data(), line.size()) == (ssize_t)line.size();
+    close(fd);
+    return ok;
+}
+
+/**
+ * Best genomes (up to max_count, best first) of completed solves in the
+ * key's family, i.e. same configuration with another seed.
+ */
+inline std::vector<std::vector<double>> warm_starts(const std::string& dir, const Key& key,
+                                                    size_t genome_size, int max_count) {
+    std::string list;
+    std::vector<std::pair<double, std::vector<double>>> found;
+    if (read_file(dir + "/family/" + key.family_hash(), &list)) {
+        std::vector<std::string> seen;
+        size_t at = 0;
+        while (at < list.size()) {
+            size_t nl = list.find('\n', at);
+            if (nl == std::string::npos) break;
+            std::string hash = list.substr(at, nl - at);
+            at = nl + 1;
+            if (std::find(seen.begin(), seen.end(), hash) != seen.end()) continue;
+            seen.push_back(hash);
+
+            std::string text;
+            Entry e;
+            if (read_file(entry_path(dir, hash), &text) && parse(text, &e) &&
+                e.genome.size() == genome_size) {
+                found.push_back({e.fitness, e.genome});
+            }
+        }
+    }
+    std::sort(found.begin(), found.end(),
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::vector<std::vector<double>> genomes;
+    for (int i = 0; i < (int)found.size() && i < max_count; i++) {
+        genomes.push_back(found[i].second);
+    }
+    return genomes;
+}
+
+} // namespace solve_cache
+
+#endif // SOLVE_CACHE_HPP
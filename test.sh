@@ -6,5 +6,5 @@ cd "$(dirname "$0")"
 mkdir -p build-test
 cd build-test
 cmake .. -DUSE_ROCM=OFF
-cmake --build . --target color_test -j
+cmake --build . --target color_test parity_test formats_test screen_test snapshot_test margins_test lut-gen theme-watch hexa-theme-rank -j
 ctest --output-on-failure
@@ -12,15 +12,26 @@ APCA (Accessible Perceptual Contrast Algorithm) levels:
   ○ Lc ≥ 45: Non-text, large bold minimum
   ✗ Lc < 45: Fail for most uses
 
-Themes are loaded from ./themes/ directory in lexicographical order.
+Themes are loaded from ./themes/ directory in lexicographical order. If
+theme-watch is running, the header also shows the solver fitness from its
+shared metrics index (themes/.metrics-index), always current.
+
+Color math runs in libhexacolor (color_abi.h, the solver's own color.cuh)
+when it is built, found via $HEXA_COLOR_LIB, next to this script or in
+build/; it then also scores edited palettes live. Without it the pure-Python
+implementations below are used.
 
 Usage:
     python theme-analyzer.py         # Interactive mode
     python theme-analyzer.py --help  # Show help
 """
 
+import ctypes
 import math
+import mmap
+import os
 import re
+import struct
 import sys
 import termios
 import tty
@@ -63,6 +74,100 @@ PYTE_COLOR_MAP = {
     'brightblue': 12, 'brightmagenta': 13, 'brightcyan': 14, 'brightwhite': 15,
 }
 
+# =============================================================================
+# Native Acceleration
+# =============================================================================
+
+class PaletteMetrics(NamedTuple):
+    """Solver fitness and APCA rule margins of a palette, whether computed by
+    the native library or read from theme-watch's metrics index."""
+
+    fitness: float
+    worst_margin: float
+    rules_met: int
+    rules_total: int
+
+
+class NativeColor:
+    """ctypes binding of libhexacolor (color_abi.h).
+
+    Every call is a batch over packed 8-bit RGB triples. `available` is False
+    when the library is missing or of another ABI version; callers then use
+    the pure-Python code.
+    """
+
+    ABI_VERSION = 1
+    LIB_NAME = "libhexacolor.dylib" if sys.platform == "darwin" else "libhexacolor.so"
+
+    class Metrics(ctypes.Structure):
+        _fields_ = [
+            ("fitness", ctypes.c_double),
+            ("worst_margin", ctypes.c_double),
+            ("min_distance", ctypes.c_double),
+            ("min_hue_spacing", ctypes.c_double),
+            ("worst_rule", ctypes.c_int32),
+            ("rules_met", ctypes.c_int32),
+            ("rules_total", ctypes.c_int32),
+            ("reserved", ctypes.c_int32),
+        ]
+
+    def __init__(self):
+        self.lib = self._load()
+        self.available = self.lib is not None
+        if self.available:
+            u8p, dp = ctypes.POINTER(ctypes.c_uint8), ctypes.POINTER(ctypes.c_double)
+            for name in ("hexa_apca_matrix", "hexa_contrast_ratio_matrix"):
+                getattr(self.lib, name).argtypes = [u8p, ctypes.c_int, u8p, ctypes.c_int, dp]
+                getattr(self.lib, name).restype = None
+            self.lib.hexa_rgb_to_oklch.argtypes = [u8p, ctypes.c_int, dp]
+            self.lib.hexa_rgb_to_oklch.restype = None
+            self.lib.hexa_palette_metrics.argtypes = [u8p, ctypes.POINTER(self.Metrics)]
+            self.lib.hexa_palette_metrics.restype = None
+
+    def _load(self) -> Optional[ctypes.CDLL]:
+        base_dir = Path(__file__).parent
+        candidates = [os.environ.get("HEXA_COLOR_LIB", ""),
+                      str(base_dir / self.LIB_NAME), str(base_dir / "build" / self.LIB_NAME)]
+        for path in candidates:
+            if not path or not os.path.exists(path):
+                continue
+            try:
+                lib = ctypes.CDLL(path)
+                lib.hexa_abi_version.restype = ctypes.c_int
+                if lib.hexa_abi_version() == self.ABI_VERSION:
+                    return lib
+            except (OSError, AttributeError):
+                pass
+        return None
+
+    @staticmethod
+    def _pack(rgbs: List[Tuple[int, int, int]]):
+        return (ctypes.c_uint8 * (3 * len(rgbs)))(*[c for rgb in rgbs for c in rgb])
+
+    def _matrix(self, fn, fg: List[Tuple[int, int, int]], bg: List[Tuple[int, int, int]]) -> List[List[float]]:
+        out = (ctypes.c_double * (len(fg) * len(bg)))()
+        fn(self._pack(fg), len(fg), self._pack(bg), len(bg), out)
+        return [list(out[i * len(bg):(i + 1) * len(bg)]) for i in range(len(fg))]
+
+    def apca_matrix(self, fg, bg) -> List[List[float]]:
+        return self._matrix(self.lib.hexa_apca_matrix, fg, bg)
+
+    def contrast_ratio_matrix(self, fg, bg) -> List[List[float]]:
+        return self._matrix(self.lib.hexa_contrast_ratio_matrix, fg, bg)
+
+    def rgb_to_oklch(self, rgbs: List[Tuple[int, int, int]]) -> List[Tuple[float, float, float]]:
+        out = (ctypes.c_double * (3 * len(rgbs)))()
+        self.lib.hexa_rgb_to_oklch(self._pack(rgbs), len(rgbs), out)
+        return [tuple(out[i * 3:i * 3 + 3]) for i in range(len(rgbs))]
+
+    def palette_metrics(self, rgbs: List[Tuple[int, int, int]]) -> PaletteMetrics:
+        m = self.Metrics()
+        self.lib.hexa_palette_metrics(self._pack(rgbs), ctypes.byref(m))
+        return PaletteMetrics(m.fitness, m.worst_margin, m.rules_met, m.rules_total)
+
+
+NATIVE = NativeColor()
+
 # =============================================================================
 # Color Utilities
 # =============================================================================
@@ -115,6 +220,8 @@ class ColorUtils:
     @staticmethod
     def rgb_to_oklch(r: int, g: int, b: int) -> Tuple[float, float, float]:
         """Convert RGB to OKLCH (Lightness, Chroma, Hue)."""
+        if NATIVE.available:
+            return NATIVE.rgb_to_oklch([(r, g, b)])[0]
         L, a, ok_b = ColorUtils.rgb_to_oklab(r, g, b)
         C = math.sqrt(a * a + ok_b * ok_b)
         H = math.degrees(math.atan2(ok_b, a))
@@ -141,6 +248,9 @@ class ColorUtils:
             |Lc| >= 75: minimum for body text
             |Lc| >= 90: preferred for body text
         """
+        if NATIVE.available:
+            return NATIVE.apca_matrix([ColorUtils.hex_to_rgb(fg_hex)], [ColorUtils.hex_to_rgb(bg_hex)])[0][0]
+
         # APCA 0.0.98G-4g constants
         # Exponents
         normBG, normTXT = 0.56, 0.57
@@ -200,6 +310,14 @@ class ColorUtils:
 
         return output * 100.0
 
+    @staticmethod
+    def apca_matrix(fg_hexes: List[str], bg_hexes: List[str]) -> List[List[float]]:
+        """APCA Lc of every foreground on every background, [fg][bg]."""
+        if NATIVE.available:
+            return NATIVE.apca_matrix([ColorUtils.hex_to_rgb(c) for c in fg_hexes],
+                                      [ColorUtils.hex_to_rgb(c) for c in bg_hexes])
+        return [[ColorUtils.apca_contrast(fg, bg) for bg in bg_hexes] for fg in fg_hexes]
+
     @staticmethod
     def apca_contrast_abs(fg_hex: str, bg_hex: str) -> float:
         """Calculate absolute APCA contrast value."""
@@ -221,6 +339,8 @@ class ColorUtils:
     @staticmethod
     def contrast_ratio(c1: str, c2: str) -> float:
         """Calculate WCAG contrast ratio between two colors."""
+        if NATIVE.available:
+            return NATIVE.contrast_ratio_matrix([ColorUtils.hex_to_rgb(c1)], [ColorUtils.hex_to_rgb(c2)])[0][0]
         l1 = ColorUtils.relative_luminance(c1)
         l2 = ColorUtils.relative_luminance(c2)
         lighter = max(l1, l2)
@@ -326,7 +446,8 @@ class ThemeManager:
                 if "=" in rest:
                     idx_str, color = rest.split("=", 1)
                     idx = int(idx_str.strip())
-                    colors[idx] = color.strip()
+                    if idx < 16:  # 256-color themes: only the ANSI slots are analyzed
+                        colors[idx] = color.strip()
 
         if len(colors) != 16:
             # Fallback or strict? Strict for now as per original code
@@ -343,6 +464,61 @@ class ThemeManager:
         return filepath
 
 
+class MetricsIndex:
+    """Read-only view of the metrics index kept by theme-watch (metrics_index.hpp).
+
+    Records are read under their seqlock: retry while seq is odd or changed.
+    A name keeps its record slot, so slots are cached and only records added
+    since the last lookup are scanned.
+    """
+
+    MAGIC = b"HXMIDX01"
+    HEADER = struct.Struct("<8sIIIIQ32x")
+    RECORD = struct.Struct("<II112sqqddddiii48s4x")
+
+    def __init__(self, path: Path):
+        self.path = path
+        self._map: Optional[mmap.mmap] = None
+        self._slots: Dict[str, int] = {}
+        self._scanned = 0
+
+    def _open(self) -> bool:
+        if self._map is None and self.path.exists():
+            with open(self.path, "rb") as f:
+                m = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+            magic, _, record_size, _, _, _ = self.HEADER.unpack_from(m, 0)
+            if magic == self.MAGIC and record_size == self.RECORD.size:
+                self._map = m
+        return self._map is not None
+
+    def _read(self, slot: int) -> tuple:
+        offset = self.HEADER.size + slot * self.RECORD.size
+        while True:
+            seq = struct.unpack_from("<I", self._map, offset)[0]
+            if seq & 1:
+                continue
+            record = self.RECORD.unpack_from(self._map, offset)
+            if struct.unpack_from("<I", self._map, offset)[0] == seq:
+                return record
+
+    def lookup(self, name: str) -> Optional[PaletteMetrics]:
+        if not self._open():
+            return None
+        count = self.HEADER.unpack_from(self._map, 0)[3]
+        for slot in range(self._scanned, count):
+            record_name = self._read(slot)[2].split(b"\0", 1)[0].decode(errors="replace")
+            self._slots[record_name] = slot
+        self._scanned = count
+
+        slot = self._slots.get(name)
+        if slot is None:
+            return None
+        _, state, _, _, _, fitness, worst_margin, _, _, met, total, _, _ = self._read(slot)
+        if state != 1:
+            return None
+        return PaletteMetrics(fitness, worst_margin, met, total)
+
+
 class ScreenshotManager:
     """Manages loading and caching of screenshot text files."""
 
@@ -372,6 +548,16 @@ class ThemeRenderer:
 
     def __init__(self, screenshot_manager: ScreenshotManager):
         self.screenshot_manager = screenshot_manager
+        self._matrix_key: Optional[Tuple[str, ...]] = None
+        self._matrix: List[List[float]] = []
+
+    def lc_matrix(self, colors: Dict[int, str]) -> List[List[float]]:
+        """16x16 APCA matrix [fg][bg] of a palette, computed once per palette."""
+        key = tuple(colors[i] for i in range(16))
+        if key != self._matrix_key:
+            self._matrix = ColorUtils.apca_matrix(list(key), list(key))
+            self._matrix_key = key
+        return self._matrix
 
     @staticmethod
     def get_apca_color(lc: float) -> str:
@@ -393,9 +579,8 @@ class ThemeRenderer:
         if abs_lc >= 45: return "[bright_yellow]○[/]"
         return "[red]✗[/]"
 
-    def _create_contrast_cell(self, text: str, fg: str, bg: str) -> Tuple[Text, str, str]:
+    def _create_contrast_cell(self, text: str, fg: str, bg: str, lc: float) -> Tuple[Text, str, str]:
         """Create a styled text cell with APCA contrast info."""
-        lc = ColorUtils.apca_contrast(fg, bg)
         fg_rgb = ColorUtils.hex_to_rgb(fg)
         bg_rgb = ColorUtils.hex_to_rgb(bg)
 
@@ -408,7 +593,7 @@ class ThemeRenderer:
 
     def create_palette_table(self, theme: Theme, edit_state: Optional[EditState] = None) -> Table:
         colors = edit_state.colors if edit_state and edit_state.colors else theme.colors
-        bg_color = colors[0]
+        matrix = self.lc_matrix(colors)
 
         title = "Palette [Edit Mode]" if edit_state and edit_state.active else "Palette"
         table = Table(title=title, box=None, show_header=True, padding=(0, 1))
@@ -434,7 +619,7 @@ class ThemeRenderer:
                 display_hex = color
                 r, g, b = ColorUtils.hex_to_rgb(color)
 
-            lc = ColorUtils.apca_contrast(color, bg_color)
+            lc = matrix[i][0]
             swatch = Text("      ", style=Style(bgcolor=f"rgb({r},{g},{b})"))
 
             lc_color = self.get_apca_color(lc)
@@ -458,11 +643,11 @@ class ThemeRenderer:
         table.add_column("Lc", width=5)
         table.add_column("", width=4)
 
-        bg = theme.colors[0]
-        # Base colors (1-6)
+        matrix = self.lc_matrix(theme.colors)
+        # Base colors (1-6) on black
         base_lcs = []
         for i in range(1, 7):
-            lc = ColorUtils.apca_contrast(theme.colors[i], bg)
+            lc = matrix[i][0]
             base_lcs.append(abs(lc))
             color = self.get_apca_color(lc)
             status = self.get_apca_icon(lc)
@@ -481,13 +666,15 @@ class ThemeRenderer:
         table.add_column("", width=2)
 
         pairs = [(8, 0)] + [(i + 8, i) for i in range(1, 7)] + [(15, 7)]
+        matrix = self.lc_matrix(theme.colors)
 
         for bright_idx, base_idx in pairs:
             base = theme.colors[base_idx]
             bright = theme.colors[bright_idx]
 
             pair_name = f" {COLOR_NAMES[bright_idx]} on {COLOR_NAMES[base_idx]} "
-            styled, lc_str, status = self._create_contrast_cell(pair_name, bright, base)
+            styled, lc_str, status = self._create_contrast_cell(pair_name, bright, base,
+                                                                matrix[bright_idx][base_idx])
             table.add_row(styled, lc_str, status)
 
         return table
@@ -503,6 +690,7 @@ class ThemeRenderer:
 
         on_blue_idxs = [7, 3, 5, 6, 2, 1]
         on_green_idxs = [7, 3, 5, 4, 1, 6]
+        matrix = self.lc_matrix(theme.colors)
 
         for i in range(len(on_blue_idxs)):
             row = []
@@ -510,14 +698,14 @@ class ThemeRenderer:
             fg = theme.colors[on_blue_idxs[i]]
             bg = theme.colors[4]
             name = f" {COLOR_NAMES[on_blue_idxs[i]]} on blue "
-            styled, lc_str, status = self._create_contrast_cell(name, fg, bg)
+            styled, lc_str, status = self._create_contrast_cell(name, fg, bg, matrix[on_blue_idxs[i]][4])
             row.extend([styled, lc_str, status])
 
             # Green column
             fg = theme.colors[on_green_idxs[i]]
             bg = theme.colors[2]
             name = f" {COLOR_NAMES[on_green_idxs[i]]} on green "
-            styled, lc_str, status = self._create_contrast_cell(name, fg, bg)
+            styled, lc_str, status = self._create_contrast_cell(name, fg, bg, matrix[on_green_idxs[i]][2])
             row.extend([styled, lc_str, status])
 
             table.add_row(*row)
@@ -621,6 +809,7 @@ class App:
         
         base_dir = Path(__file__).parent
         self.theme_manager = ThemeManager(base_dir / "themes")
+        self.metrics_index = MetricsIndex(base_dir / "themes" / ".metrics-index")
         self.screenshot_manager = ScreenshotManager(base_dir / "screenshots")
         self.renderer = ThemeRenderer(self.screenshot_manager)
         
@@ -666,7 +855,13 @@ class App:
         
         # 1. Header
         name_display = f"{theme.name}-modified" if self.current_index in self.modified_themes else theme.name
-        left = f"═══ THEME ANALYZER │ [{self.current_index + 1}/{len(self.themes)}] {name_display} ═══"
+        # Saved themes from the index; edited palettes scored live when native
+        modified = self.current_index in self.modified_themes or self.edit_state.active
+        metrics = None if modified else self.metrics_index.lookup(theme.name)
+        if metrics is None and NATIVE.available:
+            metrics = NATIVE.palette_metrics([ColorUtils.hex_to_rgb(working_theme.colors[i]) for i in range(16)])
+        index_info = f" │ fitness {metrics.fitness:.1f}, {metrics.rules_met}/{metrics.rules_total} rules" if metrics else ""
+        left = f"═══ THEME ANALYZER │ [{self.current_index + 1}/{len(self.themes)}] {name_display}{index_info} ═══"
         
         if self.edit_state.active:
             if self.edit_state.editing:
@@ -0,0 +1,241 @@
+/**
+ * Theme Ranking - Score whole theme corpora in one pass
+ *
+ * Walks the given files and directories (recursively), maps every file
+ * read-only and parses it with the format readers of theme_formats.hpp
+ * (Ghostty, kitty, Alacritty, WezTerm, Xresources, iTerm2), scores the 16
+ * ANSI colors with the solver's rules (theme_metrics::compute) on the
+ * work-stealing pool, and ranks everything together. Each root given on the
+ * command line gets its own summary line, so a directory of generated
+ * themes can be compared with a community corpus directly:
+ *
+ *   ./hexa-theme-rank themes ~/src/iTerm2-Color-Schemes
+ *
+ * With --index the scores are also committed to a metrics index
+ * (metrics_index.hpp), named by path, for theme-analyzer.py and dashboards.
+ *
+ * Build: g++ -std=c++17 -O2 theme-rank.cpp -o hexa-theme-rank -lpthread
+ * Run: ./hexa-theme-rank --top 30 --tsv ranking.tsv themes community
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "cpu_backend.hpp"
+#include "metrics_index.hpp"
+#include "theme_formats.hpp"
+
+struct Entry {
+    std::string path;
+    int root;                        // index of the command-line root
+    int64_t mtime_ns, size;
+    bool parsed;
+    theme_formats::Format format;
+    theme_metrics::Palette palette;
+    theme_metrics::Metrics metrics;
+};
+
+// Hidden files (indexes, editor swap files) and images are not themes
+static bool is_candidate(const char* name) {
+    if (name[0] == '.') return false;
+    const char* dot = strrchr(name, '.');
+    return !dot || (strcmp(dot, ".png") != 0 && strcmp(dot, ".jpg") != 0 && strcmp(dot, ".md") != 0);
+}
+
+static void collect(const std::string& path, int root, std::vector<Entry>& out) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return;
+    if (S_ISREG(st.st_mode)) {
+        Entry e = {};
+        e.path = path;
+        e.root = root;
+        e.mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+        e.size = st.st_size;
+        out.push_back(e);
+        return;
+    }
+    if (!S_ISDIR(st.st_mode)) return;
+    DIR* d = opendir(path.c_str());
+    if (!d) return;
+    std::vector<std::string> names;
+    while (struct dirent* e = readdir(d)) {
+        if (is_candidate(e->d_name)) names.push_back(e->d_name);
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+    for (const std::string& name : names) {
+        collect(path + "/" + name, root, out);
+    }
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options] PATH...\n", prog);
+    printf("\nScores every theme file under each PATH and ranks them together.\n");
+    printf("\nOptions:\n");
+    printf("  --top N         Rows of the ranking to print (default: 20, 0 = summary only)\n");
+    printf("  --tsv FILE      Write the full ranking as tab-separated values\n");
+    printf("  --index FILE    Also commit the scores to a metrics index\n");
+    printf("  --capacity N    Records of a new index (default: 65536)\n");
+    printf("  --threads N     Parsing and scoring threads (default: hardware threads)\n");
+    printf("  --strict        Exit with an error if any file could not be read\n");
+}
+
+int main(int argc, char** argv) {
+    int top = 20;
+    const char* tsv_path = NULL;
+    const char* index_path = NULL;
+    int capacity = 65536;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    bool strict = false;
+    std::vector<std::string> roots;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tsv") == 0 && i + 1 < argc) {
+            tsv_path = argv[++i];
+        } else if (strcmp(argv[i], "--index") == 0 && i + 1 < argc) {
+            index_path = argv[++i];
+        } else if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+            capacity = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--strict") == 0) {
+            strict = true;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] != '-') {
+            std::string root = argv[i];
+            while (root.size() > 1 && root.back() == '/') root.pop_back();
+            roots.push_back(root);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (roots.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (top < 0 || capacity < 1 || threads < 1) {
+        printf("Error: --top must be >= 0, --capacity and --threads >= 1\n");
+        return 1;
+    }
+
+    std::vector<Entry> entries;
+    for (size_t r = 0; r < roots.size(); r++) {
+        collect(roots[r], (int)r, entries);
+    }
+
+    cpu::Pool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+    pool.parallel_for((int)entries.size(), [&](int i) {
+        Entry& e = entries[i];
+        e.parsed = theme_formats::load_file(e.path.c_str(), &e.palette, &e.format);
+        if (e.parsed) e.metrics = theme_metrics::compute(e.palette);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Per-format counts, failures listed
+    int parsed[theme_formats::FORMAT_COUNT] = {}, failed = 0;
+    for (const Entry& e : entries) {
+        if (e.parsed) {
+            parsed[e.format]++;
+        } else {
+            failed++;
+            printf("Skipped %s (%s)\n", e.path.c_str(),
+                   e.format == theme_formats::UNKNOWN ? "unknown format"
+                                                      : theme_formats::format_names[e.format]);
+        }
+    }
+    printf("Scored %zu of %zu files in %.3fs on %d threads:", entries.size() - failed, entries.size(),
+           seconds, pool.size());
+    for (int f = 0; f < theme_formats::FORMAT_COUNT; f++) {
+        if (parsed[f]) printf(" %s %d", theme_formats::format_names[f], parsed[f]);
+    }
+    printf("\n");
+
+    std::vector<const Entry*> ranking;
+    for (const Entry& e : entries) {
+        if (e.parsed) ranking.push_back(&e);
+    }
+    std::stable_sort(ranking.begin(), ranking.end(), [](const Entry* a, const Entry* b) {
+        return a->metrics.fitness > b->metrics.fitness;
+    });
+
+    // Summary per root: where its themes land in the combined ranking
+    printf("\n  %-32s %6s %10s %10s %10s %9s\n", "Root", "Themes", "Best", "Median", "Best rank", "Rules");
+    for (size_t r = 0; r < roots.size(); r++) {
+        std::vector<double> fitness;
+        int best_rank = 0, met = 0, total = 0;
+        for (size_t k = 0; k < ranking.size(); k++) {
+            if (ranking[k]->root != (int)r) continue;
+            if (fitness.empty()) best_rank = (int)k + 1;
+            fitness.push_back(ranking[k]->metrics.fitness);
+            met += ranking[k]->metrics.rules_met;
+            total += ranking[k]->metrics.rules_total;
+        }
+        if (fitness.empty()) {
+            printf("  %-32s %6d\n", roots[r].c_str(), 0);
+            continue;
+        }
+        printf("  %-32s %6zu %10.2f %10.2f %10d %8.1f%%\n", roots[r].c_str(), fitness.size(), fitness.front(),
+               fitness[fitness.size() / 2], best_rank, 100.0 * met / total);
+    }
+
+    if (top > 0 && !ranking.empty()) {
+        printf("\n  %5s %10s %7s %9s %-10s %s\n", "Rank", "Fitness", "Rules", "Worst Lc", "Format", "Theme");
+        for (size_t k = 0; k < ranking.size() && (int)k < top; k++) {
+            const Entry& e = *ranking[k];
+            char rules[16];
+            snprintf(rules, sizeof(rules), "%d/%d", e.metrics.rules_met, e.metrics.rules_total);
+            printf("  %5zu %10.2f %7s %+9.1f %-10s %s\n", k + 1, e.metrics.fitness, rules,
+                   e.metrics.worst_margin, theme_formats::format_names[e.format], e.path.c_str());
+        }
+    }
+
+    if (tsv_path) {
+        FILE* f = fopen(tsv_path, "w");
+        if (!f) {
+            printf("Error: Could not open %s for writing\n", tsv_path);
+            return 1;
+        }
+        fprintf(f, "rank\tfitness\trules_met\trules_total\tworst_margin\tmin_distance\tmin_hue_spacing\tformat\tpath\n");
+        for (size_t k = 0; k < ranking.size(); k++) {
+            const Entry& e = *ranking[k];
+            fprintf(f, "%zu\t%.4f\t%d\t%d\t%.4f\t%.6f\t%.3f\t%s\t%s\n", k + 1, e.metrics.fitness,
+                    e.metrics.rules_met, e.metrics.rules_total, e.metrics.worst_margin, e.metrics.min_distance,
+                    e.metrics.min_hue_spacing, theme_formats::format_names[e.format], e.path.c_str());
+        }
+        fclose(f);
+        printf("\nWrote %zu rows to %s\n", ranking.size(), tsv_path);
+    }
+
+    if (index_path) {
+        metrics_index::Index index;
+        if (!index.open(index_path, capacity)) {
+            return 1;
+        }
+        int indexed = 0;
+        for (const Entry* e : ranking) {
+            if (index.put(e->path, e->mtime_ns, e->size, e->palette, e->metrics)) {
+                indexed++;
+            } else {
+                printf("Warning: %s not indexed (index full or name too long)\n", e->path.c_str());
+            }
+        }
+        printf("Indexed %d themes in %s (generation %llu)\n", indexed, index_path,
+               (unsigned long long)index.publish());
+    }
+
+    return strict && failed > 0 ? 1 : 0;
+}
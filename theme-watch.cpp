@@ -0,0 +1,259 @@
+/**
+ * Theme Directory Watcher - Keeps the shared metrics index hot
+ *
+ * Watches a theme directory with inotify and re-indexes only the files that
+ * were written, moved in or removed. Changed files are parsed (any format of
+ * theme_formats.hpp) and scored on a work-stealing pool (cpu::Pool), then
+ * committed to the memory-mapped index (metrics_index.hpp) record by record
+ * with a seqlock and published with one generation bump per batch. Readers
+ * never re-scan the directory.
+ *
+ * On start the directory is reconciled with the index: files whose mtime and
+ * size match their record are skipped, so restarts are cheap too. Events are
+ * batched (BATCH_WINDOW_MS after the first one) so a burst of solver output
+ * is scored in parallel. An inotify queue overflow triggers a full reconcile.
+ *
+ * Build: g++ -std=c++17 -O2 theme-watch.cpp -o theme-watch -lpthread
+ * Run: ./theme-watch themes                    (index at themes/.metrics-index)
+ *      ./theme-watch --once themes             (reconcile and exit)
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <csignal>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
+
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cpu_backend.hpp"
+#include "metrics_index.hpp"
+#include "theme_formats.hpp"
+
+#define BATCH_WINDOW_MS 50
+#define DEFAULT_INDEX_NAME ".metrics-index"
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int) { stop_requested = 1; }
+
+// Hidden files (the index itself, editor swap files) are not themes
+static bool is_theme_name(const char* name) {
+    return name[0] != '.' && strstr(name, ".tmp") == nullptr;
+}
+
+struct Job {
+    std::string name;
+    bool present;            // file exists as a regular file
+    bool parsed;             // 16 ANSI slots found
+    int64_t mtime_ns, size;
+    theme_metrics::Palette palette;
+    theme_metrics::Metrics metrics;
+};
+
+struct Counts {
+    int indexed, removed, skipped;
+};
+
+/**
+ * Stat, parse and score every job in parallel, then commit serially.
+ */
+static Counts process(const std::string& dir, std::vector<Job>& jobs, cpu::Pool& pool,
+                      metrics_index::Index& index) {
+    pool.parallel_for((int)jobs.size(), [&](int i) {
+        Job& job = jobs[i];
+        std::string path = dir + "/" + job.name;
+        struct stat st;
+        job.present = stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+        job.parsed = false;
+        if (!job.present) return;
+        job.mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+        job.size = st.st_size;
+        if (theme_formats::load_file(path.c_str(), &job.palette)) {
+            job.metrics = theme_metrics::compute(job.palette);
+            job.parsed = true;
+        }
+    });
+
+    Counts c = {0, 0, 0};
+    for (const Job& job : jobs) {
+        if (job.parsed) {
+            if (index.put(job.name, job.mtime_ns, job.size, job.palette, job.metrics)) {
+                c.indexed++;
+            } else {
+                printf("Warning: %s not indexed (index full or name too long)\n", job.name.c_str());
+                c.skipped++;
+            }
+        } else {
+            // Deleted, or no longer a 16-color theme
+            if (index.find(job.name)) c.removed++;
+            index.remove(job.name);
+            if (job.present) c.skipped++;
+        }
+    }
+    return c;
+}
+
+/**
+ * Jobs for every theme file that is new or changed since its record, and
+ * for every record whose file is gone.
+ */
+static std::vector<Job> reconcile_jobs(const std::string& dir, metrics_index::Index& index) {
+    std::vector<Job> jobs;
+    std::unordered_set<std::string> present;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return jobs;
+    while (struct dirent* e = readdir(d)) {
+        if (!is_theme_name(e->d_name)) continue;
+        std::string path = dir + "/" + e->d_name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+        present.insert(e->d_name);
+
+        int64_t mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+        const metrics_index::Record* r = index.find(e->d_name);
+        if (r && r->state == metrics_index::VALID && r->mtime_ns == mtime_ns && r->size == st.st_size) {
+            continue;
+        }
+        Job job = {};
+        job.name = e->d_name;
+        jobs.push_back(job);
+    }
+    closedir(d);
+
+    index.for_each_valid([&](const std::string& name, const metrics_index::Record&) {
+        if (!present.count(name)) {
+            Job job = {};
+            job.name = name;
+            jobs.push_back(job);
+        }
+    });
+    return jobs;
+}
+
+static void report(const char* what, const Counts& c, uint64_t generation) {
+    printf("%s: %d indexed, %d removed, %d skipped (generation %llu)\n",
+           what, c.indexed, c.removed, c.skipped, (unsigned long long)generation);
+    fflush(stdout);
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options] [DIR]\n", prog);
+    printf("\nWatches DIR (default: themes) and keeps DIR/%s up to date.\n", DEFAULT_INDEX_NAME);
+    printf("\nOptions:\n");
+    printf("  --index FILE    Index file (default: DIR/%s)\n", DEFAULT_INDEX_NAME);
+    printf("  --capacity N    Records of a new index (default: 65536)\n");
+    printf("  --threads N     Scoring threads (default: hardware threads)\n");
+    printf("  --once          Reconcile the directory with the index and exit\n");
+}
+
+int main(int argc, char** argv) {
+    std::string dir = "themes";
+    std::string index_path;
+    int capacity = 65536;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    bool once = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--index") == 0 && i + 1 < argc) {
+            index_path = argv[++i];
+        } else if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+            capacity = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--once") == 0) {
+            once = true;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] != '-') {
+            dir = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (capacity < 1 || threads < 1) {
+        printf("Error: --capacity and --threads must be >= 1\n");
+        return 1;
+    }
+    if (index_path.empty()) {
+        index_path = dir + "/" + DEFAULT_INDEX_NAME;
+    }
+
+    metrics_index::Index index;
+    if (!index.open(index_path.c_str(), capacity)) {
+        return 1;
+    }
+    cpu::Pool pool(threads);
+
+    // Watch before reconciling, so nothing written in between is missed
+    int fd = -1;
+    if (!once) {
+        fd = inotify_init1(IN_CLOEXEC);
+        if (fd < 0 || inotify_add_watch(fd, dir.c_str(),
+                                        IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0) {
+            printf("Error: Could not watch %s: %s\n", dir.c_str(), strerror(errno));
+            return 1;
+        }
+    }
+
+    std::vector<Job> jobs = reconcile_jobs(dir, index);
+    Counts c = process(dir, jobs, pool, index);
+    report("Reconciled", c, index.publish());
+    if (once) {
+        return 0;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    printf("Watching %s (index %s, %d threads)\n", dir.c_str(), index_path.c_str(), pool.size());
+    fflush(stdout);
+
+    alignas(struct inotify_event) char buf[64 * 1024];
+    while (!stop_requested) {
+        // Block for the first event, then gather the rest of the burst
+        std::unordered_set<std::string> changed;
+        bool overflow = false;
+        int timeout = -1;
+        for (;;) {
+            struct pollfd pfd = {fd, POLLIN, 0};
+            int ready = poll(&pfd, 1, timeout);
+            if (ready <= 0) break;
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n <= 0) break;
+            for (char* p = buf; p < buf + n;) {
+                struct inotify_event* ev = (struct inotify_event*)p;
+                if (ev->mask & IN_Q_OVERFLOW) overflow = true;
+                if (ev->len > 0 && is_theme_name(ev->name)) changed.insert(ev->name);
+                p += sizeof(struct inotify_event) + ev->len;
+            }
+            timeout = BATCH_WINDOW_MS;
+        }
+        if (stop_requested) break;
+
+        if (overflow) {
+            jobs = reconcile_jobs(dir, index);
+        } else {
+            jobs.clear();
+            for (const std::string& name : changed) {
+                Job job = {};
+                job.name = name;
+                jobs.push_back(job);
+            }
+        }
+        if (jobs.empty()) continue;
+        c = process(dir, jobs, pool, index);
+        report(overflow ? "Reconciled (queue overflow)" : "Updated", c, index.publish());
+    }
+
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,436 @@
+/**
+ * Theme Formats Module - Readers for other terminals' theme files
+ *
+ * Extracts the 16 ANSI colors of community themes so they can be scored
+ * with the solver's rules (theme_metrics.hpp) next to our own Ghostty files:
+ *
+ *   ghostty      palette = N=#rrggbb
+ *   kitty        colorN #rrggbb
+ *   alacritty    [colors.normal] / [colors.bright] tables (TOML) or the
+ *                colors: normal: / bright: maps of the older YAML files
+ *   wezterm      ansi = [...] and brights = [...] arrays (TOML color schemes)
+ *   xresources   *.colorN: / URxvt*colorN: values, with #define names
+ *   iterm2       .itermcolors plists: "Ansi N Color" dicts of 0-1 components
+ *
+ * Every reader is a single forward pass over the bytes (no NUL terminator,
+ * no copy), so files can be parsed straight from a read-only mapping.
+ * Colors may be #rgb, #rrggbb, 0xrrggbb or rgb:rr/gg/bb.
+ */
+
+#ifndef THEME_FORMATS_HPP
+#define THEME_FORMATS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "theme_metrics.hpp"
+
+namespace theme_formats {
+
+enum Format { GHOSTTY, KITTY, ALACRITTY, WEZTERM, XRESOURCES, ITERM2, FORMAT_COUNT, UNKNOWN = -1 };
+
+constexpr const char* format_names[FORMAT_COUNT] = {
+    "ghostty", "kitty", "alacritty", "wezterm", "xresources", "iterm2"
+};
+
+// ANSI color names in slot order, as alacritty and others spell them
+constexpr const char* ansi_names[8] = {"black", "red", "green", "yellow", "blue", "magenta", "cyan", "white"};
+
+struct Text {
+    const char* p;
+    const char* end;
+
+    bool empty() const { return p >= end; }
+    size_t size() const { return end - p; }
+    bool starts_with(const char* s) const {
+        size_t n = strlen(s);
+        return size() >= n && memcmp(p, s, n) == 0;
+    }
+    bool equals(const char* s) const { return size() == strlen(s) && memcmp(p, s, size()) == 0; }
+    const char* find(const char* s) const {
+        size_t n = strlen(s);
+        for (const char* q = p; q + n <= end; q++) {
+            if (*q == *s && memcmp(q, s, n) == 0) return q;
+        }
+        return nullptr;
+    }
+};
+
+inline bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline Text trim(Text t) {
+    while (t.p < t.end && is_space(*t.p)) t.p++;
+    while (t.end > t.p && is_space(t.end[-1])) t.end--;
+    return t;
+}
+
+// Next line of `rest` (without the newline); advances rest
+inline Text next_line(Text& rest) {
+    const char* nl = (const char*)memchr(rest.p, '\n', rest.size());
+    Text line = {rest.p, nl ? nl : rest.end};
+    rest.p = nl ? nl + 1 : rest.end;
+    return line;
+}
+
+inline int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Parse n hex digits at p
+inline bool hex_value(const char* p, int n, unsigned* out) {
+    unsigned v = 0;
+    for (int i = 0; i < n; i++) {
+        int d = hex_digit(p[i]);
+        if (d < 0) return false;
+        v = v * 16 + d;
+    }
+    *out = v;
+    return true;
+}
+
+/**
+ * Parse the first color literal in t: #rrggbb, #rgb, 0xrrggbb or
+ * rgb:rr/gg/bb (1-4 digits per channel, scaled to 8 bits).
+ */
+inline bool parse_color(Text t, uint8_t* rgb) {
+    for (const char* q = t.p; q < t.end; q++) {
+        size_t left = t.end - q;
+        const char* digits = nullptr;
+        if (*q == '#') {
+            digits = q + 1;
+        } else if (*q == '0' && left > 2 && (q[1] == 'x' || q[1] == 'X')) {
+            digits = q + 2;
+        } else if (left > 4 && memcmp(q, "rgb:", 4) == 0) {
+            const char* c = q + 4;
+            for (int k = 0; k < 3; k++) {
+                const char* start = c;
+                while (c < t.end && hex_digit(*c) >= 0) c++;
+                int n = (int)(c - start);
+                unsigned v;
+                if (n < 1 || n > 4 || !hex_value(start, n, &v)) return false;
+                rgb[k] = (uint8_t)lround(v * 255.0 / ((1u << (4 * n)) - 1));
+                if (k < 2 && (c >= t.end || *c++ != '/')) return false;
+            }
+            return true;
+        }
+        if (!digits) continue;
+
+        int n = 0;
+        while (digits + n < t.end && hex_digit(digits[n]) >= 0) n++;
+        unsigned v;
+        if (n == 6 && hex_value(digits, 6, &v)) {
+            rgb[0] = (v >> 16) & 0xff;
+            rgb[1] = (v >> 8) & 0xff;
+            rgb[2] = v & 0xff;
+            return true;
+        }
+        if (n == 3 && hex_value(digits, 3, &v)) {
+            rgb[0] = ((v >> 8) & 0xf) * 17;
+            rgb[1] = ((v >> 4) & 0xf) * 17;
+            rgb[2] = (v & 0xf) * 17;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Non-negative integer at the start of t, -1 if none
+inline int leading_int(Text t) {
+    int v = -1;
+    for (const char* q = t.p; q < t.end && *q >= '0' && *q <= '9'; q++) {
+        v = (v < 0 ? 0 : v * 10) + (*q - '0');
+        if (v > 255) return -1;
+    }
+    return v;
+}
+
+// Collects slots, reporting success only when all 16 are seen
+struct Collector {
+    theme_metrics::Palette* out;
+    uint16_t seen = 0;
+
+    void set(int slot, Text value) {
+        if (slot < 0 || slot >= 16) return;
+        if (parse_color(value, out->rgb[slot])) seen |= 1u << slot;
+    }
+    bool complete() const { return seen == 0xffff; }
+};
+
+inline bool parse_ghostty(Text rest, theme_metrics::Palette* out) {
+    Collector c = {out};
+    while (!rest.empty()) {
+        Text line = trim(next_line(rest));
+        if (!line.starts_with("palette")) continue;
+        const char* eq = (const char*)memchr(line.p, '=', line.size());
+        if (!eq) continue;
+        Text value = trim({eq + 1, line.end});
+        int slot = leading_int(value);
+        const char* eq2 = (const char*)memchr(value.p, '=', value.size());
+        if (slot >= 0 && eq2) c.set(slot, {eq2 + 1, line.end});
+    }
+    return c.complete();
+}
+
+inline bool parse_kitty(Text rest, theme_metrics::Palette* out) {
+    Collector c = {out};
+    while (!rest.empty()) {
+        Text line = trim(next_line(rest));
+        if (!line.starts_with("color")) continue;
+        int slot = leading_int({line.p + 5, line.end});
+        const char* q = line.p + 5;
+        while (q < line.end && *q >= '0' && *q <= '9') q++;
+        if (q < line.end && is_space(*q)) c.set(slot, {q, line.end});
+    }
+    return c.complete();
+}
+
+// Slot of an ANSI color name key (black .. white), -1 if none
+inline int ansi_index(Text key) {
+    for (int i = 0; i < 8; i++) {
+        if (key.equals(ansi_names[i])) return i;
+    }
+    return -1;
+}
+
+inline bool parse_alacritty(Text rest, theme_metrics::Palette* out) {
+    Collector c = {out};
+    int base = -1;           // 0 inside normal, 8 inside bright
+    int yaml_indent = -1;    // indentation of the YAML normal:/bright: key
+    while (!rest.empty()) {
+        Text raw = next_line(rest);
+        Text line = trim(raw);
+        if (line.empty() || *line.p == '#') continue;
+        int indent = (int)(line.p - raw.p);
+
+        if (*line.p == '[') {
+            // TOML table header
+            base = line.starts_with("[colors.normal]") ? 0 : line.starts_with("[colors.bright]") ? 8 : -1;
+            yaml_indent = -1;
+            continue;
+        }
+        const char* sep = nullptr;
+        for (const char* q = line.p; q < line.end; q++) {
+            if (*q == '=' || *q == ':') {
+                sep = q;
+                break;
+            }
+        }
+        if (!sep) continue;
+        Text key = trim({line.p, sep});
+        Text value = trim({sep + 1, line.end});
+        if (key.size() >= 2 && (*key.p == '"' || *key.p == '\'')) key = {key.p + 1, key.end - 1};
+
+        if (*sep == ':' && value.empty()) {
+            // YAML map key: normal:/bright: open a section, anything at the
+            // same or a lower indentation closes it
+            if (yaml_indent >= 0 && indent <= yaml_indent) base = -1;
+            if (key.equals("normal") || key.equals("bright")) {
+                base = key.equals("normal") ? 0 : 8;
+                yaml_indent = indent;
+            }
+            continue;
+        }
+        if (yaml_indent >= 0 && indent <= yaml_indent) {
+            base = -1;
+            yaml_indent = -1;
+        }
+        int slot = ansi_index(key);
+        if (base >= 0 && slot >= 0) c.set(base + slot, value);
+    }
+    return c.complete();
+}
+
+inline bool parse_wezterm(Text rest, theme_metrics::Palette* out) {
+    Collector c = {out};
+    int base = -1, next = 0;  // array being read and its next element
+    while (!rest.empty()) {
+        Text line = trim(next_line(rest));
+        if (line.empty() || *line.p == '#') continue;
+        if (base < 0) {
+            if (line.starts_with("ansi") || line.starts_with("brights")) {
+                const char* bracket = (const char*)memchr(line.p, '[', line.size());
+                if (!bracket) continue;
+                base = line.starts_with("ansi") ? 0 : 8;
+                next = 0;
+                line.p = bracket + 1;
+            } else {
+                continue;
+            }
+        }
+        // Quoted elements, possibly several per line, until ]
+        const char* q = line.p;
+        while (q < line.end && base >= 0) {
+            if (*q == ']') {
+                base = -1;
+                break;
+            }
+            if (*q == '"' || *q == '\'') {
+                const char* close = (const char*)memchr(q + 1, *q, line.end - q - 1);
+                if (!close) break;
+                if (next < 8) c.set(base + next, {q + 1, close});
+                next++;
+                q = close + 1;
+                continue;
+            }
+            q++;
+        }
+    }
+    return c.complete();
+}
+
+inline bool parse_xresources(Text rest, theme_metrics::Palette* out) {
+    Collector c = {out};
+    std::vector<std::pair<std::string, std::string>> defines;
+    while (!rest.empty()) {
+        Text line = trim(next_line(rest));
+        if (line.empty() || *line.p == '!') continue;
+        if (line.starts_with("#define")) {
+            Text t = trim({line.p + 7, line.end});
+            const char* q = t.p;
+            while (q < t.end && !is_space(*q)) q++;
+            defines.push_back({std::string(t.p, q), std::string(trim({q, t.end}).p, t.end)});
+            continue;
+        }
+        const char* colon = (const char*)memchr(line.p, ':', line.size());
+        if (!colon) continue;
+        Text key = trim({line.p, colon});
+        // Resource name ends in colorN, after *, . or nothing
+        const char* k = key.end;
+        while (k > key.p && k[-1] >= '0' && k[-1] <= '9') k--;
+        if (k - key.p < 5 || memcmp(k - 5, "color", 5) != 0 || k == key.end) continue;
+        if (k - key.p > 5 && k[-6] != '*' && k[-6] != '.') continue;
+        int slot = leading_int({k, key.end});
+
+        Text value = trim({colon + 1, line.end});
+        for (const auto& d : defines) {
+            if (value.size() == d.first.size() && memcmp(value.p, d.first.data(), value.size()) == 0) {
+                value = {d.second.data(), d.second.data() + d.second.size()};
+                break;
+            }
+        }
+        c.set(slot, value);
+    }
+    return c.complete();
+}
+
+// Text of the XML element following `from` (e.g. <real>0.5</real>), empty if none
+inline Text next_element(Text from) {
+    const char* open = (const char*)memchr(from.p, '>', from.size());
+    if (!open) return {from.end, from.end};
+    const char* close = (const char*)memchr(open + 1, '<', from.end - open - 1);
+    return {open + 1, close ? close : from.end};
+}
+
+inline bool parse_iterm2(Text rest, theme_metrics::Palette* out) {
+    Collector c = {out};
+    static const char* components[3] = {"Red Component", "Green Component", "Blue Component"};
+    while (const char* key = rest.find("<key>Ansi ")) {
+        Text after = {key + 10, rest.end};
+        int slot = leading_int(after);
+        const char* dict_end = Text{key, rest.end}.find("</dict>");
+        Text dict = {key, dict_end ? dict_end : rest.end};
+        rest.p = dict.end;
+        if (slot < 0 || slot >= 16) continue;
+
+        double value[3];
+        bool ok = true;
+        for (int k = 0; k < 3 && ok; k++) {
+            const char* name = dict.find(components[k]);
+            if (!name) {
+                ok = false;
+                break;
+            }
+            // <key>Red Component</key><real>0.5</real>
+            const char* key_close = Text{name, dict.end}.find("</key>");
+            Text real = key_close ? trim(next_element({key_close + 6, dict.end})) : Text{dict.end, dict.end};
+            char buf[32];
+            size_t n = std::min(real.size(), sizeof(buf) - 1);
+            memcpy(buf, real.p, n);
+            buf[n] = '\0';
+            char* end;
+            value[k] = strtod(buf, &end);
+            ok = n > 0 && end != buf;
+        }
+        if (!ok) continue;
+        for (int k = 0; k < 3; k++) {
+            out->rgb[slot][k] = (uint8_t)lround(fmin(1.0, fmax(0.0, value[k])) * 255.0);
+        }
+        c.seen |= 1u << slot;
+    }
+    return c.complete();
+}
+
+/**
+ * Guess the format from the file name, then from the content.
+ */
+inline Format detect(const char* path, Text t) {
+    const char* dot = strrchr(path, '.');
+    const char* slash = strrchr(path, '/');
+    if (dot && (!slash || dot > slash)) {
+        if (strcmp(dot, ".itermcolors") == 0) return ITERM2;
+        if (strcmp(dot, ".Xresources") == 0 || strcmp(dot, ".xresources") == 0) return XRESOURCES;
+        if (strcmp(dot, ".yml") == 0 || strcmp(dot, ".yaml") == 0) return ALACRITTY;
+    }
+    if (t.find("<key>Ansi ")) return ITERM2;
+    if (t.find("palette = ") || t.find("palette=")) return GHOSTTY;
+    if (t.find("[colors.normal]") || t.find("normal:")) return ALACRITTY;
+    if (t.find("ansi = [") || t.find("ansi=[") || t.find("brights")) return WEZTERM;
+    if (t.find("color0:") || t.find("color0 :")) return XRESOURCES;
+    if (t.find("color0 ") || t.find("color0\t")) return KITTY;
+    return UNKNOWN;
+}
+
+inline bool parse(Format format, Text t, theme_metrics::Palette* out) {
+    switch (format) {
+        case GHOSTTY: return parse_ghostty(t, out);
+        case KITTY: return parse_kitty(t, out);
+        case ALACRITTY: return parse_alacritty(t, out);
+        case WEZTERM: return parse_wezterm(t, out);
+        case XRESOURCES: return parse_xresources(t, out);
+        case ITERM2: return parse_iterm2(t, out);
+        default: return false;
+    }
+}
+
+/**
+ * Map a theme file read-only, detect its format and read its 16 ANSI
+ * colors. format is set even when parsing fails (UNKNOWN if undetected).
+ */
+inline bool load_file(const char* path, theme_metrics::Palette* out, Format* format = nullptr) {
+    if (format) *format = UNKNOWN;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0 || st.st_size > (64 << 20)) {
+        close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+    madvise(p, st.st_size, MADV_SEQUENTIAL);
+
+    Text t = {(const char*)p, (const char*)p + st.st_size};
+    Format f = detect(path, t);
+    bool ok = parse(f, t, out);
+    munmap(p, st.st_size);
+    if (format) *format = f;
+    return ok;
+}
+
+} // namespace theme_formats
+
+#endif // THEME_FORMATS_HPP
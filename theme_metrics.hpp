@@ -0,0 +1,76 @@
+/**
+ * Theme Metrics Module - Score the 16 ANSI colors of a theme
+ *
+ * Host-side counterpart of the solver's output: computes the numbers the
+ * analyzers and dashboards show for a palette, with the solver's own rule
+ * tables and fitness function (rules.cuh). Theme files of every supported
+ * terminal are read by theme_formats.hpp.
+ */
+
+#ifndef THEME_METRICS_HPP
+#define THEME_METRICS_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "fitness.cuh"
+#include "rules.cuh"
+
+namespace theme_metrics {
+
+struct Palette {
+    uint8_t rgb[16][3];
+};
+
+struct Metrics {
+    double fitness;          // fitness::palette_score with the ANSI rules
+    double worst_margin;     // min over APCA rules of (Lc - min_apca); < 0 = violated
+    int worst_rule;          // index into apca_pair_constraints
+    int rules_met;
+    int rules_total;
+    double min_distance;     // min Oklab distance between base colors 1-7
+    double min_hue_spacing;  // min hue distance between red..cyan (degrees)
+};
+
+inline Metrics compute(const Palette& p) {
+    fitness::SlotColor s[16];
+    for (int i = 0; i < 16; i++) {
+        s[i] = fitness::slot_from_srgb(p.rgb[i][0], p.rgb[i][1], p.rgb[i][2]);
+    }
+
+    Metrics m;
+    m.fitness = fitness::palette_score(s, oklch_slot_constraints, apca_pair_constraints, APCA_CONSTRAINT_COUNT);
+    m.worst_margin = 1e9;
+    m.worst_rule = -1;
+    m.rules_met = 0;
+    m.rules_total = APCA_CONSTRAINT_COUNT;
+    for (int i = 0; i < APCA_CONSTRAINT_COUNT; i++) {
+        const ApcaPairConstraint& r = apca_pair_constraints[i];
+        double margin = fitness::pair_contrast(r, s[r.fg_index].lum, s[r.bg_index].lum) - r.min_apca;
+        if (margin >= 0.0) m.rules_met++;
+        if (margin < m.worst_margin) {
+            m.worst_margin = margin;
+            m.worst_rule = i;
+        }
+    }
+
+    m.min_distance = 1e9;
+    for (int i = RED; i <= WHITE; i++) {
+        for (int j = i + 1; j <= WHITE; j++) {
+            m.min_distance = fmin(m.min_distance, fitness::slot_distance(s[i], s[j]));
+        }
+    }
+    m.min_hue_spacing = 360.0;
+    for (int i = RED; i <= CYAN; i++) {
+        for (int j = i + 1; j <= CYAN; j++) {
+            m.min_hue_spacing = fmin(m.min_hue_spacing, color::hue_distance(s[i].H, s[j].H));
+        }
+    }
+    return m;
+}
+
+} // namespace theme_metrics
+
+#endif // THEME_METRICS_HPP
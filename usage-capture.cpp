@@ -0,0 +1,227 @@
+/**
+ * Usage Capture - Time-weighted (fg, bg) cell usage of a terminal session
+ *
+ * Runs a command under a pty of a fixed size and passes the session through
+ * to the real terminal (keys in, output out). The output stream is also fed
+ * incrementally to a small VT state machine (vt_screen.hpp) that keeps the
+ * screen's cell colors. Between two reads the screen is what the user saw,
+ * so each interval adds (glyph cells per pair) x seconds to the histogram
+ * (usage.hpp), which the solver loads with --usage.
+ *
+ * Build: g++ -std=c++17 -O2 usage-capture.cpp -o hexa-usage-capture -lutil
+ * Run: ./hexa-usage-capture -o mc.usage -- mc
+ *      ./hexa-usage-capture --append -o all.usage --duration 60 -- htop
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <poll.h>
+#include <pty.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "usage.hpp"
+#include "vt_screen.hpp"
+
+static struct termios saved_termios;
+static bool raw_mode = false;
+
+static void restore_terminal() {
+    if (raw_mode) tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_termios);
+    raw_mode = false;
+}
+
+static double now_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const char* slot_label(int i) {
+    static const char* names[usage::SLOTS + 1] = {
+        "black", "red", "green", "yellow", "blue", "magenta", "cyan", "white",
+        "br.black", "br.red", "br.green", "br.yellow", "br.blue", "br.magenta", "br.cyan", "br.white", "other"
+    };
+    return names[i];
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options] -- COMMAND [ARGS...]\n", prog);
+    printf("\nRuns COMMAND under a pty and records time-weighted (fg, bg) cell usage.\n");
+    printf("\nOptions:\n");
+    printf("  -o, --output FILE  Histogram file (default: usage.hist)\n");
+    printf("  --append           Add to an existing histogram instead of replacing it\n");
+    printf("  -w, --width N      Terminal width (default: current terminal or 80)\n");
+    printf("  -h, --height N     Terminal height (default: current terminal or 24)\n");
+    printf("  --duration S       Stop the command after S seconds\n");
+    printf("  --bold-bright      Count bold text in colors 0-7 as the bright slot\n");
+    printf("  --quiet            Do not pass the command's output through\n");
+}
+
+int main(int argc, char** argv) {
+    const char* output = "usage.hist";
+    bool append = false, bold_bright = false, quiet = false;
+    int width = 0, height = 0;
+    double duration = 0.0;
+    int command = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--output") == 0 || strcmp(argv[i], "-o") == 0) && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--append") == 0) {
+            append = true;
+        } else if ((strcmp(argv[i], "--width") == 0 || strcmp(argv[i], "-w") == 0) && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--height") == 0 || strcmp(argv[i], "-h") == 0) && i + 1 < argc) {
+            height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--bold-bright") == 0) {
+            bold_bright = true;
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--") == 0 && i + 1 < argc) {
+            command = i + 1;
+            break;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (command < 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    struct winsize ws = {};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0 || ws.ws_col == 0) {
+        ws.ws_col = 80;
+        ws.ws_row = 24;
+    }
+    if (width > 0) ws.ws_col = width;
+    if (height > 0) ws.ws_row = height;
+    if (ws.ws_col < 1 || ws.ws_row < 1 || duration < 0.0) {
+        printf("Error: --width and --height must be >= 1, --duration >= 0\n");
+        return 1;
+    }
+
+    usage::Histogram hist;
+    if (append && access(output, F_OK) == 0 && !usage::load(output, &hist)) {
+        return 1;
+    }
+
+    bool interactive = isatty(STDIN_FILENO);
+    int master;
+    pid_t child = forkpty(&master, nullptr, nullptr, &ws);
+    if (child < 0) {
+        printf("Error: forkpty failed: %s\n", strerror(errno));
+        return 1;
+    }
+    if (child == 0) {
+        execvp(argv[command], argv + command);
+        fprintf(stderr, "Error: Could not run %s: %s\n", argv[command], strerror(errno));
+        _exit(127);
+    }
+
+    if (interactive && tcgetattr(STDIN_FILENO, &saved_termios) == 0) {
+        struct termios raw = saved_termios;
+        cfmakeraw(&raw);
+        raw_mode = tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) == 0;
+        atexit(restore_terminal);
+    }
+
+    vt_screen::Screen screen(ws.ws_col, ws.ws_row, bold_bright);
+    usage::Histogram session;
+    double start = now_seconds(), last = start;
+    bool stdin_open = true;
+    char buf[65536];
+
+    // Each read: the screen before it was on display since the previous one
+    auto accumulate = [&](double t) {
+        double dt = t - last;
+        const auto& counts = screen.counts();
+        for (int fg = 0; fg <= usage::SLOTS; fg++) {
+            for (int bg = 0; bg <= usage::SLOTS; bg++) session.cell_seconds[fg][bg] += counts[fg][bg] * dt;
+        }
+        last = t;
+    };
+
+    for (;;) {
+        struct pollfd fds[2] = {{master, POLLIN, 0}, {STDIN_FILENO, POLLIN, 0}};
+        int timeout = -1;
+        if (duration > 0.0) {
+            double left = start + duration - now_seconds();
+            if (left <= 0.0) {
+                kill(child, SIGHUP);
+                break;
+            }
+            timeout = (int)(left * 1000.0) + 1;
+        }
+        int ready = poll(fds, stdin_open ? 2 : 1, timeout);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready < 0) break;
+
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t n = read(master, buf, sizeof(buf));
+            if (n <= 0) break;  // EIO once the command has exited
+            accumulate(now_seconds());
+            screen.feed(buf, n);
+            if (!quiet && write(STDOUT_FILENO, buf, n) < 0) quiet = true;
+        }
+        if (stdin_open && (fds[1].revents & (POLLIN | POLLHUP))) {
+            ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+            if (n <= 0) {
+                stdin_open = false;
+            } else if (write(master, buf, n) < 0) {
+                break;
+            }
+        }
+    }
+    accumulate(now_seconds());
+    session.seconds = last - start;
+    close(master);
+    int status = 0;
+    waitpid(child, &status, 0);
+    restore_terminal();
+
+    hist.merge(session);
+    std::string comment;
+    for (int i = command; i < argc; i++) comment += std::string(i > command ? " " : "") + argv[i];
+    comment += " (" + std::to_string(ws.ws_col) + "x" + std::to_string(ws.ws_row) + ")";
+    if (!usage::save(output, hist, comment.c_str())) {
+        fprintf(stderr, "Error: Could not write %s\n", output);
+        return 1;
+    }
+
+    // Summary on stderr, after the session's own output
+    struct Pair {
+        int fg, bg;
+        double value;
+    };
+    std::vector<Pair> pairs;
+    double total = session.total();
+    for (int fg = 0; fg <= usage::SLOTS; fg++) {
+        for (int bg = 0; bg <= usage::SLOTS; bg++) {
+            if (session.cell_seconds[fg][bg] > 0.0) pairs.push_back({fg, bg, session.cell_seconds[fg][bg]});
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) { return a.value > b.value; });
+    fprintf(stderr, "\nCaptured %.1fs, %.0f cell-seconds in %zu pairs%s -> %s\n", session.seconds, total,
+            pairs.size(), append ? " (appended)" : "", output);
+    for (size_t k = 0; k < pairs.size() && k < 10; k++) {
+        fprintf(stderr, "  %-10s on %-10s %5.1f%%\n", slot_label(pairs[k].fg), slot_label(pairs[k].bg),
+                100.0 * pairs[k].value / total);
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
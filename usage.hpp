@@ -0,0 +1,117 @@
+/**
+ * Usage Module - Time-weighted (fg, bg) cell histogram of real sessions
+ *
+ * hexa-usage-capture accumulates, over a whole pty session, how many
+ * cell-seconds each foreground/background pair of the 16 ANSI slots was on
+ * screen. The solver loads the histogram as pair weights (--usage), so the
+ * pairs applications actually draw get the contrast.
+ *
+ * File format (text, mergeable by adding weights):
+ *   # comment
+ *   seconds = 42.5
+ *   pair = FG BG CELL_SECONDS      FG/BG: slot 0-15, or -1 for colors outside
+ *                                  the 16 slots (256-color cube, truecolor)
+ */
+
+#ifndef USAGE_HPP
+#define USAGE_HPP
+
+#include <cstdio>
+#include <cstring>
+
+namespace usage {
+
+constexpr int SLOTS = 16;
+constexpr int OTHER = SLOTS;  // index of colors outside the ANSI slots
+
+struct Histogram {
+    double seconds = 0.0;                         // session time covered
+    double cell_seconds[SLOTS + 1][SLOTS + 1] = {};  // [fg][bg]
+
+    void merge(const Histogram& h) {
+        seconds += h.seconds;
+        for (int fg = 0; fg <= SLOTS; fg++) {
+            for (int bg = 0; bg <= SLOTS; bg++) cell_seconds[fg][bg] += h.cell_seconds[fg][bg];
+        }
+    }
+
+    double total() const {
+        double sum = 0.0;
+        for (int fg = 0; fg <= SLOTS; fg++) {
+            for (int bg = 0; bg <= SLOTS; bg++) sum += cell_seconds[fg][bg];
+        }
+        return sum;
+    }
+};
+
+inline bool load(const char* path, Histogram* out) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("Error: Could not open usage histogram %s\n", path);
+        return false;
+    }
+    Histogram h;
+    char line[256];
+    int line_no = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        const char* p = line + strspn(line, " \t");
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+        int fg, bg;
+        double value;
+        if (sscanf(p, "seconds = %lf", &value) == 1) {
+            h.seconds = value;
+        } else if (sscanf(p, "pair = %d %d %lf", &fg, &bg, &value) == 3 && fg >= -1 && fg < SLOTS &&
+                   bg >= -1 && bg < SLOTS && value >= 0.0) {
+            h.cell_seconds[fg < 0 ? OTHER : fg][bg < 0 ? OTHER : bg] += value;
+        } else {
+            printf("Error: %s:%d: expected 'seconds = S' or 'pair = FG BG CELL_SECONDS'\n", path, line_no);
+            ok = false;
+            break;
+        }
+    }
+    fclose(f);
+    if (ok) *out = h;
+    return ok;
+}
+
+inline bool save(const char* path, const Histogram& h, const char* comment) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "# Cell usage histogram: %s\n", comment);
+    fprintf(f, "seconds = %.3f\n", h.seconds);
+    for (int fg = 0; fg <= SLOTS; fg++) {
+        for (int bg = 0; bg <= SLOTS; bg++) {
+            if (h.cell_seconds[fg][bg] <= 0.0) continue;
+            fprintf(f, "pair = %d %d %.3f\n", fg == OTHER ? -1 : fg, bg == OTHER ? -1 : bg, h.cell_seconds[fg][bg]);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+/**
+ * Pair weights for the solver: weights[fg * 16 + bg] is the share of the
+ * cell-seconds between two distinct ANSI slots (sums to 1). Pairs with
+ * colors outside the slots, and fg == bg (invisible text), are dropped.
+ * Returns the number of weighted pairs.
+ */
+inline int pair_weights(const Histogram& h, double* weights) {
+    double sum = 0.0;
+    for (int fg = 0; fg < SLOTS; fg++) {
+        for (int bg = 0; bg < SLOTS; bg++) {
+            weights[fg * SLOTS + bg] = fg == bg ? 0.0 : h.cell_seconds[fg][bg];
+            sum += weights[fg * SLOTS + bg];
+        }
+    }
+    int n = 0;
+    for (int i = 0; i < SLOTS * SLOTS; i++) {
+        weights[i] = sum > 0.0 ? weights[i] / sum : 0.0;
+        n += weights[i] > 0.0;
+    }
+    return n;
+}
+
+} // namespace usage
+
+#endif // USAGE_HPP
@@ -0,0 +1,380 @@
+/**
+ * VT Screen Module - Cell colors of a terminal screen, fed its output stream
+ *
+ * A small VT state machine for hexa-usage-capture: it keeps the colors of
+ * every cell (SGR colors, reverse video, cursor movement, erase,
+ * insert/delete, scroll regions, alternate screen) but not the characters,
+ * and counts the glyph cells per (fg, bg) pair as the screen changes.
+ * Blank cells (never written, erased, or written with a space) do not
+ * count: the background of blank space does not need contrast. Default
+ * colors map to the theme's foreground (slot 7) and background (slot 0).
+ */
+
+#ifndef VT_SCREEN_HPP
+#define VT_SCREEN_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#include "usage.hpp"
+
+namespace vt_screen {
+
+constexpr uint8_t DEFAULT_FG = 7;
+constexpr uint8_t DEFAULT_BG = 0;
+constexpr int MAX_PARAMS = 32;
+
+/**
+ * Screen model: cell colors only (no characters), with the number of glyph
+ * cells per (fg, bg) pair kept current on every change.
+ */
+class Screen {
+public:
+    struct Cell {
+        uint8_t fg, bg;
+        bool glyph;
+    };
+
+    Screen(int width, int height, bool bold_bright)
+        : w_(width), h_(height), bold_bright_(bold_bright), cells_((size_t)width * height), alt_(cells_) {
+        reset_attributes();
+        bottom_ = h_ - 1;
+        for (Cell& c : cells_) c = {DEFAULT_FG, DEFAULT_BG, false};
+    }
+
+    // Glyph cells currently on screen per [fg][bg]
+    const double (&counts() const)[usage::SLOTS + 1][usage::SLOTS + 1] { return counts_; }
+
+    void feed(const char* data, size_t n) {
+        for (size_t i = 0; i < n; i++) step((unsigned char)data[i]);
+    }
+
+private:
+    enum State { GROUND, ESCAPE, CSI, STRING, STRING_ESCAPE, CHARSET };
+
+    void step(unsigned char c) {
+        switch (state_) {
+            case GROUND:
+                if (c == 0x1b) {
+                    state_ = ESCAPE;
+                } else if (c < 0x20 || c == 0x7f) {
+                    control(c);
+                } else if ((c & 0xc0) != 0x80) {
+                    print(c);  // UTF-8 continuation bytes belong to the same cell
+                }
+                break;
+            case ESCAPE:
+                state_ = GROUND;
+                if (c == '[') {
+                    state_ = CSI;
+                    n_params_ = 0;
+                    param_ = -1;
+                    private_ = false;
+                } else if (c == ']' || c == 'P' || c == '_' || c == '^' || c == 'X') {
+                    state_ = STRING;  // OSC, DCS, APC, PM, SOS: skipped
+                } else if (c == '(' || c == ')' || c == '*' || c == '+' || c == '#' || c == '%') {
+                    state_ = CHARSET;
+                } else if (c == '7') {
+                    save_cursor();
+                } else if (c == '8') {
+                    restore_cursor();
+                } else if (c == 'D') {
+                    line_feed();
+                } else if (c == 'E') {
+                    x_ = 0;
+                    line_feed();
+                } else if (c == 'M') {
+                    reverse_index();
+                } else if (c == 'c') {
+                    full_reset();
+                }
+                break;
+            case CSI:
+                if (c >= '0' && c <= '9') {
+                    param_ = (param_ < 0 ? 0 : param_ * 10) + (c - '0');
+                    if (param_ > 65535) param_ = 65535;
+                } else if (c == ';' || c == ':') {
+                    push_param();
+                } else if (c == '?' || c == '>' || c == '<' || c == '=') {
+                    private_ = true;
+                } else if (c >= 0x40 && c <= 0x7e) {
+                    push_param();
+                    csi(c);
+                    state_ = GROUND;
+                } else if (c == 0x1b) {
+                    state_ = ESCAPE;
+                } else if (c < 0x20) {
+                    control(c);
+                }
+                break;
+            case STRING:
+                if (c == 0x07) state_ = GROUND;
+                if (c == 0x1b) state_ = STRING_ESCAPE;
+                break;
+            case STRING_ESCAPE:
+                state_ = c == '\\' ? GROUND : STRING;
+                break;
+            case CHARSET:
+                state_ = GROUND;
+                break;
+        }
+    }
+
+    void push_param() {
+        if (n_params_ < MAX_PARAMS) params_[n_params_++] = param_;
+        param_ = -1;
+    }
+
+    int param(int i, int fallback) const {
+        return i < n_params_ && params_[i] > 0 ? params_[i] : fallback;
+    }
+
+    void control(unsigned char c) {
+        switch (c) {
+            case '\r': x_ = 0; pending_wrap_ = false; break;
+            case '\n': case 0x0b: case 0x0c: line_feed(); break;
+            case '\b': if (x_ > 0) x_--; pending_wrap_ = false; break;
+            case '\t': x_ = std::min(w_ - 1, (x_ / 8 + 1) * 8); break;
+            default: break;
+        }
+    }
+
+    Cell& at(int x, int y) { return cells_[(size_t)y * w_ + x]; }
+
+    void set(int x, int y, Cell c) {
+        Cell& old = at(x, y);
+        if (old.glyph) counts_[old.fg][old.bg] -= 1.0;
+        old = c;
+        if (c.glyph) counts_[c.fg][c.bg] += 1.0;
+    }
+
+    Cell blank() const { return {fg_eff(), bg_eff(), false}; }
+
+    uint8_t fg_eff() const { return reverse_ ? bg_ : fg_; }
+    uint8_t bg_eff() const { return reverse_ ? fg_ : bg_; }
+
+    // A space written with colors still shows only its background: a blank cell
+    void print(unsigned char c) {
+        if (pending_wrap_) {
+            x_ = 0;
+            line_feed();
+            pending_wrap_ = false;
+        }
+        uint8_t fg = fg_;
+        if (bold_bright_ && bold_ && fg < 8) fg += 8;
+        set(x_, y_, {reverse_ ? bg_ : fg, reverse_ ? fg : bg_, c != ' '});
+        if (x_ == w_ - 1) {
+            pending_wrap_ = true;
+        } else {
+            x_++;
+        }
+    }
+
+    void line_feed() {
+        pending_wrap_ = false;
+        if (y_ == bottom_) {
+            scroll_up(top_, bottom_, 1);
+        } else if (y_ < h_ - 1) {
+            y_++;
+        }
+    }
+
+    void reverse_index() {
+        if (y_ == top_) {
+            scroll_down(top_, bottom_, 1);
+        } else if (y_ > 0) {
+            y_--;
+        }
+    }
+
+    // Move lines [top, bottom] up by n, blank lines entering at the bottom
+    void scroll_up(int top, int bottom, int n) {
+        n = std::min(n, bottom - top + 1);
+        for (int y = top; y <= bottom; y++) {
+            for (int x = 0; x < w_; x++) set(x, y, y + n <= bottom ? at(x, y + n) : blank());
+        }
+    }
+
+    void scroll_down(int top, int bottom, int n) {
+        n = std::min(n, bottom - top + 1);
+        for (int y = bottom; y >= top; y--) {
+            for (int x = 0; x < w_; x++) set(x, y, y - n >= top ? at(x, y - n) : blank());
+        }
+    }
+
+    void erase(int x0, int y0, int x1, int y1) {  // inclusive, row-major span
+        for (int y = y0; y <= y1; y++) {
+            int from = y == y0 ? x0 : 0, to = y == y1 ? x1 : w_ - 1;
+            for (int x = from; x <= to; x++) set(x, y, blank());
+        }
+    }
+
+    void csi(unsigned char final) {
+        pending_wrap_ = pending_wrap_ && final == 'm';
+        if (private_) {
+            if ((final == 'h' || final == 'l') && n_params_ > 0) {
+                int mode = params_[0];
+                if (mode == 1049 || mode == 1047 || mode == 47) alternate_screen(final == 'h', mode == 1049);
+            }
+            return;
+        }
+        int n = param(0, 1);
+        switch (final) {
+            case 'm': sgr(); break;
+            case 'A': y_ = std::max(top_of_cursor(), y_ - n); break;
+            case 'B': case 'e': y_ = std::min(bottom_of_cursor(), y_ + n); break;
+            case 'C': case 'a': x_ = std::min(w_ - 1, x_ + n); break;
+            case 'D': x_ = std::max(0, x_ - n); break;
+            case 'E': x_ = 0; y_ = std::min(bottom_of_cursor(), y_ + n); break;
+            case 'F': x_ = 0; y_ = std::max(top_of_cursor(), y_ - n); break;
+            case 'G': case '`': x_ = std::min(w_ - 1, n - 1); break;
+            case 'd': y_ = std::min(h_ - 1, n - 1); break;
+            case 'H': case 'f':
+                y_ = std::min(h_ - 1, param(0, 1) - 1);
+                x_ = std::min(w_ - 1, param(1, 1) - 1);
+                break;
+            case 'J': {
+                int mode = n_params_ > 0 && params_[0] > 0 ? params_[0] : 0;
+                if (mode == 0) erase(x_, y_, w_ - 1, h_ - 1);
+                if (mode == 1) erase(0, 0, x_, y_);
+                if (mode == 2 || mode == 3) erase(0, 0, w_ - 1, h_ - 1);
+                break;
+            }
+            case 'K': {
+                int mode = n_params_ > 0 && params_[0] > 0 ? params_[0] : 0;
+                erase(mode == 0 ? x_ : 0, y_, mode == 1 ? x_ : w_ - 1, y_);
+                break;
+            }
+            case 'X': erase(x_, y_, std::min(w_ - 1, x_ + n - 1), y_); break;
+            case 'P':
+                for (int x = x_; x < w_; x++) set(x, y_, x + n < w_ ? at(x + n, y_) : blank());
+                break;
+            case '@':
+                for (int x = w_ - 1; x >= x_; x--) set(x, y_, x - n >= x_ ? at(x - n, y_) : blank());
+                break;
+            case 'L': if (y_ >= top_ && y_ <= bottom_) scroll_down(y_, bottom_, n); break;
+            case 'M': if (y_ >= top_ && y_ <= bottom_) scroll_up(y_, bottom_, n); break;
+            case 'S': scroll_up(top_, bottom_, n); break;
+            case 'T': scroll_down(top_, bottom_, n); break;
+            case 'r':
+                top_ = std::min(h_ - 1, param(0, 1) - 1);
+                bottom_ = std::min(h_ - 1, param(1, h_) - 1);
+                if (top_ >= bottom_) {
+                    top_ = 0;
+                    bottom_ = h_ - 1;
+                }
+                x_ = y_ = 0;
+                break;
+            case 's': save_cursor(); break;
+            case 'u': restore_cursor(); break;
+            default: break;
+        }
+    }
+
+    int top_of_cursor() const { return y_ >= top_ ? top_ : 0; }
+    int bottom_of_cursor() const { return y_ <= bottom_ ? bottom_ : h_ - 1; }
+
+    // Color of an extended 38/48 sequence starting at params_[i]; advances i
+    uint8_t extended_color(int& i) {
+        if (i + 1 < n_params_ && params_[i + 1] == 5 && i + 2 < n_params_) {
+            int index = params_[i + 2];
+            i += 2;
+            return index >= 0 && index < usage::SLOTS ? (uint8_t)index : usage::OTHER;
+        }
+        if (i + 1 < n_params_ && params_[i + 1] == 2) {
+            i += std::min(4, n_params_ - 1 - i);
+        }
+        return usage::OTHER;
+    }
+
+    void sgr() {
+        if (n_params_ == 0) {
+            reset_attributes();
+            return;
+        }
+        for (int i = 0; i < n_params_; i++) {
+            int p = params_[i] < 0 ? 0 : params_[i];
+            if (p == 0) reset_attributes();
+            else if (p == 1) bold_ = true;
+            else if (p == 22) bold_ = false;
+            else if (p == 7) reverse_ = true;
+            else if (p == 27) reverse_ = false;
+            else if (p >= 30 && p <= 37) fg_ = p - 30;
+            else if (p == 38) fg_ = extended_color(i);
+            else if (p == 39) fg_ = DEFAULT_FG;
+            else if (p >= 40 && p <= 47) bg_ = p - 40;
+            else if (p == 48) bg_ = extended_color(i);
+            else if (p == 49) bg_ = DEFAULT_BG;
+            else if (p >= 90 && p <= 97) fg_ = p - 90 + 8;
+            else if (p >= 100 && p <= 107) bg_ = p - 100 + 8;
+        }
+    }
+
+    void reset_attributes() {
+        fg_ = DEFAULT_FG;
+        bg_ = DEFAULT_BG;
+        bold_ = reverse_ = false;
+    }
+
+    void save_cursor() {
+        saved_x_ = x_;
+        saved_y_ = y_;
+    }
+
+    void restore_cursor() {
+        x_ = std::min(saved_x_, w_ - 1);
+        y_ = std::min(saved_y_, h_ - 1);
+        pending_wrap_ = false;
+    }
+
+    void alternate_screen(bool enter, bool cursor) {
+        if (enter == in_alt_) return;
+        if (cursor && enter) save_cursor();
+        std::swap(cells_, alt_);
+        in_alt_ = enter;
+        if (enter) {
+            for (Cell& c : cells_) c = {DEFAULT_FG, DEFAULT_BG, false};
+        }
+        recount();
+        if (cursor && !enter) restore_cursor();
+    }
+
+    void full_reset() {
+        reset_attributes();
+        for (Cell& c : cells_) c = {DEFAULT_FG, DEFAULT_BG, false};
+        x_ = y_ = 0;
+        top_ = 0;
+        bottom_ = h_ - 1;
+        recount();
+    }
+
+    void recount() {
+        memset(counts_, 0, sizeof(counts_));
+        for (const Cell& c : cells_) {
+            if (c.glyph) counts_[c.fg][c.bg] += 1.0;
+        }
+    }
+
+    int w_, h_;
+    bool bold_bright_;
+    std::vector<Cell> cells_, alt_;
+    bool in_alt_ = false;
+    double counts_[usage::SLOTS + 1][usage::SLOTS + 1] = {};
+
+    int x_ = 0, y_ = 0, saved_x_ = 0, saved_y_ = 0;
+    int top_ = 0, bottom_ = 0;
+    bool pending_wrap_ = false;
+    uint8_t fg_, bg_;
+    bool bold_, reverse_;
+
+    State state_ = GROUND;
+    int params_[MAX_PARAMS];
+    int n_params_ = 0, param_ = -1;
+    bool private_ = false;
+};
+
+} // namespace vt_screen
+
+#endif // VT_SCREEN_HPP
@@ -0,0 +1,207 @@
+/**
+ * Xterm-256 Module - Extended palette layout and scoring
+ *
+ * Slots 16-231 are a 6x6x6 color cube and slots 232-255 a 24-step grey ramp.
+ * In 256-color mode the solver keeps the standard xterm layout but lets each
+ * extended slot move inside an OKLCH box around its standard color, so that:
+ * - steps along every cube axis are perceptually even (Oklab distance)
+ * - the grey ramp rises in lightness with even steps
+ * - contrast against the ANSI background/foreground slots is kept
+ *
+ * Contrast rules are a sparse pair list built from the standard palette, so
+ * evaluation is O(pairs) on the per-slot prepared luminances rather than a
+ * dense 256x256 scan.
+ */
+
+#ifndef XTERM_CUH
+#define XTERM_CUH
+
+#include <vector>
+
+#include "fitness.cuh"
+
+namespace xterm {
+
+constexpr int SLOTS = 256;
+constexpr int CUBE_BASE = 16;
+constexpr int CUBE_SIDE = 6;
+constexpr int GREY_BASE = 232;
+constexpr int GREY_STEPS = 24;
+
+// Channel levels of the standard xterm cube
+COLOR_FUNC inline double cube_level(int i) {
+    return i == 0 ? 0.0 : 55.0 + 40.0 * i;
+}
+
+COLOR_FUNC inline int cube_slot(int r, int g, int b) {
+    return CUBE_BASE + r * CUBE_SIDE * CUBE_SIDE + g * CUBE_SIDE + b;
+}
+
+/**
+ * Standard xterm sRGB color (0-255) of an extended slot (16-255).
+ */
+COLOR_FUNC inline void standard_color(int slot, double* r, double* g, double* b) {
+    if (slot >= GREY_BASE) {
+        double v = 8.0 + 10.0 * (slot - GREY_BASE);
+        *r = *g = *b = v;
+        return;
+    }
+    int i = slot - CUBE_BASE;
+    *r = cube_level(i / (CUBE_SIDE * CUBE_SIDE));
+    *g = cube_level((i / CUBE_SIDE) % CUBE_SIDE);
+    *b = cube_level(i % CUBE_SIDE);
+}
+
+// =============================================================================
+// Extended fitness terms
+// =============================================================================
+
+/**
+ * Contrast rule on an extended slot: penalty only, so hundreds of satisfied
+ * rules do not outweigh the ANSI terms.
+ */
+COLOR_FUNC inline double extended_pair_score(const ApcaPairConstraint& p, double apca) {
+    return apca >= p.min_apca ? 0.0 : -(p.min_apca - apca) * 50.0;
+}
+
+/**
+ * Even Oklab steps along every line of the cube (3 axes x 36 lines x 5 steps).
+ */
+COLOR_FUNC inline double cube_uniformity_score(const fitness::SlotColor* s) {
+    double score = 0.0;
+    for (int axis = 0; axis < 3; axis++) {
+        for (int u = 0; u < CUBE_SIDE; u++) {
+            for (int v = 0; v < CUBE_SIDE; v++) {
+                double steps[CUBE_SIDE - 1];
+                double mean = 0.0;
+                for (int k = 0; k < CUBE_SIDE - 1; k++) {
+                    int a, b;
+                    if (axis == 0) { a = cube_slot(k, u, v); b = cube_slot(k + 1, u, v); }
+                    else if (axis == 1) { a = cube_slot(u, k, v); b = cube_slot(u, k + 1, v); }
+                    else { a = cube_slot(u, v, k); b = cube_slot(u, v, k + 1); }
+                    steps[k] = fitness::slot_distance(s[a], s[b]);
+                    mean += steps[k];
+                }
+                mean /= CUBE_SIDE - 1;
+                for (int k = 0; k < CUBE_SIDE - 1; k++) {
+                    score -= fabs(steps[k] - mean) * 100.0;
+                }
+            }
+        }
+    }
+    return score;
+}
+
+/**
+ * Grey ramp: strictly increasing lightness with even steps.
+ */
+COLOR_FUNC inline double grey_ramp_score(const fitness::SlotColor* s) {
+    double first = s[GREY_BASE].lab.L;
+    double last = s[GREY_BASE + GREY_STEPS - 1].lab.L;
+    double step = (last - first) / (GREY_STEPS - 1);
+
+    double score = 0.0;
+    for (int i = GREY_BASE; i < GREY_BASE + GREY_STEPS - 1; i++) {
+        double dL = s[i + 1].lab.L - s[i].lab.L;
+        if (dL <= 0.0) {
+            score -= (0.01 - dL) * 1000.0;  // Ramp must not turn back
+        }
+        score -= fabs(dL - step) * 200.0;
+    }
+    return score;
+}
+
+/**
+ * Terms of the extended slots (16..SLOTS-1). The ANSI slots are scored by
+ * fitness::palette_score() as usual.
+ */
+COLOR_FUNC inline double extended_terms(const fitness::SlotColor* s,
+                                        const ApcaPairConstraint* pairs, int pair_count) {
+    double score = 0.0;
+
+    for (int i = CUBE_BASE; i < SLOTS; i++) {
+        score += fitness::gamut_score(s[i].in_gamut);
+    }
+
+    // Sparse contrast rules against the ANSI slots
+    for (int i = 0; i < pair_count; i++) {
+        const ApcaPairConstraint& p = pairs[i];
+        double apca = fitness::pair_contrast(p, s[p.fg_index].lum, s[p.bg_index].lum);
+        score += extended_pair_score(p, apca);
+    }
+
+    score += cube_uniformity_score(s);
+    score += grey_ramp_score(s);
+    return score;
+}
+
+// =============================================================================
+// Host-side table construction
+// =============================================================================
+
+/**
+ * Fill slot constraints 16..255: an OKLCH box around each standard color.
+ * Cube corners black and white stay fixed.
+ */
+inline void build_slot_constraints(OklchSlotConstraint* slots) {
+    for (int i = CUBE_BASE; i < SLOTS; i++) {
+        double r, g, b;
+        standard_color(i, &r, &g, &b);
+        double L, C, H;
+        color::rgb_to_oklch(r, g, b, &L, &C, &H);
+
+        OklchSlotConstraint& c = slots[i];
+        c = OklchSlotConstraint{};
+        c.base_slot = -1;
+        bool corner = (i == cube_slot(0, 0, 0) || i == cube_slot(5, 5, 5));
+        if (corner) {
+            c.fixed = true;
+            c.fixed_r = r;
+            c.fixed_g = g;
+            c.fixed_b = b;
+            continue;
+        }
+
+        c.min_L = fmax(0.0, L - 0.05);
+        c.max_L = fmin(1.0, L + 0.05);
+        if (i >= GREY_BASE) {
+            // Neutral greys: chroma pinned at zero
+            c.target_hue = 0.0;
+            c.hue_tolerance = 0.0;
+        } else {
+            c.target_hue = H;
+            c.hue_tolerance = C < 0.03 ? 180.0 : 10.0;
+            c.min_C = fmax(0.0, C - 0.03);
+            c.max_C = C + 0.03;
+        }
+    }
+}
+
+/**
+ * Contrast rules for the extended slots, from the standard palette:
+ * - readable on black stays readable (slot on BLACK)
+ * - dark cells keep white text readable (BR_WHITE on slot)
+ * Rules whose standard contrast is below 30 Lc are not generated.
+ */
+inline std::vector<ApcaPairConstraint> build_pair_constraints(const OklchSlotConstraint* slots) {
+    std::vector<ApcaPairConstraint> pairs;
+    for (int i = CUBE_BASE; i < SLOTS; i++) {
+        if (slots[i].fixed) continue;
+        double r, g, b;
+        standard_color(i, &r, &g, &b);
+
+        double on_black = color::apca::contrast_abs(r, g, b, 0, 0, 0);
+        if (on_black >= 30.0) {
+            pairs.push_back({(int16_t)i, BLACK, fmin(on_black, 75.0) - 5.0, 0.0, POLARITY_ANY});
+        }
+        double white_on = color::apca::contrast_abs(255, 255, 255, r, g, b);
+        if (white_on >= 30.0) {
+            pairs.push_back({BR_WHITE, (int16_t)i, fmin(white_on, 90.0) - 5.0, 0.0, POLARITY_ANY});
+        }
+    }
+    return pairs;
+}
+
+} // namespace xterm
+
+#endif // XTERM_CUH